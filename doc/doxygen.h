@@ -153,6 +153,12 @@
  *
  * CTF_PPN tells CTF how many processes per node you are using. The default is 1.
  *
+ * CTF_OUT_OF_CORE=1 makes CTF perform a dense nonsymmetric contraction for which no mapping fits in the memory limit as a sequence of smaller contractions, each on slabs of the operands along one index, instead of failing. The slabs are made as wide as the memory limit allows, the redistribution of the next slab is overlapped with the contraction of the current one, and a slab that still does not fit is split further along another index. The operands themselves must fit in memory.
+ *
+ * CTF_MODEL_FILE names a file from which the coefficients of the performance models used to select algorithms are read at startup.
+ *
+ * CTF_LEARN_MODELS=k makes CTF refit its performance models during execution from every k-th measured kernel and collective on all processes (the sums are exchanged with a non-blocking allreduce every 64 contractions and summations on the global world). If CTF_MODEL_FILE is also set, the learned coefficients are written back to it at exit, so that later runs start from them.
+ *
  * \section source Source organization
  * 
  * include/ contains the interface file ctf.hpp, which should be included when you build code that uses CTF
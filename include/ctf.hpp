@@ -19,6 +19,8 @@
 #include "../src/interface/timer.h"
 #include "../src/interface/back_comp.h"
 #include "../src/interface/kernel.h"
+#include "../src/interface/decomposition.h"
+#include "../src/interface/spmspv.h"
 
 #endif
 
@@ -19,6 +19,8 @@
 #include "../redistribution/redist.h"
 #include "../sparse_formats/coo.h"
 #include "../sparse_formats/csr.h"
+#include "../sparse_formats/csf.h"
+#include "../interface/timer.h"
 #include <cfloat>
 #include <limits>
 
@@ -26,6 +28,9 @@ namespace CTF_int {
 
   using namespace CTF;
 
+  // report of the contraction being executed, NULL if reports are not being recorded
+  static Contraction_Report * cur_ctr_report = NULL;
+
   contraction::~contraction(){
     if (idx_A != NULL) cdealloc(idx_A);
     if (idx_B != NULL) cdealloc(idx_B);
@@ -104,13 +109,451 @@ namespace CTF_int {
     print();
 #endif
 
-    //if (A->wrld->cdt.cm == MPI_COMM_WORLD){
-//      update_all_models(A->wrld->cdt.cm);
-    //}
+    // models are learned from collective operations on all processes only
+    if (A->wrld->cdt.cm == MPI_COMM_WORLD){
+      learn_all_models(A->wrld->cdt.cm);
+    }
+
+    Contraction_Report * prev_report = cur_ctr_report;
+    Contraction_Report rep;
+    double st_time = 0.0;
+    int64_t st_flops = 0, prev_peak = 0;
+    cur_ctr_report = NULL;
+    if (is_recording_ctr_reports()){
+      cur_ctr_report = &rep;
+      rep.term = get_report_term();
+      st_time = MPI_Wtime();
+      st_flops = get_flops();
+      prev_peak = proc_bytes_peak();
+      set_proc_bytes_peak(proc_bytes_used());
+    }
     
-    int stat = home_contract();
+    A->wait_redistribute();
+    B->wait_redistribute();
+    C->wait_redistribute();
+    int stat;
+    if (is_streamable() && estimate_time() == DBL_MAX)
+      stat = stream_contract();
+    else
+      stat = home_contract();
     if (stat != SUCCESS)
       printf("CTF ERROR: Failed to perform contraction\n");
+
+    if (cur_ctr_report != NULL){
+      rep.tot_time = MPI_Wtime()-st_time;
+      rep.flops = get_flops()-st_flops;
+      rep.mem_peak = proc_bytes_peak();
+      set_proc_bytes_peak(std::max(prev_peak, rep.mem_peak));
+      record_ctr_report(rep);
+    }
+    cur_ctr_report = prev_report;
+  }
+
+  std::string contraction::get_report_term(){
+    tensor * tsrs[] = {C, A, B};
+    int const * idxs[] = {idx_C, idx_A, idx_B};
+    std::string term;
+    for (int t=0; t<3; t++){
+      term += tsrs[t]->name;
+      term += "[";
+      for (int i=0; i<tsrs[t]->order; i++){
+        term += idxs[t][i] < 26 ? (char)('a'+idxs[t][i]) : '?';
+      }
+      term += "]";
+      if (t == 0) term += "+=";
+      if (t == 1) term += "*";
+    }
+    return term;
+  }
+
+  void contraction::report_layers(ctr * ctrf){
+    double nnz_frac_A = 1.0;
+    double nnz_frac_B = 1.0;
+    double nnz_frac_C = 1.0;
+    if (is_sparse()){
+      if (A->is_sparse) nnz_frac_A = std::min(1.,((double)A->nnz_tot)/(A->size*A->calc_npe()));
+      if (B->is_sparse) nnz_frac_B = std::min(1.,((double)B->nnz_tot)/(B->size*B->calc_npe()));
+      if (C->is_sparse) nnz_frac_C = std::min(1.,((double)C->nnz_tot)/(C->size*C->calc_npe()));
+      cur_ctr_report->mem_est = ((spctr*)ctrf)->spmem_rec(nnz_frac_A, nnz_frac_B, nnz_frac_C);
+    } else
+      cur_ctr_report->mem_est = ctrf->mem_rec();
+    cur_ctr_report->map_A = A->get_map_str();
+    cur_ctr_report->map_B = B->get_map_str();
+    cur_ctr_report->map_C = C->get_map_str();
+    cur_ctr_report->layers.clear();
+    for (ctr * c = ctrf; c != NULL; c = c->get_rec_ctr()){
+      Contraction_Layer_Report lyr;
+      lyr.name = c->get_name();
+      if (is_sparse())
+        lyr.est_time = ((spctr*)c)->est_time_rec(c->num_lyr, nnz_frac_A, nnz_frac_B, nnz_frac_C);
+      else
+        lyr.est_time = c->est_time_rec(c->num_lyr);
+      lyr.exe_time = c->run_time;
+      lyr.nrun = c->nrun;
+      cur_ctr_report->layers.push_back(lyr);
+    }
+    cur_ctr_report->est_time += cur_ctr_report->layers[0].est_time;
+  }
+
+  void contraction::prefetch(){
+    /* only worthwhile if contract() will operate on A and B directly */
+    if (A == B || A == C || B == C) return;
+    if (A->is_sparse || B->is_sparse || C->is_sparse) return;
+    if (A->has_zero_edge_len || B->has_zero_edge_len || C->has_zero_edge_len) return;
+    if (!A->is_mapped || !B->is_mapped || !C->is_mapped) return;
+    for (int i=0; i<A->order; i++){
+      if (A->sym[i] != NS) return;
+      for (int j=0; j<i; j++){
+        if (idx_A[i] == idx_A[j]) return;
+      }
+    }
+    for (int i=0; i<B->order; i++){
+      if (B->sym[i] != NS) return;
+      for (int j=0; j<i; j++){
+        if (idx_B[i] == idx_B[j]) return;
+      }
+    }
+    for (int i=0; i<C->order; i++){
+      if (C->sym[i] != NS) return;
+      for (int j=0; j<i; j++){
+        if (idx_C[i] == idx_C[j]) return;
+      }
+    }
+    TAU_FSTART(prefetch_contraction_operands);
+    ctr * ctrf = NULL;
+    map(&ctrf, 1, 1);
+    TAU_FSTOP(prefetch_contraction_operands);
+  }
+
+  /** \brief returns the position of label lbl in idx, or -1 */
+  static int find_lbl(int order, int const * idx, int lbl){
+    for (int i=0; i<order; i++){
+      if (idx[i] == lbl) return i;
+    }
+    return -1;
+  }
+
+  /** \brief sets C to beta*C, clearing it if beta is zero */
+  static void scale_output(tensor * C, char const * beta){
+    algstrct const * sr = C->sr;
+    if (beta == NULL || sr->isequal(beta, sr->mulid())) return;
+    if (sr->isequal(beta, sr->addid())){
+      C->set_zero();
+      return;
+    }
+    int sidx_C[C->order];
+    for (int i=0; i<C->order; i++){
+      sidx_C[i] = i;
+    }
+    scaling scl = scaling(C, sidx_C, beta);
+    scl.execute();
+  }
+
+  /** \brief reads the local nonzeros of a tensor, taking those of a dense tensor from its depadded local data */
+  static void read_local_nonzeros(tensor * T, int64_t * n, int64_t ** keys, char ** vals){
+    if (T->is_sparse){
+      T->read_local_nnz(n, keys, vals);
+      return;
+    }
+    algstrct const * sr = T->sr;
+    T->read_local(n, keys, vals);
+    int64_t nk = 0;
+    for (int64_t z=0; z<*n; z++){
+      if (!sr->isequal(*vals+z*sr->el_size, sr->addid())){
+        (*keys)[nk] = (*keys)[z];
+        memcpy(*vals+nk*sr->el_size, *vals+z*sr->el_size, sr->el_size);
+        nk++;
+      }
+    }
+    *n = nk;
+  }
+
+  /**
+   * \brief keeps the nonzeros of a sparse nonsymmetric operand whose output indices occur among the given entries of C
+   * \param[in] X sparse operand
+   * \param[in] idx_X labels of the modes of X
+   * \param[in] C output
+   * \param[in] idx_C labels of the modes of C
+   * \param[in] nm number of entries of C
+   * \param[in] cidx indices of the entries of C, C->order per entry
+   * \return new sparse tensor with the kept nonzeros, or X itself if none of its labels are in C
+   */
+  static tensor * restrict_to_rows(tensor *    X,
+                                   int const * idx_X,
+                                   tensor *    C,
+                                   int const * idx_C,
+                                   int64_t     nm,
+                                   int const * cidx){
+    algstrct const * sr = X->sr;
+    int nf = 0;
+    int flens[X->order], fpos_X[X->order], fpos_C[X->order], fsym[X->order];
+    for (int i=0; i<X->order; i++){
+      if (X->sym[i] != NS) return X;
+      int c = find_lbl(C->order, idx_C, idx_X[i]);
+      if (c != -1){
+        flens[nf] = X->lens[i];
+        fpos_X[nf] = i;
+        fpos_C[nf] = c;
+        fsym[nf] = NS;
+        nf++;
+      }
+    }
+    if (nf == 0) return X;
+
+    // R has a nonzero at each assignment of the output indices of X that occurs in the mask
+    std::vector<int64_t> rkeys(nm);
+    for (int64_t z=0; z<nm; z++){
+      int64_t k = 0, lda = 1;
+      for (int f=0; f<nf; f++){
+        k += cidx[z*C->order+fpos_C[f]]*lda;
+        lda *= flens[f];
+      }
+      rkeys[z] = k;
+    }
+    std::sort(rkeys.begin(), rkeys.end());
+    rkeys.erase(std::unique(rkeys.begin(), rkeys.end()), rkeys.end());
+    int64_t nr = rkeys.size();
+    tensor * R = new tensor(sr, nf, flens, fsym, X->wrld, true, NULL, 0, true);
+    char * ones = (char*)alloc(sr->el_size*std::max(nr,(int64_t)1));
+    sr->set(ones, sr->mulid(), nr);
+    R->write(nr, sr->mulid(), sr->mulid(), rkeys.data(), ones);
+    cdealloc(ones);
+
+    int64_t nx;
+    int64_t * xkeys;
+    char * xvals;
+    X->read_local_nnz(&nx, &xkeys, &xvals);
+    int64_t * xr = (int64_t*)alloc(sizeof(int64_t)*std::max(nx,(int64_t)1));
+    int64_t ldas[X->order];
+    ldas[0] = 1;
+    for (int i=1; i<X->order; i++){
+      ldas[i] = ldas[i-1]*X->lens[i-1];
+    }
+    for (int64_t z=0; z<nx; z++){
+      int64_t k = 0, lda = 1;
+      for (int f=0; f<nf; f++){
+        k += ((xkeys[z]/ldas[fpos_X[f]])%X->lens[fpos_X[f]])*lda;
+        lda *= flens[f];
+      }
+      xr[z] = k;
+    }
+    char * rv = (char*)alloc(sr->el_size*std::max(nx,(int64_t)1));
+    sr->set(rv, sr->addid(), nx);
+    R->read(nx, sr->mulid(), sr->addid(), xr, rv);
+    int64_t nk = 0;
+    for (int64_t z=0; z<nx; z++){
+      if (!sr->isequal(rv+z*sr->el_size, sr->addid())){
+        xkeys[nk] = xkeys[z];
+        memcpy(xvals+nk*sr->el_size, xvals+z*sr->el_size, sr->el_size);
+        nk++;
+      }
+    }
+    tensor * Xf = new tensor(sr, X->order, X->lens, X->sym, X->wrld, true, NULL, 0, true);
+    Xf->write(nk, sr->mulid(), sr->mulid(), xkeys, xvals);
+    cdealloc(rv);
+    cdealloc(xr);
+    cdealloc(xvals);
+    cdealloc(xkeys);
+    delete R;
+    return Xf;
+  }
+
+  bool contraction::can_sddmm(){
+    if (is_custom || A->is_sparse || B->is_sparse) return false;
+    tensor * tsrs[3] = {A, B, C};
+    int * idxs[3] = {idx_A, idx_B, idx_C};
+    for (int t=0; t<3; t++){
+      for (int i=0; i<tsrs[t]->order; i++){
+        if (tsrs[t]->sym[i] != NS) return false;
+        if (find_lbl(i, idxs[t], idxs[t][i]) != -1) return false;
+      }
+    }
+    // an index of only one operand would have to be summed out before the dot products
+    for (int i=0; i<A->order; i++){
+      if (find_lbl(B->order, idx_B, idx_A[i]) == -1 && find_lbl(C->order, idx_C, idx_A[i]) == -1) return false;
+    }
+    for (int i=0; i<B->order; i++){
+      if (find_lbl(A->order, idx_A, idx_B[i]) == -1 && find_lbl(C->order, idx_C, idx_B[i]) == -1) return false;
+    }
+    return true;
+  }
+
+  void contraction::sddmm(int64_t nm, int64_t * mkeys, int const * cidx){
+    TAU_FSTART(sddmm);
+    algstrct const * sr = C->sr;
+    int el_size = sr->el_size;
+
+    // contracted indices, enumerated in the order they appear in A
+    int nk = 0;
+    int klbl[A->order], klen[A->order];
+    int64_t K = 1;
+    for (int i=0; i<A->order; i++){
+      if (find_lbl(C->order, idx_C, idx_A[i]) == -1){
+        klbl[nk] = idx_A[i];
+        klen[nk] = A->lens[i];
+        K *= A->lens[i];
+        nk++;
+      }
+    }
+
+    // for each distinct assignment of the output indices of an operand, read all of its entries along the contracted indices
+    tensor * ops[2] = {A, B};
+    int * idxs[2] = {idx_A, idx_B};
+    char * rows[2];
+    int64_t * pos[2];
+    for (int o=0; o<2; o++){
+      tensor * X = ops[o];
+      int * idx_X = idxs[o];
+      int64_t lda[X->order];
+      lda[0] = 1;
+      for (int i=1; i<X->order; i++){
+        lda[i] = lda[i-1]*X->lens[i-1];
+      }
+      int64_t * kofs = (int64_t*)alloc(sizeof(int64_t)*std::max(K,(int64_t)1));
+      for (int64_t k=0; k<K; k++){
+        int64_t kk = k;
+        kofs[k] = 0;
+        for (int l=0; l<nk; l++){
+          kofs[k] += (kk%klen[l])*lda[find_lbl(X->order, idx_X, klbl[l])];
+          kk /= klen[l];
+        }
+      }
+      std::vector<int64_t> rofs(nm);
+      for (int64_t z=0; z<nm; z++){
+        rofs[z] = 0;
+        for (int i=0; i<X->order; i++){
+          int c = find_lbl(C->order, idx_C, idx_X[i]);
+          if (c != -1) rofs[z] += cidx[z*C->order+c]*lda[i];
+        }
+      }
+      std::vector<int64_t> dist(rofs);
+      std::sort(dist.begin(), dist.end());
+      dist.erase(std::unique(dist.begin(), dist.end()), dist.end());
+      int64_t nrow = dist.size();
+      pos[o] = (int64_t*)alloc(sizeof(int64_t)*std::max(nm,(int64_t)1));
+      for (int64_t z=0; z<nm; z++){
+        pos[o][z] = (std::lower_bound(dist.begin(), dist.end(), rofs[z]) - dist.begin())*K;
+      }
+      int64_t * gidx = (int64_t*)alloc(sizeof(int64_t)*std::max(nrow*K,(int64_t)1));
+      for (int64_t r=0; r<nrow; r++){
+        for (int64_t k=0; k<K; k++){
+          gidx[r*K+k] = dist[r]+kofs[k];
+        }
+      }
+      rows[o] = (char*)alloc(X->sr->el_size*std::max(nrow*K,(int64_t)1));
+      X->sr->set(rows[o], X->sr->addid(), nrow*K);
+      X->read(nrow*K, X->sr->mulid(), X->sr->addid(), gidx, rows[o]);
+      cdealloc(gidx);
+      cdealloc(kofs);
+    }
+
+    char * out = (char*)alloc(el_size*std::max(nm,(int64_t)1));
+    sr->set(out, sr->addid(), nm);
+#ifdef USE_OMP
+    #pragma omp parallel for
+#endif
+    for (int64_t z=0; z<nm; z++){
+      sr->mul_acc(K, NULL, rows[0]+pos[0][z]*el_size, 1, rows[1]+pos[1][z]*el_size, 1, out+z*el_size, 0);
+    }
+    scale_output(C, beta);
+    C->write(nm, alpha == NULL ? sr->mulid() : alpha, sr->mulid(), mkeys, out);
+
+    cdealloc(out);
+    for (int o=0; o<2; o++){
+      cdealloc(rows[o]);
+      cdealloc(pos[o]);
+    }
+    TAU_FSTOP(sddmm);
+  }
+
+  void contraction::execute_masked(tensor * M, bool complement){
+    bool match = M->order == C->order && M->wrld->cdt.cm == C->wrld->cdt.cm;
+    for (int i=0; match && i<C->order; i++){
+      if (M->lens[i] != C->lens[i] || M->sym[i] != NS || C->sym[i] != NS) match = false;
+    }
+    if (!match){
+      printf("CTF ERROR: mask must be a nonsymmetric tensor with the lengths of a nonsymmetric output\n");
+      ASSERT(0);
+      return;
+    }
+    A->wait_redistribute();
+    B->wait_redistribute();
+    C->wait_redistribute();
+    algstrct const * sr = C->sr;
+    int el_size = sr->el_size;
+
+    int64_t nm = 0;
+    int64_t * mkeys = NULL;
+    int * cidx = NULL;
+    if (!complement){
+      char * mvals;
+      read_local_nonzeros(M, &nm, &mkeys, &mvals);
+      cdealloc(mvals);
+      cidx = (int*)alloc(sizeof(int)*std::max(nm*C->order,(int64_t)1));
+      for (int64_t z=0; z<nm; z++){
+        int64_t k = mkeys[z];
+        for (int i=0; i<C->order; i++){
+          cidx[z*C->order+i] = k%C->lens[i];
+          k /= C->lens[i];
+        }
+      }
+      if (can_sddmm()){
+        sddmm(nm, mkeys, cidx);
+        cdealloc(cidx);
+        cdealloc(mkeys);
+        return;
+      }
+    }
+
+    TAU_FSTART(masked_contract);
+    // compute the full product of the operands, restricting sparse ones to the parts that reach the mask
+    tensor * fA = A, * fB = B;
+    if (!complement){
+      if (A->is_sparse) fA = restrict_to_rows(A, idx_A, C, idx_C, nm, cidx);
+      if (B->is_sparse) fB = restrict_to_rows(B, idx_B, C, idx_C, nm, cidx);
+    }
+    int nosym[C->order];
+    std::fill(nosym, nosym+C->order, NS);
+    tensor * T = new tensor(sr, C->order, C->lens, nosym, C->wrld, true, NULL, 0, fA->is_sparse && fB->is_sparse);
+    contraction ctr(fA, idx_A, fB, idx_B, alpha, T, idx_C, sr->addid(), is_custom ? func : NULL);
+    ctr.execute();
+    if (fA != A) delete fA;
+    if (fB != B) delete fB;
+
+    int64_t nw;
+    int64_t * wkeys;
+    char * wvals;
+    if (!complement){
+      nw = nm;
+      wkeys = mkeys;
+      wvals = (char*)alloc(el_size*std::max(nm,(int64_t)1));
+      sr->set(wvals, sr->addid(), nm);
+      T->read(nm, sr->mulid(), sr->addid(), mkeys, wvals);
+      cdealloc(cidx);
+    } else {
+      // keep the nonzeros of the product at which the mask is zero
+      read_local_nonzeros(T, &nw, &wkeys, &wvals);
+      algstrct const * msr = M->sr;
+      char * mv = (char*)alloc(msr->el_size*std::max(nw,(int64_t)1));
+      msr->set(mv, msr->addid(), nw);
+      M->read(nw, msr->mulid(), msr->addid(), wkeys, mv);
+      int64_t nk = 0;
+      for (int64_t z=0; z<nw; z++){
+        if (msr->isequal(mv+z*msr->el_size, msr->addid())){
+          wkeys[nk] = wkeys[z];
+          memcpy(wvals+nk*el_size, wvals+z*el_size, el_size);
+          nk++;
+        }
+      }
+      nw = nk;
+      cdealloc(mv);
+    }
+    delete T;
+    scale_output(C, beta);
+    C->write(nw, sr->mulid(), sr->mulid(), wkeys, wvals);
+    cdealloc(wvals);
+    cdealloc(wkeys);
+    TAU_FSTOP(masked_contract);
   }
   
   template<typename ptype>
@@ -161,8 +604,191 @@ namespace CTF_int {
 
 
   double contraction::estimate_time(){
-    assert(0); //FIXME
-    return 0.0;
+    if (A->has_zero_edge_len || B->has_zero_edge_len || C->has_zero_edge_len) return 0.0;
+    tensor * tsrs[3] = {A, B, C};
+    topology * old_topo[3];
+    mapping * old_map[3];
+    for (int i=0; i<3; i++){
+      old_topo[i] = tsrs[i]->topo;
+      old_map[i] = new mapping[tsrs[i]->order];
+      copy_mapping(tsrs[i]->order, tsrs[i]->edge_map, old_map[i]);
+    }
+    // selects the mapping (including layered ones) without moving any data, then restores the mappings of the tensors
+    ctr * ctrf = NULL;
+    double est_time = DBL_MAX;
+    if (map(&ctrf, 0, 0, &est_time) != SUCCESS) est_time = DBL_MAX;
+    for (int i=0; i<3; i++){
+      tsrs[i]->topo = old_topo[i];
+      copy_mapping(tsrs[i]->order, old_map[i], tsrs[i]->edge_map);
+      tsrs[i]->is_mapped = 1;
+      tsrs[i]->set_padding();
+      delete [] old_map[i];
+    }
+    return est_time;
+  }
+
+  bool contraction::is_streamable(){
+    if (!CTF::OUT_OF_CORE || is_custom) return false;
+    if (A == B || A == C || B == C) return false;
+    if (A->is_sparse || B->is_sparse || C->is_sparse) return false;
+    if (A->has_zero_edge_len || B->has_zero_edge_len || C->has_zero_edge_len) return false;
+    if (!A->is_mapped || !B->is_mapped || !C->is_mapped) return false;
+    tensor * tsrs[3] = {A, B, C};
+    int const * idxs[3] = {idx_A, idx_B, idx_C};
+    for (int t=0; t<3; t++){
+      for (int i=0; i<tsrs[t]->order; i++){
+        if (tsrs[t]->sym[i] != NS) return false;
+        for (int j=0; j<i; j++){
+          if (idxs[t][i] == idxs[t][j]) return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  /**
+   * \brief allocates a nonsymmetric tensor of the same shape as T, except of length w in mode dim
+   * \param[in] T tensor to take the shape of
+   * \param[in] dim mode of T to shorten
+   * \param[in] w length of mode dim
+   */
+  static tensor * new_slab(tensor * T, int dim, int w){
+    int lens[T->order];
+    memcpy(lens, T->lens, sizeof(int)*T->order);
+    lens[dim] = w;
+    char nm[strlen(T->name)+6];
+    sprintf(nm, "%s_slab", T->name);
+    return new tensor(T->sr, T->order, lens, T->sym, T->wrld, 1, nm, 0);
+  }
+
+  /**
+   * \brief creates the slabs [off,off+w) along a contraction index of the operands that carry it,
+   *        extracting the data of the slabs of A and B, the slab of C is left zero
+   * \param[in] tsrs operands A, B, C
+   * \param[in] dims mode of each operand along which to slice, -1 if the operand does not carry the index
+   * \param[in] off offset of the slab
+   * \param[in] w width of the slab
+   * \param[in] fill whether to extract the data of the slabs of A and B
+   * \param[out] slabs slab of each operand, or the operand itself if it does not carry the index
+   */
+  static void make_slabs(tensor * const * tsrs, int const * dims, int off, int w, bool fill, tensor ** slabs){
+    for (int t=0; t<3; t++){
+      if (dims[t] == -1){
+        slabs[t] = tsrs[t];
+        continue;
+      }
+      tensor * T = tsrs[t];
+      slabs[t] = new_slab(T, dims[t], w);
+      if (t < 2 && fill){
+        int offs[T->order], ends[T->order], zeros[T->order];
+        for (int i=0; i<T->order; i++){
+          offs[i] = 0;
+          ends[i] = T->lens[i];
+          zeros[i] = 0;
+        }
+        offs[dims[t]] = off;
+        ends[dims[t]] = off+w;
+        slabs[t]->slice(zeros, slabs[t]->lens, T->sr->addid(), T, offs, ends, T->sr->mulid());
+      }
+    }
+  }
+
+  /** \brief deletes the slabs made by make_slabs */
+  static void delete_slabs(tensor * const * tsrs, tensor ** slabs){
+    for (int t=0; t<3; t++){
+      if (slabs[t] != tsrs[t]) delete slabs[t];
+    }
+  }
+
+  int contraction::stream_contract(){
+    TAU_FSTART(stream_contract);
+    tensor * tsrs[3] = {A, B, C};
+    int num_tot, * idx_arr;
+    inv_idx(A->order, idx_A, B->order, idx_B, C->order, idx_C, &num_tot, &idx_arr);
+
+    // split along the index carried by the most data
+    int ibest = -1;
+    double best_sz = 0.;
+    for (int i=0; i<num_tot; i++){
+      double sz = 0.;
+      int len = 1;
+      for (int t=0; t<3; t++){
+        int d = idx_arr[3*i+t];
+        if (d == -1) continue;
+        len = tsrs[t]->lens[d];
+        double tsz = 1.;
+        for (int j=0; j<tsrs[t]->order; j++) tsz *= tsrs[t]->lens[j];
+        sz += tsz;
+      }
+      if (len > 1 && sz > best_sz){
+        ibest = i;
+        best_sz = sz;
+      }
+    }
+    if (ibest == -1){
+      cdealloc(idx_arr);
+      TAU_FSTOP(stream_contract);
+      return home_contract();
+    }
+    int dims[3];
+    int len = 0;
+    for (int t=0; t<3; t++){
+      dims[t] = idx_arr[3*ibest+t];
+      if (dims[t] != -1) len = tsrs[t]->lens[dims[t]];
+    }
+    cdealloc(idx_arr);
+
+    // fewest slabs for which a mapping fits in memory while the next slabs are also resident (for prefetch),
+    // slab contractions that still do not fit are split further along another index when executed
+    int w = len;
+    tensor * cur[3], * nxt[3];
+    do {
+      w = (w+1)/2;
+      make_slabs(tsrs, dims, 0, w, 0, cur);
+      make_slabs(tsrs, dims, 0, w, 0, nxt);
+      contraction slab_ctr(cur[0], idx_A, cur[1], idx_B, alpha, cur[2], idx_C, beta);
+      double est_time = slab_ctr.estimate_time();
+      delete_slabs(tsrs, nxt);
+      delete_slabs(tsrs, cur);
+      if (est_time != DBL_MAX) break;
+    } while (w > 1);
+    int ns = (len+w-1)/w;
+    if (A->wrld->rank == 0)
+      DPRINTF(1,"No mapping of contraction fits in memory, streaming it in %d slabs of width %d\n", ns, w);
+
+    char const * mulid = C->sr->mulid();
+    make_slabs(tsrs, dims, 0, w, 1, cur);
+    for (int s=0; s<ns; s++){
+      int off = s*w;
+      int ws = std::min(w, len-off);
+      // partial sums accumulate into C when C does not carry the index
+      char const * beta_s = dims[2] == -1 ? (s == 0 ? beta : mulid) : C->sr->addid();
+      contraction slab_ctr(cur[0], idx_A, cur[1], idx_B, alpha, cur[2], idx_C, beta_s);
+      if (s+1 < ns){
+        // the next slabs are redistributed asynchronously while this one is contracted
+        make_slabs(tsrs, dims, off+w, std::min(w, len-off-w), 1, nxt);
+        contraction nxt_ctr(nxt[0], idx_A, nxt[1], idx_B, alpha, nxt[2], idx_C, beta_s);
+        nxt_ctr.prefetch();
+      }
+      slab_ctr.execute();
+      if (dims[2] != -1){
+        int offs[C->order], ends[C->order], zeros[C->order];
+        for (int i=0; i<C->order; i++){
+          offs[i] = 0;
+          ends[i] = C->lens[i];
+          zeros[i] = 0;
+        }
+        offs[dims[2]] = off;
+        ends[dims[2]] = off+ws;
+        C->slice(offs, ends, beta == NULL ? mulid : beta, cur[2], zeros, cur[2]->lens, mulid);
+      }
+      delete_slabs(tsrs, cur);
+      if (s+1 < ns){
+        for (int t=0; t<3; t++) cur[t] = nxt[t];
+      }
+    }
+    TAU_FSTOP(stream_contract);
+    return SUCCESS;
   }
 
   int contraction::is_equal(contraction const & os){
@@ -385,6 +1011,10 @@ namespace CTF_int {
 
   }
 
+  bool contraction::overwrites_C(){
+    return !C->is_sparse && C->sr->addid() != NULL && C->sr->isequal(beta, C->sr->addid());
+  }
+
   int contraction::can_fold(){
     int nfold, * fold_idx, i, j;
     if (!is_sparse() && is_custom) return 0;
@@ -809,8 +1439,23 @@ namespace CTF_int {
     permute_target(tfB->order, fnew_ord_B, tB->inner_ordering);
     permute_target(tfC->order, fnew_ord_C, tC->inner_ordering);
  
+    bool csr_or_coo = B->is_sparse || C->is_sparse || is_custom || !A->sr->has_coo_ker;
+    iprm.csf = false;
+    if (A->is_sparse && !B->is_sparse && !C->is_sparse && !is_custom && A->order >= 3){
+      // CSF pays off for higher-order tensors whose blocks share index prefixes, decided from global quantities so all processes agree
+      bool is_ns = true;
+      int loc_lens[A->order];
+      double nblk = 1.;
+      for (int i=0; i<A->order; i++){
+        if (A->sym[i] != NS) is_ns = false;
+        int phase = A->edge_map[i].calc_phase();
+        loc_lens[i] = A->lens[i]/phase + (A->lens[i]%phase > 0);
+        nblk *= phase;
+      }
+      if (is_ns)
+        iprm.csf = prefer_csf(A->order, loc_lens, A->nnz_tot/nblk, A->sr->el_size, iprm.m, csr_or_coo);
+    }
     if (do_transp){
-      bool csr_or_coo = B->is_sparse || C->is_sparse || is_custom || !A->sr->has_coo_ker;
       if (!A->is_sparse){
         nosym_transpose(A, all_fdim_A, all_flen_A, A->inner_ordering, 1);
       } else {
@@ -820,7 +1465,7 @@ namespace CTF_int {
             if (idx_A[i] == idx_C[j]) nrow_idx++;
           }
         }
-        A->spmatricize(iprm.m, iprm.k, nrow_idx, csr_or_coo);
+        A->spmatricize(iprm.m, iprm.k, nrow_idx, csr_or_coo, iprm.csf);
       }
       if (!B->is_sparse){
         nosym_transpose(B, all_fdim_B, all_flen_B, B->inner_ordering, 1);
@@ -1107,6 +1752,167 @@ namespace CTF_int {
     return -1;
   }
 
+  /**
+   * \brief defines the block of a nonsymmetric tensor in which the modes labeled a and b are restricted to the given ranges
+   * \param[in] tsr tensor
+   * \param[in] idx labels of the modes of tsr
+   * \param[in] a,b labels restricted to [a_st,a_end) and [b_st,b_end)
+   * \param[in] copy_data whether to read the block from tsr, otherwise it is left zero
+   * \param[out] offs,ends range of the block in tsr
+   * \return new tensor holding the block, or tsr itself if it has neither label
+   */
+  static tensor * get_sym_blk(tensor *    tsr,
+                              int const * idx,
+                              int         a,
+                              int         a_st,
+                              int         a_end,
+                              int         b,
+                              int         b_st,
+                              int         b_end,
+                              bool        copy_data,
+                              int *       offs,
+                              int *       ends){
+    bool has_lbl = false;
+    int lens[tsr->order];
+    int zeros[tsr->order];
+    int sym[tsr->order];
+    for (int i=0; i<tsr->order; i++){
+      offs[i] = 0;
+      ends[i] = tsr->lens[i];
+      if (idx[i] == a){
+        offs[i] = a_st;
+        ends[i] = a_end;
+        has_lbl = true;
+      }
+      if (idx[i] == b){
+        offs[i] = b_st;
+        ends[i] = b_end;
+        has_lbl = true;
+      }
+      lens[i] = ends[i]-offs[i];
+      zeros[i] = 0;
+      sym[i] = NS;
+    }
+    if (!has_lbl) return tsr;
+    tensor * blk = new tensor(tsr->sr, tsr->order, lens, sym, tsr->wrld, true);
+    if (copy_data)
+      blk->slice(zeros, lens, tsr->sr->addid(), tsr, offs, ends, tsr->sr->mulid());
+    return blk;
+  }
+
+  bool contraction::can_sym_blocked(){
+    if (is_custom || is_sparse()) return false;
+    for (int i=0; i<C->order; i++){
+      if (C->sym[i] != NS) return false;
+    }
+    int nsym = 0;
+    for (int i=0; i<A->order; i++){
+      if (A->sym[i] != NS) nsym++;
+    }
+    for (int i=0; i<B->order; i++){
+      if (B->sym[i] != NS) nsym++;
+    }
+    return nsym == 1;
+  }
+
+  int contraction::sym_blocked_contract(){
+    int p_A = -1, p_B = -1;
+    for (int i=0; i<A->order; i++){
+      if (A->sym[i] != NS) p_A = i;
+    }
+    for (int i=0; i<B->order; i++){
+      if (B->sym[i] != NS) p_B = i;
+    }
+    ASSERT((p_A == -1) != (p_B == -1));
+
+    bool X_is_A   = p_A != -1;
+    tensor * X    = X_is_A ? A : B;
+    tensor * O    = X_is_A ? B : A;
+    int * idx_X   = X_is_A ? idx_A : idx_B;
+    int * idx_O   = X_is_A ? idx_B : idx_A;
+    int p         = X_is_A ? p_A : p_B;
+    int a         = idx_X[p];
+    int b         = idx_X[p+1];
+    int n         = X->lens[p];
+    algstrct const * sr = C->sr;
+
+    // halve the blocks until a block of X along with the parts of the other operand and of C it touches fits in memory
+    int nblk = 2;
+    for (;;){
+      int64_t nb = (n+nblk-1)/nblk;
+      double blk_sz = 0.;
+      tensor * tsrs[3] = {X, O, C};
+      int * idxs[3] = {idx_X, idx_O, idx_C};
+      for (int t=0; t<3; t++){
+        double sz = 1.;
+        for (int i=0; i<tsrs[t]->order; i++){
+          if (idxs[t][i] == a || idxs[t][i] == b) sz *= nb;
+          else sz *= tsrs[t]->lens[i];
+        }
+        blk_sz += sz;
+      }
+      if (nblk >= n || blk_sz*sr->el_size/X->wrld->np < .5*proc_bytes_available()) break;
+      nblk *= 2;
+    }
+    nblk = std::min(nblk, n);
+    int blk_st[nblk+1];
+    for (int i=0; i<=nblk; i++){
+      blk_st[i] = (int)(((int64_t)n)*i/nblk);
+    }
+    if (X->wrld->rank == 0)
+      DPRINTF(1,"Contracting %d x %d blocks of packed symmetric operand instead of desymmetrizing it\n",nblk,nblk);
+
+    TAU_FSTART(sym_blocked_contract);
+    scale_output(C, beta);
+    // X[a,b] = X[b,a] for SY and SH, X[a,b] = -X[b,a] for AS
+    char * talpha = (char*)alloc(sr->el_size);
+    if (X->sym[p] == AS) sr->addinv(alpha, talpha);
+    else sr->copy(talpha, alpha);
+
+    int offs_X[X->order], ends_X[X->order];
+    int offs_O[O->order], ends_O[O->order];
+    int offs_C[C->order], ends_C[C->order];
+    int idx_T[X->order];
+    int zeros[C->order];
+    std::fill(zeros, zeros+C->order, 0);
+    for (int I=0; I<nblk; I++){
+      for (int K=I; K<nblk; K++){
+        // diagonal blocks are unpacked on their own, off-diagonal ones are read from one side of the packed triangle
+        tensor * T = get_sym_blk(X, idx_X, a, blk_st[I], blk_st[I+1], b, blk_st[K], blk_st[K+1], true, offs_X, ends_X);
+        // the block (I,K) gives the contributions of X[a in I, b in K] and, read transposed, of X[a in K, b in I]
+        for (int t=0; t<(I==K ? 1 : 2); t++){
+          int ra = t == 0 ? I : K;
+          int rb = t == 0 ? K : I;
+          memcpy(idx_T, idx_X, X->order*sizeof(int));
+          if (t == 1){
+            idx_T[p]   = b;
+            idx_T[p+1] = a;
+          }
+          tensor * Os = get_sym_blk(O, idx_O, a, blk_st[ra], blk_st[ra+1], b, blk_st[rb], blk_st[rb+1], true, offs_O, ends_O);
+          tensor * Cs = get_sym_blk(C, idx_C, a, blk_st[ra], blk_st[ra+1], b, blk_st[rb], blk_st[rb+1], false, offs_C, ends_C);
+          char const * blk_alpha = t == 0 ? alpha : talpha;
+          char const * blk_beta = Cs == C ? sr->mulid() : sr->addid();
+          if (X_is_A){
+            contraction ctr(T, idx_T, Os, idx_O, blk_alpha, Cs, idx_C, blk_beta);
+            ctr.execute();
+          } else {
+            contraction ctr(Os, idx_O, T, idx_T, blk_alpha, Cs, idx_C, blk_beta);
+            ctr.execute();
+          }
+          if (Cs != C){
+            C->slice(offs_C, ends_C, sr->mulid(), Cs, zeros, Cs->lens, sr->mulid());
+            delete Cs;
+          }
+          if (Os != O) delete Os;
+        }
+        delete T;
+      }
+    }
+    cdealloc(talpha);
+    TAU_FSTOP(sym_blocked_contract);
+    return SUCCESS;
+  }
+
   bool contraction::check_consistency(){
     int i, num_tot, len;
     int iA, iB, iC;
@@ -2625,7 +3431,8 @@ namespace CTF_int {
         } else
           need_remap_C = 1;
         if (need_remap_C) {
-          est_time += 2.*C->est_redist_time(*dC, nnz_frac_C); 
+          //if C is overwritten, its data is not moved, only a home tensor is moved back later
+          est_time += (overwrites_C() ? (C->is_home ? 1. : 0.) : 2.)*C->est_redist_time(*dC, nnz_frac_C); 
           memuse = std::max(1.0*memuse,2.*C->get_redist_mem(*dC, nnz_frac_C));
         }
         if (is_ctr_sparse)
@@ -2843,7 +3650,8 @@ namespace CTF_int {
         } else
           need_remap_C = 1;
         if (need_remap_C) {
-          est_time += 2.*C->est_redist_time(*dC, nnz_frac_C); 
+          //if C is overwritten, its data is not moved, only a home tensor is moved back later
+          est_time += (overwrites_C() ? (C->is_home ? 1. : 0.) : 2.)*C->est_redist_time(*dC, nnz_frac_C); 
           memuse = std::max(1.*memuse,2.*C->get_redist_mem(*dC, nnz_frac_C));
         }
  
@@ -2904,7 +3712,188 @@ namespace CTF_int {
 
   }
 
-  int contraction::map(ctr ** ctrf, bool do_remap){
+  /**
+   * \brief shifts the physical topology dimensions to which a tensor is mapped, so that a mapping onto the topology
+   *        without dimension l becomes a mapping onto the full topology that leaves dimension l unmapped
+   */
+  static void shift_phys_map(tensor * T, int l){
+    for (int i=0; i<T->order; i++){
+      mapping * map = &T->edge_map[i];
+      while (map != NULL){
+        if (map->type == PHYSICAL_MAP && map->cdt >= l) map->cdt++;
+        map = map->has_child ? map->child : NULL;
+      }
+    }
+  }
+
+  /**
+   * \brief builds the topology consisting of all but dimension l of topo, which is used to map the tensors
+   *        so that dimension l of topo is left to replicate them
+   */
+  static topology * get_lyr_sub_topo(topology const * topo, int l, CommData global_comm){
+    int sub_lens[topo->order];
+    for (int i=0, ii=0; i<topo->order; i++){
+      if (i != l) sub_lens[ii++] = topo->lens[i];
+    }
+    return new topology(topo->order-1, sub_lens, global_comm);
+  }
+
+  void contraction::get_best_lyr_map(distribution const * dA, distribution const * dB, distribution const * dC, topology * old_topo_A, topology * old_topo_B, topology * old_topo_C, mapping const * old_map_A, mapping const * old_map_B, mapping const * old_map_C, int & idx, double & time){
+    int ret, d;
+    int need_remap_A, need_remap_B, need_remap_C;
+    int64_t memuse;
+    double est_time, best_time;
+    int btopo;
+    World * wrld = A->wrld;
+    CommData global_comm = wrld->cdt;
+    btopo = -1;
+    best_time = DBL_MAX;
+    int64_t max_memuse = proc_bytes_available();
+    // layers are only supported by the dense contraction algorithms and require C to be accumulated by the additive
+    // operator, with an additive identity from which the partial sums of each layer start (see ctr_replicate)
+    bool can_lyr = !is_sparse() && !is_custom && C->sr->addid() != NULL;
+    int64_t tot_bytes = sy_packed_size(A->order, A->lens, A->sym)*A->sr->el_size
+                      + sy_packed_size(B->order, B->lens, B->sym)*B->sr->el_size
+                      + sy_packed_size(C->order, C->lens, C->sym)*C->sr->el_size;
+    int q = 0;
+    for (int t=0; can_lyr && t<(int)wrld->topovec.size(); t++){
+      topology * topo_i = wrld->topovec[t];
+      for (int l=0; l<topo_i->order; l++, q++){
+        int c = topo_i->lens[l];
+        if (topo_i->order < 2 || c < 2) continue;
+        // each of the c layers holds a copy of the operands
+        if (((double)c)*tot_bytes/global_comm.np >= max_memuse){
+          if (global_comm.rank == 0)
+            DPRINTF(1,"Not enough memory to replicate tensors %d times along dimension %d of topo %d\n", c, l, t);
+          continue;
+        }
+        topology * sub_topo = NULL;
+        for (int j=0; j<6; j++){
+  #if DEBUG < 3
+          if ((6*q+j) % global_comm.np != global_comm.rank) continue;
+  #endif
+          if (sub_topo == NULL) sub_topo = get_lyr_sub_topo(topo_i, l, global_comm);
+          A->clear_mapping();
+          B->clear_mapping();
+          C->clear_mapping();
+          A->set_padding();
+          B->set_padding();
+          C->set_padding();
+
+          TAU_FSTART(map_ctr_to_topo);
+          ret = map_to_topology(sub_topo, j);
+          TAU_FSTOP(map_ctr_to_topo);
+          if (ret != SUCCESS) continue;
+          shift_phys_map(A, l);
+          shift_phys_map(B, l);
+          shift_phys_map(C, l);
+
+          A->is_mapped = 1;
+          B->is_mapped = 1;
+          C->is_mapped = 1;
+          A->topo = topo_i;
+          B->topo = topo_i;
+          C->topo = topo_i;
+
+          TAU_FSTART(check_ctr_mapping);
+          if (check_mapping() == 0){
+            TAU_FSTOP(check_ctr_mapping);
+            continue;
+          }
+          TAU_FSTOP(check_ctr_mapping);
+          TAU_FSTART(est_ctr_map_time);
+          A->set_padding();
+          B->set_padding();
+          C->set_padding();
+          ctr * sctr;
+  #if FOLD_TSR
+          if (can_fold()){
+            iparam prm = map_fold(false);
+            sctr = construct_ctr(1, &prm);
+            A->remove_fold();
+            B->remove_fold();
+            C->remove_fold();
+          } else
+  #endif
+            sctr = construct_ctr();
+          est_time = sctr->est_time_rec(sctr->num_lyr);
+  #if DEBUG >= 3
+          if (global_comm.rank == 0){
+            printf("layered mapping with %d layers passed contr est_time = %E sec\n", c, est_time);
+          }
+  #endif
+          ASSERT(est_time >= 0.0);
+          need_remap_A = 0;
+          need_remap_B = 0;
+          need_remap_C = 0;
+          if (topo_i == old_topo_A){
+            for (d=0; d<A->order; d++){
+              if (!comp_dim_map(&A->edge_map[d],&old_map_A[d]))
+                need_remap_A = 1;
+            }
+          } else
+            need_remap_A = 1;
+          memuse = 0;
+          if (need_remap_A) {
+            est_time += A->est_redist_time(*dA, 1.0);
+            memuse = A->get_redist_mem(*dA, 1.0);
+          }
+          if (topo_i == old_topo_B){
+            for (d=0; d<B->order; d++){
+              if (!comp_dim_map(&B->edge_map[d],&old_map_B[d]))
+                need_remap_B = 1;
+            }
+          } else
+            need_remap_B = 1;
+          if (need_remap_B) {
+            est_time += B->est_redist_time(*dB, 1.0);
+            memuse = std::max(memuse,B->get_redist_mem(*dB, 1.0));
+          }
+          if (topo_i == old_topo_C){
+            for (d=0; d<C->order; d++){
+              if (!comp_dim_map(&C->edge_map[d],&old_map_C[d]))
+                need_remap_C = 1;
+            }
+          } else
+            need_remap_C = 1;
+          if (need_remap_C) {
+            est_time += (overwrites_C() ? (C->is_home ? 1. : 0.) : 2.)*C->est_redist_time(*dC, 1.0);
+            memuse = std::max(1.0*memuse,2.*C->get_redist_mem(*dC, 1.0));
+          }
+          memuse = MAX((int64_t)sctr->mem_rec(), memuse);
+          TAU_FSTOP(est_ctr_map_time);
+          delete sctr;
+          if ((int64_t)memuse >= max_memuse){
+            DPRINTF(1,"Not enough memory available for layered topo %d with order %d memory %ld/%ld\n", t,j,memuse,max_memuse);
+            continue;
+          }
+          if (A->size > INT_MAX || B->size > INT_MAX || C->size > INT_MAX){
+            DPRINTF(1,"MPI does not handle enough bits for layered topo %d with order %d\n", t, j);
+            continue;
+          }
+          if (est_time < best_time) {
+            best_time = est_time;
+            btopo = 6*q+j;
+          }
+        }
+        if (sub_topo != NULL) delete sub_topo;
+      }
+    }
+    TAU_FSTART(all_select_ctr_map);
+    double gbest_time;
+    MPI_Allreduce(&best_time, &gbest_time, 1, MPI_DOUBLE, MPI_MIN, global_comm.cm);
+    if (best_time != gbest_time){
+      btopo = INT_MAX;
+    }
+    int ttopo;
+    MPI_Allreduce(&btopo, &ttopo, 1, MPI_INT, MPI_MIN, global_comm.cm);
+    TAU_FSTOP(all_select_ctr_map);
+
+    idx=ttopo;
+    time=gbest_time;
+  }
+
+  int contraction::map(ctr ** ctrf, bool do_remap, bool prefetch, double * est_time){
     int ret, j, need_remap, d;
     int * old_phase_A, * old_phase_B, * old_phase_C;
     topology * old_topo_A, * old_topo_B, * old_topo_C;
@@ -2966,8 +3955,8 @@ namespace CTF_int {
     }
 
     //bmemuse = UINT64_MAX;
-    int ttopo, ttopo_sel, ttopo_exh;
-    double gbest_time_sel, gbest_time_exh;
+    int ttopo, ttopo_sel, ttopo_exh, ttopo_lyr;
+    double gbest_time_sel, gbest_time_exh, gbest_time_lyr;
   
     TAU_FSTART(get_best_sel_map);
     get_best_sel_map(dA, dB, dC, old_topo_A, old_topo_B, old_topo_C, old_map_A, old_map_B, old_map_C, ttopo_sel, gbest_time_sel);
@@ -2980,11 +3969,27 @@ namespace CTF_int {
       get_best_exh_map(dA, dB, dC, old_topo_A, old_topo_B, old_topo_C, old_map_A, old_map_B, old_map_C, ttopo_exh, gbest_time_exh, gbest_time_sel);
       TAU_FSTOP(get_best_exh_map);
     }
+    TAU_FSTART(get_best_lyr_map);
+    get_best_lyr_map(dA, dB, dC, old_topo_A, old_topo_B, old_topo_C, old_map_A, old_map_B, old_map_C, ttopo_lyr, gbest_time_lyr);
+    TAU_FSTOP(get_best_lyr_map);
+    // 0: selected mapping, 1: exhaustive mapping, 2: layered mapping
+    int fam;
+    double gbest_time;
     if (gbest_time_sel <= gbest_time_exh){
+      fam = 0;
       ttopo = ttopo_sel;
+      gbest_time = gbest_time_sel;
     } else {
+      fam = 1;
       ttopo = ttopo_exh;
+      gbest_time = gbest_time_exh;
+    }
+    if (gbest_time_lyr < gbest_time && ttopo_lyr != INT_MAX && ttopo_lyr != -1){
+      fam = 2;
+      ttopo = ttopo_lyr;
+      gbest_time = gbest_time_lyr;
     }
+    if (est_time != NULL) *est_time = gbest_time;
 
     A->clear_mapping();
     B->clear_mapping();
@@ -2994,6 +3999,21 @@ namespace CTF_int {
     C->set_padding();
     
     if (!do_remap || ttopo == INT_MAX || ttopo == -1){
+      if (ttopo == INT_MAX || ttopo == -1){
+        // the data has not moved, so keep the tensors in their mappings
+        A->topo = old_topo_A;
+        B->topo = old_topo_B;
+        C->topo = old_topo_C;
+        copy_mapping(A->order, old_map_A, A->edge_map);
+        copy_mapping(B->order, old_map_B, B->edge_map);
+        copy_mapping(C->order, old_map_C, C->edge_map);
+        A->is_mapped = 1;
+        B->is_mapped = 1;
+        C->is_mapped = 1;
+        A->set_padding();
+        B->set_padding();
+        C->set_padding();
+      }
       CTF_int::cdealloc(old_phase_A);
       CTF_int::cdealloc(old_phase_B);
       CTF_int::cdealloc(old_phase_C);
@@ -3005,7 +4025,7 @@ namespace CTF_int {
       delete dC;
 
       if (ttopo == INT_MAX || ttopo == -1){
-        printf("ERROR: Failed to map contraction!\n");
+        if (do_remap) printf("ERROR: Failed to map contraction!\n");
         //ABORT;
         return ERROR;
       }
@@ -3013,7 +4033,8 @@ namespace CTF_int {
     }
     topology * topo_g = NULL;
     int j_g;
-    if (gbest_time_sel <= gbest_time_exh){
+    int l_g = -1;
+    if (fam == 0){
       j_g = ttopo%6;
       if (ttopo < 48){
         if (((ttopo/6) & 1) > 0){
@@ -3032,6 +4053,16 @@ namespace CTF_int {
         assert(topo_g != NULL);
 
       } else topo_g = wrld->topovec[(ttopo-48)/6];
+    } else if (fam == 2){
+      j_g = ttopo%6;
+      int q = ttopo/6;
+      int t = 0;
+      while (q >= wrld->topovec[t]->order){
+        q -= wrld->topovec[t]->order;
+        t++;
+      }
+      topo_g = wrld->topovec[t];
+      l_g = q;
     } else {
       int64_t choice_offset = 0;
       int i=0;
@@ -3054,12 +4085,26 @@ namespace CTF_int {
     B->is_mapped = 1;
     C->is_mapped = 1;
     
-    if (gbest_time_sel <= gbest_time_exh){
+    if (fam == 0){
       ret = map_to_topology(topo_g, j_g);
       if (ret == NEGATIVE || ret == ERROR) {
         printf("ERROR ON FINAL MAP ATTEMPT, THIS SHOULD NOT HAPPEN\n");
         return ERROR;
       }
+    } else if (fam == 2){
+      topology * sub_topo = get_lyr_sub_topo(topo_g, l_g, global_comm);
+      ret = map_to_topology(sub_topo, j_g);
+      delete sub_topo;
+      if (ret == NEGATIVE || ret == ERROR) {
+        printf("ERROR ON FINAL MAP ATTEMPT, THIS SHOULD NOT HAPPEN\n");
+        return ERROR;
+      }
+      shift_phys_map(A, l_g);
+      shift_phys_map(B, l_g);
+      shift_phys_map(C, l_g);
+      A->topo = topo_g;
+      B->topo = topo_g;
+      C->topo = topo_g;
     } else {
       exh_map_to_topo(topo_g, j_g);
       switch_topo_perm();
@@ -3123,7 +4168,7 @@ namespace CTF_int {
 
     if (global_comm.rank == 0){
       VPRINTF(1,"Contraction will use %E bytes per processor out of %E available memory and take an estimated of %E sec\n",
-              (double)memuse,(double)proc_bytes_available(),std::min(gbest_time_sel,gbest_time_exh));
+              (double)memuse,(double)proc_bytes_available(),gbest_time);
 #if DEBUG >= 3
       (*ctrf)->print();
 #endif
@@ -3143,6 +4188,7 @@ namespace CTF_int {
     }
     /* redistribute tensor data */
     TAU_FSTART(redistribute_for_contraction);
+    double st_redist = MPI_Wtime();
     need_remap = 0;
     if (A->topo == old_topo_A){
       for (d=0; d<A->order; d++){
@@ -3151,8 +4197,12 @@ namespace CTF_int {
       }
     } else
       need_remap = 1;
-    if (need_remap)
-      A->redistribute(*dA);
+    if (need_remap){
+      int64_t st_bytes = get_comm_bytes();
+      if (prefetch) A->redistribute_async(*dA);
+      else A->redistribute(*dA);
+      if (cur_ctr_report != NULL) cur_ctr_report->redist_bytes[0] += get_comm_bytes()-st_bytes;
+    }
     need_remap = 0;
     if (B->topo == old_topo_B){
       for (d=0; d<B->order; d++){
@@ -3161,8 +4211,12 @@ namespace CTF_int {
       }
     } else
       need_remap = 1;
-    if (need_remap)
-      B->redistribute(*dB);
+    if (need_remap){
+      int64_t st_bytes = get_comm_bytes();
+      if (prefetch) B->redistribute_async(*dB);
+      else B->redistribute(*dB);
+      if (cur_ctr_report != NULL) cur_ctr_report->redist_bytes[1] += get_comm_bytes()-st_bytes;
+    }
     need_remap = 0;
     if (C->topo == old_topo_C){
       for (d=0; d<C->order; d++){
@@ -3171,9 +4225,28 @@ namespace CTF_int {
       }
     } else
       need_remap = 1;
-    if (need_remap)
-      C->redistribute(*dC);
+    if (prefetch){
+      C->topo = old_topo_C;
+      copy_mapping(C->order, old_map_C, C->edge_map);
+      C->is_cyclic = dC->is_cyclic;
+      C->set_padding();
+      delete *ctrf;
+      *ctrf = NULL;
+    } else if (need_remap){
+      if (overwrites_C()){
+        //prior values of C are not used, so allocate it directly in the new mapping
+        if (C->is_home) C->is_home = 0;
+        else C->sr->dealloc(C->data);
+        C->data = C->sr->alloc(C->size);
+        C->sr->set(C->data, C->sr->addid(), C->size);
+      } else {
+        int64_t st_bytes = get_comm_bytes();
+        C->redistribute(*dC);
+        if (cur_ctr_report != NULL) cur_ctr_report->redist_bytes[2] += get_comm_bytes()-st_bytes;
+      }
+    }
                    
+    if (cur_ctr_report != NULL) cur_ctr_report->redist_time += MPI_Wtime()-st_redist;
     TAU_FSTOP(redistribute_for_contraction);
     
     CTF_int::cdealloc( old_phase_A );
@@ -3731,6 +4804,8 @@ namespace CTF_int {
           (i_A != -1 && i_B == -1 && i_C != -1) ||
           (i_A == -1 && i_B != -1 && i_C != -1)) {
         spctr_2d_general * ctr_gen = new spctr_2d_general(this);
+        ctr_gen->is_pairs_A = A->is_sparse && !is_inner;
+        ctr_gen->is_pairs_B = B->is_sparse && !is_inner;
   #ifdef OFFLOAD
         ctr_gen->alloc_host_buf = false;
   #endif
@@ -3939,7 +5014,8 @@ namespace CTF_int {
       ASSERT(!(!A->is_sparse && (B->is_sparse || C->is_sparse)));
       ASSERT(!(C->is_sparse && (!B->is_sparse || !A->is_sparse)));
       if (A->is_sparse && !B->is_sparse && !C->is_sparse){
-        if (is_custom || !A->sr->has_coo_ker) krnl_type = 2;
+        if (inner_params->csf) krnl_type = 5;
+        else if (is_custom || !A->sr->has_coo_ker) krnl_type = 2;
         else krnl_type = 1;
       } 
       if (A->is_sparse && B->is_sparse && !C->is_sparse){
@@ -4193,6 +5269,8 @@ namespace CTF_int {
     MPI_Barrier(global_comm.cm);
     TAU_FSTOP(pre_map_barrier);
   #endif
+    double st_map = MPI_Wtime();
+    double st_map_redist = cur_ctr_report != NULL ? cur_ctr_report->redist_time : 0.0;
   #if REDIST
     //stat = map_tensors(type, fftsr, felm, alpha, beta, &ctrf);
     stat = map(&ctrf);
@@ -4260,6 +5338,8 @@ namespace CTF_int {
       ctrf = construct_ctr(1, &prm);
     } 
   #endif
+    if (cur_ctr_report != NULL)
+      cur_ctr_report->map_time += MPI_Wtime()-st_map-(cur_ctr_report->redist_time-st_map_redist);
   #if DEBUG >=2
   if (global_comm.rank == 0){
     ctrf->print();
@@ -4294,6 +5374,7 @@ namespace CTF_int {
     TAU_FSTOP(pre_ctr_func_barrier);
   #endif
     TAU_FSTART(ctr_func);
+    double st_ctr = MPI_Wtime();
     /* Invoke the contraction algorithm */
     A->topo->activate();
     if (is_sparse()){
@@ -4372,6 +5453,10 @@ namespace CTF_int {
     MPI_Barrier(global_comm.cm);
     TAU_FSTOP(post_ctr_func_barrier);
   #endif
+    if (cur_ctr_report != NULL){
+      cur_ctr_report->ctr_time += MPI_Wtime()-st_ctr;
+      report_layers(ctrf);
+    }
     TAU_FSTOP(ctr_func);
     C->unfold(1);
   #ifndef SEQ
@@ -4651,7 +5736,10 @@ namespace CTF_int {
 
       //std::cout << alpha << ' ' << alignfact << ' ' << ocfact << std::endl;
 
-      if (new_ctr.unfold_broken_sym(NULL) != -1){
+      if (new_ctr.unfold_broken_sym(NULL) != -1 && new_ctr.can_sym_blocked()){
+        new_ctr.alpha = align_alpha;
+        stat = new_ctr.sym_blocked_contract();
+      } else if (new_ctr.unfold_broken_sym(NULL) != -1){
         if (global_comm.rank == 0)
           DPRINTF(2,"Contraction index is broken\n");
 
@@ -4919,6 +6007,18 @@ namespace CTF_int {
     if (was_home_B && A != B) new_ctr.B->unfold();
     if (was_home_C) new_ctr.C->unfold();
 
+#ifdef LAZY_HOME
+    if (was_home_C && !new_ctr.C->is_home){
+      if (C->wrld->rank == 0)
+        DPRINTF(2,"Leaving tensor %s away from home\n", C->name);
+      //count redistributions to home that are deferred or avoided
+      TAU_FSTART(avoided_redistribute_to_home);
+      C->leave_home_lazily(new_ctr.C);
+      TAU_FSTOP(avoided_redistribute_to_home);
+      new_ctr.C->is_data_aliased = 1;
+      delete new_ctr.C;
+    } else
+#endif
     if (was_home_C && !new_ctr.C->is_home){
       if (C->wrld->rank == 0)
         DPRINTF(2,"Migrating tensor %s back to home\n", C->name);
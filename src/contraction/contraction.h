@@ -106,6 +106,21 @@ namespace CTF_int {
 
       /** \brief run contraction */
       void execute();
+
+      /**
+       * \brief selects mapping for contraction and starts asynchronous
+       *        redistribution of A and B to it, so that it may overlap with
+       *        other work preceding execute(), C is left in its current mapping
+       */
+      void prefetch();
+
+      /**
+       * \brief runs the contraction only for the entries of C at which M is nonzero, or, if complement, at which M is zero,
+       *        the other entries of C are only scaled by beta
+       * \param[in] M nonsymmetric mask indexed like C, may be of a different algebraic structure than C
+       * \param[in] complement whether to compute the entries at which M is zero instead
+       */
+      void execute_masked(tensor * M, bool complement=false);
       
       /** \brief predicts execution time in seconds using performance models */
       double estimate_time();
@@ -122,6 +137,37 @@ namespace CTF_int {
        */
       bool is_sparse();
 
+      /**
+       * \brief returns true if C is dense and scaled by zero, so its prior data
+       *        need not be moved when C is mapped differently
+       */
+      bool overwrites_C();
+
+      /**
+       * \brief returns the contraction as a string for reports, e.g. C[ij]+=A[ik]*B[kj]
+       */
+      std::string get_report_term();
+
+      /**
+       * \brief records the chosen mapping and the predicted and measured times of the layers of ctrf
+       *        into the report of the contraction being executed
+       * \param[in] ctrf nested algorithm that was run
+       */
+      void report_layers(ctr * ctrf);
+
+      /**
+       * \brief returns true if OUT_OF_CORE is set and the contraction is dense, nonsymmetric,
+       *        without repeated indices and with distinct operands, so that it may be done in slabs
+       */
+      bool is_streamable();
+
+      /**
+       * \brief performs the contraction as a sequence of contractions of slabs of the operands along
+       *        the index carried by the most data, with slabs as wide as fit in memory, prefetching the
+       *        next slabs while contracting the current ones
+       */
+      int stream_contract();
+
       /**
        * \brief finds and return all contraction indices which can be folded into
        *    dgemm, for which they must (1) not break symmetry (2) belong to 
@@ -203,6 +249,34 @@ namespace CTF_int {
        */
       int unfold_broken_sym(contraction ** new_contraction);
 
+      /**
+       * \brief whether the only symmetry among the operands is a single index pair of A or B, so that sym_blocked_contract applies
+       */
+      bool can_sym_blocked();
+
+      /**
+       * \brief contracts an operand whose only symmetry is a single broken index pair directly from its packed triangle:
+       *        the pair is cut into blocks, diagonal blocks are unpacked one at a time and each off-diagonal block is
+       *        used once as it is and once transposed, so the full unpacked operand is never formed
+       * \return completion status
+       */
+      int sym_blocked_contract();
+
+      /**
+       * \brief whether A and B are dense and nonsymmetric, no tensor repeats an index, and every index of an operand is
+       *        in the output or in the other operand, so that sddmm applies
+       */
+      bool can_sddmm();
+
+      /**
+       * \brief computes the given entries of C as dot products of the blocks of A and B they touch, which are read once
+       *        per distinct assignment of the output indices of each operand, the work is proportional to nm
+       * \param[in] nm number of entries of C
+       * \param[in] mkeys global indices of the entries of C
+       * \param[in] cidx indices of the entries of C, C->order per entry
+       */
+      void sddmm(int64_t nm, int64_t * mkeys, int const * cidx);
+
       /**
        * \brief checks the edge lengths specfied for this contraction match
        *          throws error if not
@@ -270,13 +344,25 @@ namespace CTF_int {
 
       void get_best_exh_map(distribution const * dA, distribution const * dB, distribution const * dC, topology * old_topo_A, topology * old_topo_B, topology * old_topo_C, mapping const * old_map_A, mapping const * old_map_B, mapping const * old_map_C, int & idx, double & time, double init_best_time);
 
+      /**
+       * \brief finds the best 2.5D/3D mapping, in which the tensors are mapped onto all but one dimension l of a topology
+       *        and replicated along dimension l, whose c processors each perform 1/c of the steps of the 2D algorithm,
+       *        c is the length of dimension l and is only considered if c copies of the tensors fit in available memory
+       * \param[out] idx index of best mapping, 6*q+j for the qth (topology,dimension) pair and jth mapping order, or -1/INT_MAX if none
+       * \param[out] time estimated time of best mapping
+       */
+      void get_best_lyr_map(distribution const * dA, distribution const * dB, distribution const * dC, topology * old_topo_A, topology * old_topo_B, topology * old_topo_C, mapping const * old_map_A, mapping const * old_map_B, mapping const * old_map_C, int & idx, double & time);
+
       /**
        * \brief find best possible mapping for contraction and redistribute tensors to this mapping
        * \param[out] ctrf contraction class to run
        * \param[in] do_remap whether to redistribute tensors
+       * \param[in] prefetch if true, only start asynchronous redistribution of A and B,
+       *                     restoring the mapping of C and not constructing ctrf
+       * \param[out] est_time if not NULL, set to the estimated execution time of the selected mapping
        * \return SUCCESS if valid mapping found, ERROR if not enough memory or another issue
        */
-      int map(ctr ** ctrf, bool do_remap=1);
+      int map(ctr ** ctrf, bool do_remap=1, bool prefetch=0, double * est_time=NULL);
  
       /**
         * \brief contracts tensors alpha*A*B+beta*C -> C.
@@ -237,6 +237,16 @@ namespace CTF_int {
     aux_size = MAX(move_A*sr_A->el_size*s_A, MAX(move_B*sr_B->el_size*s_B, move_C*sr_C->el_size*s_C));
   }
 
+  /**
+   * \brief number of layers among which the edge_len steps of a level are divided, the remaining
+   *        nlyr/(returned value) layers are passed on to the recursive contraction
+   */
+  static int get_step_lyr(int64_t edge_len, int nlyr){
+    if (edge_len >= nlyr && edge_len % nlyr == 0) return nlyr;
+    if (edge_len < nlyr && nlyr % edge_len == 0) return edge_len;
+    return 1;
+  }
+
   double ctr_2d_general::est_time_fp(int nlyr) {
     int64_t b_A, b_B, b_C, s_A, s_B, s_C, aux_size;
     find_bsizes(b_A, b_B, b_C, s_A, s_B, s_C, aux_size);
@@ -247,11 +257,12 @@ namespace CTF_int {
       est_comm_time += cdt_B->estimate_bcast_time(sr_B->el_size*s_B);
     if (move_C)
       est_comm_time += cdt_C->estimate_red_time(sr_C->el_size*s_C, sr_C->addmop());
-    return (est_comm_time*(double)edge_len)/MIN(nlyr,edge_len);
+    return (est_comm_time*(double)edge_len)/get_step_lyr(edge_len, nlyr);
   }
 
   double ctr_2d_general::est_time_rec(int nlyr) {
-    return rec_ctr->est_time_rec(1)*(double)edge_len/MIN(nlyr,edge_len) + est_time_fp(nlyr);
+    int slyr = get_step_lyr(edge_len, nlyr);
+    return rec_ctr->est_time_rec(nlyr/slyr)*(double)edge_len/slyr + est_time_fp(nlyr);
   }
 
   int64_t ctr_2d_general::mem_fp() {
@@ -265,6 +276,7 @@ namespace CTF_int {
   }
 
   void ctr_2d_general::run(char * A, char * B, char * C){
+    double st_run = MPI_Wtime();
     int owner_A, owner_B, owner_C, ret;
     int64_t ib;
     char * buf_A, * buf_B, * buf_C; 
@@ -286,22 +298,10 @@ namespace CTF_int {
     rec_ctr->beta         = this->beta;
 
     int iidx_lyr, inum_lyr;
-    if (edge_len >= num_lyr && edge_len % num_lyr == 0){
-      inum_lyr         = num_lyr;
-      iidx_lyr         = idx_lyr;
-      rec_ctr->num_lyr = 1;
-      rec_ctr->idx_lyr = 0;
-    } else if (edge_len < num_lyr && num_lyr % edge_len == 0){
-      inum_lyr         = edge_len;
-      iidx_lyr         = idx_lyr%edge_len;
-      rec_ctr->num_lyr = num_lyr/edge_len;
-      rec_ctr->idx_lyr = idx_lyr/edge_len;
-    } else {
-      rec_ctr->num_lyr = num_lyr;
-      rec_ctr->idx_lyr = idx_lyr;
-      inum_lyr         = 1;
-      iidx_lyr         = 0;
-    }
+    inum_lyr         = get_step_lyr(edge_len, num_lyr);
+    iidx_lyr         = idx_lyr%inum_lyr;
+    rec_ctr->num_lyr = num_lyr/inum_lyr;
+    rec_ctr->idx_lyr = idx_lyr/inum_lyr;
 
     
     find_bsizes(b_A, b_B, b_C, s_A, s_B, s_C, aux_size);
@@ -459,6 +459,8 @@ namespace CTF_int {
       CTF_int::cdealloc(buf_B);
       CTF_int::cdealloc(buf_C);
     }
+    run_time += MPI_Wtime()-st_run;
+    nrun++;
     TAU_FSTOP(ctr_2d_general);
   }
 }
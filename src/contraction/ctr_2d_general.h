@@ -81,6 +81,8 @@ namespace CTF_int{
        *  where b is the smallest blocking factor among A and B or A and C or B and C. 
        */
       void run(char * A, char * B, char * C);
+      ctr * get_rec_ctr() { return rec_ctr; };
+      char const * get_name() { return "ctr_2d_general"; };
       /**
        * \brief returns the number of bytes of buffer space
        *  we need 
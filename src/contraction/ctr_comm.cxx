@@ -26,6 +26,8 @@ namespace CTF_int {
     beta    = c->beta;
     idx_lyr = 0;
     num_lyr = 1;
+    run_time = 0.0;
+    nrun = 0;
   }
 
   ctr::ctr(ctr * other){
@@ -35,6 +37,8 @@ namespace CTF_int {
     beta = other->beta;
     num_lyr = other->num_lyr;
     idx_lyr = other->idx_lyr;
+    run_time = 0.0;
+    nrun = 0;
   }
 
   ctr::~ctr(){
@@ -61,23 +65,23 @@ namespace CTF_int {
       if (phys_mapped[3*i+0] == 0 &&
           phys_mapped[3*i+1] == 0 &&
           phys_mapped[3*i+2] == 0){
-  /*      printf("ERROR: ALL-TENSOR REPLICATION NO LONGER DONE\n");
-        ABORT;
-        ASSERT(this->num_lyr == 1);
-        hctr->idx_lyr = A->topo->dim_comm[i].rank;
-        hctr->num_lyr = A->topo->dim_comm[i]->np;
-        this->idx_lyr = A->topo->dim_comm[i].rank;
-        this->num_lyr = A->topo->dim_comm[i]->np;*/
-      } else {
-        if (phys_mapped[3*i+0] == 0){
-          this->ncdt_A++;
-        }
-        if (phys_mapped[3*i+1] == 0){
-          this->ncdt_B++;
-        }
-        if (phys_mapped[3*i+2] == 0){
-          this->ncdt_C++;
-        }
+        /* a dimension none of the tensors is mapped to is a set of layers (2.5D), each layer performs
+           a share of the steps of the nested ctr_2d_general levels on broadcast copies of A and B,
+           then the partial sums of C are reduced across the layers. Without an additive identity
+           to start the partial sums from, or with a custom function, which may transform C in place
+           rather than accumulate into it, no layers are formed and the dimension is ignored */
+        if (c->C->sr->addid() == NULL || c->is_custom) continue;
+        this->idx_lyr += this->num_lyr*c->A->topo->dim_comm[i].rank;
+        this->num_lyr *= c->A->topo->dim_comm[i].np;
+      }
+      if (phys_mapped[3*i+0] == 0){
+        this->ncdt_A++;
+      }
+      if (phys_mapped[3*i+1] == 0){
+        this->ncdt_B++;
+      }
+      if (phys_mapped[3*i+2] == 0){
+        this->ncdt_C++;
       }
     }
     if (this->ncdt_A > 0)
@@ -90,27 +94,27 @@ namespace CTF_int {
     this->ncdt_B = 0;
     this->ncdt_C = 0;
     for (i=0; i<nphys_dim; i++){
-      if (!(phys_mapped[3*i+0] == 0 &&
+      if (phys_mapped[3*i+0] == 0 &&
           phys_mapped[3*i+1] == 0 &&
-          phys_mapped[3*i+2] == 0)){
-        if (phys_mapped[3*i+0] == 0){
-          this->cdt_A[this->ncdt_A] = &c->A->topo->dim_comm[i];
-        /*    if (is_used && this->cdt_A[this->ncdt_A].alive == 0)
-            this->cdt_A[this->ncdt_A].activate(global_comm.cm);*/
-          this->ncdt_A++;
-        }
-        if (phys_mapped[3*i+1] == 0){
-          this->cdt_B[this->ncdt_B] = &c->B->topo->dim_comm[i];
-  /*        if (is_used && this->cdt_B[this->ncdt_B].alive == 0)
-            this->cdt_B[this->ncdt_B].activate(global_comm.cm);*/
-          this->ncdt_B++;
-        }
-        if (phys_mapped[3*i+2] == 0){
-          this->cdt_C[this->ncdt_C] = &c->C->topo->dim_comm[i];
-  /*        if (is_used && this->cdt_C[this->ncdt_C].alive == 0)
-            this->cdt_C[this->ncdt_C].activate(global_comm.cm);*/
-          this->ncdt_C++;
-        }
+          phys_mapped[3*i+2] == 0 &&
+          (c->C->sr->addid() == NULL || c->is_custom)) continue;
+      if (phys_mapped[3*i+0] == 0){
+        this->cdt_A[this->ncdt_A] = &c->A->topo->dim_comm[i];
+      /*    if (is_used && this->cdt_A[this->ncdt_A].alive == 0)
+          this->cdt_A[this->ncdt_A].activate(global_comm.cm);*/
+        this->ncdt_A++;
+      }
+      if (phys_mapped[3*i+1] == 0){
+        this->cdt_B[this->ncdt_B] = &c->B->topo->dim_comm[i];
+/*        if (is_used && this->cdt_B[this->ncdt_B].alive == 0)
+          this->cdt_B[this->ncdt_B].activate(global_comm.cm);*/
+        this->ncdt_B++;
+      }
+      if (phys_mapped[3*i+2] == 0){
+        this->cdt_C[this->ncdt_C] = &c->C->topo->dim_comm[i];
+/*        if (is_used && this->cdt_C[this->ncdt_C].alive == 0)
+          this->cdt_C[this->ncdt_C].activate(global_comm.cm);*/
+        this->ncdt_C++;
       }
     }
   }
@@ -203,6 +207,7 @@ namespace CTF_int {
 
 
   void ctr_replicate::run(char * A, char * B, char * C){
+    double st_run = MPI_Wtime();
     int arank, brank, crank, i;
 
     arank = 0, brank = 0, crank = 0;
@@ -234,9 +239,12 @@ namespace CTF_int {
     }
 //
     //sr_C->set(C, sr_C->addid(), size_C);
-    if (crank != 0)
+    if (crank != 0){
       rec_ctr->beta = sr_C->addid();
-    else
+      // blocks of C whose steps are performed by other layers are not written by rec_ctr
+      if (this->num_lyr > 1)
+        this->sr_C->set(C, this->sr_C->addid(), size_C);
+    } else
       rec_ctr->beta = sr_C->mulid(); 
 
     rec_ctr->num_lyr      = this->num_lyr;
@@ -261,5 +269,7 @@ namespace CTF_int {
     if (brank != 0 && this->sr_B->addid() != NULL){
       this->sr_B->set(B, this->sr_B->addid(), size_B);
     }
+    run_time += MPI_Wtime()-st_run;
+    nrun++;
   }
 }
@@ -170,9 +170,19 @@ namespace CTF_int{
       char const * beta;
       int num_lyr; /* number of copies of this matrix being computed on */
       int idx_lyr; /* the index of this copy */
+      double run_time; /* time spent in run, including the layers below, summed over calls */
+      int64_t nrun; /* number of calls to run */
 
       virtual void run(char * A, char * B, char * C) { printf("SHOULD NOTR\n"); };
       virtual void print() { };
+      /**
+       * \brief returns the layer below this one, NULL for local kernels
+       */
+      virtual ctr * get_rec_ctr() { return NULL; };
+      /**
+       * \brief returns the name of the type of this layer
+       */
+      virtual char const * get_name() { return "ctr"; };
       virtual int64_t mem_fp() { return 0; };
       virtual int64_t mem_rec() { return mem_fp(); };
       virtual double est_time_fp(int nlyr) { return 0; };
@@ -211,6 +221,8 @@ namespace CTF_int{
       ctr * rec_ctr;
       
       void run(char * A, char * B, char * C);
+      ctr * get_rec_ctr() { return rec_ctr; };
+      char const * get_name() { return "ctr_replicate"; };
       /**
        * \brief returns the number of bytes of buffer space
        *  we need 
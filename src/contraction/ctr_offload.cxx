@@ -83,6 +83,7 @@ namespace CTF_int {
   }
 
   void ctr_offload::run(char * A, char * B, char * C){
+    double st_run = MPI_Wtime();
     TAU_FSTART(ctr_offload);
     ASSERT(iter_counter < total_iter);
     if (iter_counter == 0){
@@ -144,6 +145,8 @@ namespace CTF_int {
       iter_counter = 0;
     }
     TAU_FSTOP(ctr_offload);
+    run_time += MPI_Wtime()-st_run;
+    nrun++;
   }
 }
 #endif
@@ -33,6 +33,8 @@ namespace CTF_int {
        * \brief offloads and downloads local blocks of dense tensors
        */
       void run(char * A, char * B, char * C);
+      ctr * get_rec_ctr() { return rec_ctr; };
+      char const * get_name() { return "ctr_offload"; };
 
       /**
        * \brief returns the number of bytes of buffer space
@@ -99,6 +99,7 @@ namespace CTF_int {
 
 
   void ctr_virt::run(char * A, char * B, char * C){
+    double st_run = MPI_Wtime();
     TAU_FSTART(ctr_virt);
     int * idx_arr, * tidx_arr, * lda_A, * lda_B, * lda_C, * beta_arr;
     int * ilda_A, * ilda_B, * ilda_C;
@@ -221,6 +222,8 @@ namespace CTF_int {
     }
     CTF_int::cdealloc(beta_arr);
     TAU_FSTOP(ctr_virt);
+    run_time += MPI_Wtime()-st_run;
+    nrun++;
   }
 
 
@@ -462,7 +465,19 @@ namespace CTF_int {
   }
 
   void seq_tsr_ctr::run(char * A, char * B, char * C){
-    ASSERT(idx_lyr == 0 && num_lyr == 1);
+    double st_run = MPI_Wtime();
+    if (idx_lyr != 0){
+      // the block is computed by the first of the layers left over by the ctr_2d_general levels above, the others contribute zeros
+      int64_t sz_C = sy_packed_size(order_C, edge_len_C, sym_C);
+      if (is_inner) sz_C *= inner_params.m*inner_params.n;
+      if (this->beta == NULL || sr_C->isequal(this->beta, sr_C->addid()))
+        sr_C->set(C, sr_C->addid(), sz_C);
+      else if (!sr_C->isequal(this->beta, sr_C->mulid()))
+        sr_C->scal(sz_C, this->beta, C, 1);
+      run_time += MPI_Wtime()-st_run;
+      nrun++;
+      return;
+    }
 
 #ifdef TUNE
     // Check if we need to execute this function for the sake of training
@@ -587,6 +602,8 @@ namespace CTF_int {
       double tps[] = {exe_time, 1.0, (double)est_membw(), est_fp()};
       seq_tsr_ctr_mdl_ref.observe(tps);
     }
+    run_time += MPI_Wtime()-st_run;
+    nrun++;
   }
 
   void inv_idx(int                order_A,
@@ -27,6 +27,8 @@ namespace CTF_int {
        * \brief iterates over the dense virtualization block grid and contracts
        */
       void run(char * A, char * B, char * C);
+      ctr * get_rec_ctr() { return rec_ctr; };
+      char const * get_name() { return "ctr_virt"; };
       int64_t mem_fp();
       int64_t mem_rec();
 
@@ -82,6 +84,8 @@ namespace CTF_int {
     char tB;
     char tC;
     bool offload;
+    /** \brief whether the sparse A is stored in CSF rather than CSR/COO layout */
+    bool csf;
   };
 
   class seq_tsr_ctr : public ctr {
@@ -111,6 +115,7 @@ namespace CTF_int {
        * \brief wraps user sequential function signature
        */
       void run(char * A, char * B, char * C);
+      char const * get_name() { return "seq_tsr_ctr"; };
       void print();
       int64_t mem_fp();
       double est_fp();
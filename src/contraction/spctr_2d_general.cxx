@@ -3,6 +3,7 @@
 #include "spctr_2d_general.h"
 #include "../tensor/untyped_tensor.h"
 #include "../mapping/mapping.h"
+#include "../redistribution/pair_cmp.h"
 #include "../shared/util.h"
 #include <climits>
 
@@ -28,6 +29,8 @@ namespace CTF_int {
     ctr_sub_lda_B = o->ctr_sub_lda_B;
     cdt_B         = o->cdt_B;
     move_B        = o->move_B;
+    is_pairs_A    = o->is_pairs_A;
+    is_pairs_B    = o->is_pairs_B;
     ctr_lda_C     = o->ctr_lda_C;
     ctr_sub_lda_C = o->ctr_sub_lda_C;
     cdt_C         = o->cdt_C;
@@ -135,7 +138,7 @@ namespace CTF_int {
     return rec_ctr->spmem_rec(nnz_frac_A, nnz_frac_B, nnz_frac_C) + spmem_fp(nnz_frac_A, nnz_frac_B, nnz_frac_C);
   }
 
-  char * bcast_step(int edge_len, char * A, bool is_sparse_A, bool move_A, algstrct const * sr_A, int64_t b_A, int64_t s_A, char * buf_A, CommData * cdt_A, int64_t ctr_sub_lda_A, int64_t ctr_lda_A, int nblk_A, int64_t const * size_blk_A, int & new_nblk_A, int64_t *& new_size_blk_A, int64_t * offsets_A, int ib){
+  char * bcast_step(int edge_len, char * A, bool is_sparse_A, bool is_pairs_A, bool move_A, algstrct const * sr_A, int64_t b_A, int64_t s_A, char * buf_A, CommData * cdt_A, int64_t ctr_sub_lda_A, int64_t ctr_lda_A, int nblk_A, int64_t const * size_blk_A, int & new_nblk_A, int64_t *& new_size_blk_A, int64_t * offsets_A, int ib){
     int ret;
     char * op_A = NULL;
     new_size_blk_A = (int64_t*)size_blk_A;
@@ -177,16 +180,40 @@ namespace CTF_int {
           op_A = buf_A;
       }
       if (is_sparse_A){
-        cdt_A->bcast(new_size_blk_A, new_nblk_A, MPI_INT64_T, owner_A);
+        // the block sizes are followed by the size of the pairs in wire format, or 0 if they are sent as they are
+        int64_t bc_sizes_A[new_nblk_A+1];
         int64_t bc_size_A = 0;
-        for (int z=0; z<new_nblk_A; z++) bc_size_A += new_size_blk_A[z];
-
-        if (cdt_A->rank != owner_A){ 
+        if (cdt_A->rank == owner_A){
+          memcpy(bc_sizes_A, new_size_blk_A, sizeof(int64_t)*new_nblk_A);
+          for (int z=0; z<new_nblk_A; z++) bc_size_A += new_size_blk_A[z];
+          bc_sizes_A[new_nblk_A] = 0;
+          if (is_pairs_A){
+            int64_t cmp_size_A = get_cmp_pairs_size(bc_size_A/sr_A->pair_size(), op_A, sr_A);
+            if (cmp_pairs_pays(cdt_A->estimate_bcast_time(bc_size_A)-cdt_A->estimate_bcast_time(cmp_size_A), bc_size_A, cmp_size_A))
+              bc_sizes_A[new_nblk_A] = cmp_size_A;
+          }
+        }
+        cdt_A->bcast(bc_sizes_A, new_nblk_A+1, MPI_INT64_T, owner_A);
+        if (cdt_A->rank != owner_A){
+          memcpy(new_size_blk_A, bc_sizes_A, sizeof(int64_t)*new_nblk_A);
+          for (int z=0; z<new_nblk_A; z++) bc_size_A += new_size_blk_A[z];
           ret = CTF_int::mst_alloc_ptr(bc_size_A, (void**)&buf_A);
           ASSERT(ret==0);
           op_A = buf_A;
         }
-        cdt_A->bcast(op_A, bc_size_A, MPI_CHAR, owner_A);
+        int64_t cmp_size_A = bc_sizes_A[new_nblk_A];
+        if (cmp_size_A > 0){
+          char * cmp_A;
+          ret = CTF_int::mst_alloc_ptr(cmp_size_A, (void**)&cmp_A);
+          ASSERT(ret==0);
+          if (cdt_A->rank == owner_A)
+            cmp_pairs(bc_size_A/sr_A->pair_size(), op_A, sr_A, cmp_A);
+          cdt_A->bcast(cmp_A, cmp_size_A, MPI_CHAR, owner_A);
+          if (cdt_A->rank != owner_A)
+            decmp_pairs(bc_size_A/sr_A->pair_size(), cmp_A, sr_A, op_A);
+          cdealloc(cmp_A);
+        } else
+          cdt_A->bcast(op_A, bc_size_A, MPI_CHAR, owner_A);
         /*int rrank;
         MPI_Comm_rank(MPI_COMM_WORLD, &rrank);
         printf("rrank = %d new_nblk_A = %d rank = %d owner = %d new_nnz_A = %ld old_nnz_A = %ld\n",rrank,new_nblk_A,cdt_A->rank, owner_A, new_nnz_A, nnz_A);
@@ -366,6 +393,7 @@ new_nblk_C = nblk_C/edge_len;
                              char * B, int nblk_B, int64_t const * size_blk_B,
                              char * C, int nblk_C, int64_t * size_blk_C,
                              char *& new_C){
+    double st_run = MPI_Wtime();
     int ret, n_new_C_grps;
     int64_t ib;
     char * buf_A, * buf_B, * buf_C, * buf_aux, * up_C;
@@ -480,8 +508,8 @@ new_nblk_C = nblk_C/edge_len;
     new_C = C;
 
     for (ib=iidx_lyr; ib<edge_len; ib+=inum_lyr){
-      op_A = bcast_step(edge_len, A, is_sparse_A, move_A, sr_A, b_A, s_A, buf_A, cdt_A, ctr_sub_lda_A, ctr_lda_A, nblk_A, size_blk_A, new_nblk_A, new_size_blk_A, offsets_A, ib);
-      op_B = bcast_step(edge_len, B, is_sparse_B, move_B, sr_B, b_B, s_B, buf_B, cdt_B, ctr_sub_lda_B, ctr_lda_B, nblk_B, size_blk_B, new_nblk_B, new_size_blk_B, offsets_B, ib);
+      op_A = bcast_step(edge_len, A, is_sparse_A, is_pairs_A, move_A, sr_A, b_A, s_A, buf_A, cdt_A, ctr_sub_lda_A, ctr_lda_A, nblk_A, size_blk_A, new_nblk_A, new_size_blk_A, offsets_A, ib);
+      op_B = bcast_step(edge_len, B, is_sparse_B, is_pairs_B, move_B, sr_B, b_B, s_B, buf_B, cdt_B, ctr_sub_lda_B, ctr_lda_B, nblk_B, size_blk_B, new_nblk_B, new_size_blk_B, offsets_B, ib);
       op_C = reduce_step_pre(edge_len, new_C, is_sparse_C, move_C, sr_C, b_C, s_C, buf_C, cdt_C, ctr_sub_lda_C, ctr_lda_C, nblk_C, size_blk_C, new_nblk_C, new_size_blk_C, offsets_C, ib, rec_ctr->beta);
 
 
@@ -591,6 +619,8 @@ new_nblk_C = nblk_C/edge_len;
     } else {
       new_C = C;
     }
+    run_time += MPI_Wtime()-st_run;
+    nrun++;
     TAU_FSTOP(spctr_2d_general);
   }
 }
@@ -68,6 +68,10 @@ namespace CTF_int{
       bool move_B;
       bool move_C;
 
+      /* whether the sparse blocks of A/B are key-value pairs (not folded), whose keys may be delta-encoded when broadcast */
+      bool is_pairs_A;
+      bool is_pairs_B;
+
       CommData * cdt_A;
       CommData * cdt_B;
       CommData * cdt_C;
@@ -87,6 +91,8 @@ namespace CTF_int{
                char * B, int nblk_B, int64_t const * size_blk_B,
                char * C, int nblk_C, int64_t * size_blk_C,
                char *& new_C);
+      ctr * get_rec_ctr() { return rec_ctr; };
+      char const * get_name() { return "spctr_2d_general"; };
 
       /**
        * \brief returns the number of bytes of buffer space
@@ -147,7 +153,7 @@ namespace CTF_int{
        * \brief partial constructor, most of the logic is in the spctr_2d_gen_build function
        * \param[in] c contraction object to get info about spctr from
        */
-      spctr_2d_general(contraction * c) : spctr(c){ move_A=0; move_B=0; move_C=0; }
+      spctr_2d_general(contraction * c) : spctr(c){ move_A=0; move_B=0; move_C=0; is_pairs_A=0; is_pairs_B=0; }
   };
 }
 
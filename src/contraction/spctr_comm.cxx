@@ -187,6 +187,7 @@ namespace CTF_int {
                             char * B, int nblk_B, int64_t const * size_blk_B,
                             char * C, int nblk_C, int64_t * size_blk_C,
                             char *& new_C){
+    double st_run = MPI_Wtime();
     int arank, brank, crank, i;
     TAU_FSTART(spctr_replicate);
     arank = 0, brank = 0, crank = 0;
@@ -318,6 +319,8 @@ namespace CTF_int {
     if (!is_sparse_B && brank != 0){
       this->sr_B->set(B, this->sr_B->addid(), size_B);
     }
+    run_time += MPI_Wtime()-st_run;
+    nrun++;
     TAU_FSTOP(spctr_replicate);
   }
 }
@@ -31,6 +31,8 @@ namespace CTF_int{
                char * B, int nblk_B, int64_t const * size_blk_B,
                char * C, int nblk_C, int64_t * size_blk_C,
                char *& new_C);
+      ctr * get_rec_ctr() { return rec_ctr; };
+      char const * get_name() { return "spctr_replicate"; };
       /**
        * \brief returns the number of bytes of buffer space
        *  we need 
@@ -89,6 +89,7 @@ namespace CTF_int {
                           char * B, int nblk_B, int64_t const * size_blk_B,
                           char * C, int nblk_C, int64_t * size_blk_C,
                           char *& new_C){
+    double st_run = MPI_Wtime();
     TAU_FSTART(spctr_offload);
     ASSERT(iter_counter < total_iter);
     if (iter_counter % upload_phase_A == 0){
@@ -195,6 +196,8 @@ namespace CTF_int {
       delete spr_C;
       iter_counter = 0;
     }
+    run_time += MPI_Wtime()-st_run;
+    nrun++;
     TAU_FSTOP(spctr_offload);
   }
 }
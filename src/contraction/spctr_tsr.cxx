@@ -7,6 +7,7 @@
 #include "contraction.h"
 #include "../sparse_formats/coo.h"
 #include "../sparse_formats/csr.h"
+#include "../sparse_formats/csf.h"
 #include "../tensor/untyped_tensor.h"
 
 namespace CTF_int {
@@ -247,6 +248,7 @@ namespace CTF_int {
   LinModel<3> seq_tsr_spctr_k2(seq_tsr_spctr_k2_init,"seq_tsr_spctr_k2");
   LinModel<3> seq_tsr_spctr_k3(seq_tsr_spctr_k3_init,"seq_tsr_spctr_k3");
   LinModel<3> seq_tsr_spctr_k4(seq_tsr_spctr_k4_init,"seq_tsr_spctr_k4");
+  LinModel<3> seq_tsr_spctr_k5(seq_tsr_spctr_k5_init,"seq_tsr_spctr_k5");
 
   double seq_tsr_spctr::est_time_fp(int nlyr, double nnz_frac_A, double nnz_frac_B, double nnz_frac_C){
 //    return COST_MEMBW*(size_A+size_B+size_C)+COST_FLOP*flops;
@@ -305,6 +307,9 @@ namespace CTF_int {
           return seq_tsr_spctr_k4.est_time(ps);
         }
         break;
+      case 5:
+        return seq_tsr_spctr_k5.est_time(ps);
+        break;
     }
     assert(0); //wont make it here
     return 0.0;
@@ -318,6 +323,7 @@ namespace CTF_int {
                           char * B, int nblk_B, int64_t const * size_blk_B,
                           char * C, int nblk_C, int64_t * size_blk_C,
                           char *& new_C){
+    double st_run = MPI_Wtime();
 
    // not-quite-sure
 
@@ -326,9 +332,7 @@ namespace CTF_int {
     ASSERT(nblk_B == 1);
     ASSERT(nblk_C == 1);
 
-#ifdef TUNE
     double st_time = MPI_Wtime();
-#endif
 
     if (krnl_type > 0){
       if (!sr_C->isequal(beta,sr_C->mulid())){
@@ -419,6 +423,9 @@ namespace CTF_int {
           bsr = seq_tsr_spctr_k4.should_observe(tps_);
         }
         break;
+      case 5:
+        bsr = seq_tsr_spctr_k5.should_observe(tps_);
+        break;
     }
 
     if(!bsr){
@@ -500,8 +507,21 @@ namespace CTF_int {
         TAU_FSTOP(CSRMULTCSR);
       }
       break;
+
+      case 5:
+      {
+        // Do mm by walking the fibers of A in CSF format
+        TAU_FSTART(CSFMM);
+        CSF_Matrix::csfmm(A, sr_A, inner_params.m, inner_params.n, inner_params.k,
+                          alpha, B, sr_B, sr_C->mulid(), C, sr_C, func);
+        TAU_FSTOP(CSFMM);
+      }
+      break;
     }
-#ifdef TUNE
+    // observed in all builds, outside of TUNE the models keep the observation only while learning at runtime
+#ifndef TUNE
+    double nnz_frac_A, nnz_frac_B, nnz_frac_C;
+#endif
     nnz_frac_A = 1.0;
     nnz_frac_B = 1.0;
     nnz_frac_C = 1.0;
@@ -576,9 +596,12 @@ namespace CTF_int {
           seq_tsr_spctr_k4.observe(tps);
         }
         break;
+      case 5:
+        seq_tsr_spctr_k5.observe(tps);
+        break;
     }
-
-#endif
+    run_time += MPI_Wtime()-st_run;
+    nrun++;
   }
 
 
@@ -668,6 +691,7 @@ namespace CTF_int {
                        char * B, int nblk_B, int64_t const * size_blk_B,
                        char * C, int nblk_C, int64_t * size_blk_C,
                        char *& new_C){
+    double st_run = MPI_Wtime();
     TAU_FSTART(spctr_virt);
     int * idx_arr, * tidx_arr, * lda_A, * lda_B, * lda_C, * beta_arr;
     int * ilda_A, * ilda_B, * ilda_C;
@@ -863,6 +887,8 @@ namespace CTF_int {
       CTF_int::cdealloc(idx_arr);
     }
     CTF_int::cdealloc(beta_arr);
+    run_time += MPI_Wtime()-st_run;
+    nrun++;
     TAU_FSTOP(spctr_virt);
   }
 
@@ -993,6 +1019,7 @@ namespace CTF_int {
                            char * B, int nblk_B, int64_t const * size_blk_B,
                            char * C, int nblk_C, int64_t * size_blk_C,
                            char *& new_C){
+    double st_run = MPI_Wtime();
     TAU_FSTART(spctr_pin_keys);
     char * X = NULL;
     algstrct const * sr = NULL;
@@ -1081,6 +1108,8 @@ namespace CTF_int {
         pin_keys_mdl.observe(tps);
         break;
     }
+    run_time += MPI_Wtime()-st_run;
+    nrun++;
     TAU_FSTOP(spctr_pin_keys);
   }
 }
@@ -85,6 +85,7 @@ namespace CTF_int{
                char * B, int nblk_B, int64_t const * size_blk_B,
                char * C, int nblk_C, int64_t * size_blk_C,
                char *& new_C);
+      char const * get_name() { return "seq_tsr_spctr"; };
       void print();
       int64_t spmem_fp();
       spctr * clone();
@@ -138,6 +139,8 @@ namespace CTF_int{
                char * B, int nblk_B, int64_t const * size_blk_B,
                char * C, int nblk_C, int64_t * size_blk_C,
                char *& new_C);
+      ctr * get_rec_ctr() { return rec_ctr; };
+      char const * get_name() { return "spctr_virt"; };
       int64_t spmem_fp();
       int64_t spmem_rec(double nnz_frac_A, double nnz_frac_B, double nnz_frac_C);
 
@@ -176,6 +179,8 @@ namespace CTF_int{
                char * B, int nblk_B, int64_t const * size_blk_B,
                char * C, int nblk_C, int64_t * size_blk_C,
                char *& new_C);
+      ctr * get_rec_ctr() { return rec_ctr; };
+      char const * get_name() { return "spctr_pin_keys"; };
       void print();
       int64_t spmem_fp(double nnz_frac_A, double nnz_frac_B, double nnz_frac_C);
       int64_t spmem_rec(double nnz_frac_A, double nnz_frac_B, double nnz_frac_C);
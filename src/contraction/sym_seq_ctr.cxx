@@ -8,6 +8,29 @@
 
 namespace CTF_int{
   
+  /**
+   * \brief determines whether the innermost loop index moves an operand by a constant stride
+   * \param[in] r position of the index in the operand, -1 if it does not appear
+   * \param[in] sym symmetry of the operand
+   * \param[in] offsets byte offsets of the operand along the index, starting at the first iteration
+   * \param[in] el_size element size in bytes
+   * \param[out] inc stride in elements
+   * \return false if the index is the last of a packed symmetric group
+   */
+  static bool leaf_stride(int              r,
+                          int const *      sym,
+                          uint64_t const * offsets,
+                          int              el_size,
+                          int64_t &        inc){
+    if (r == -1){
+      inc = 0;
+      return true;
+    }
+    if (r > 0 && sym[r-1] != NS) return false;
+    inc = (int64_t)(offsets[1]-offsets[0])/el_size;
+    return true;
+  }
+
   template <int idim>
   void sym_seq_ctr_loop(char const *     alpha,
                         char const *     A,
@@ -35,7 +58,8 @@ namespace CTF_int{
                         bivar_function const * func,
                         int const *      idx,
                         int const *      rev_idx_map,
-                        int              idx_max){
+                        int              idx_max,
+                        int              par_idim){
     int imax=0;
     int rA = rev_idx_map[3*idim+0];
     int rB = rev_idx_map[3*idim+1];
@@ -104,29 +128,19 @@ namespace CTF_int{
       } while (rrC>0 && sym_C[rrC-1] != NS && idx_map_C[rrC] < idim);
     }
 
-    if (rC != -1){
-#ifdef USE_OMP    
-      #pragma omp for
-#endif
-      for (int i=imin; i<imax; i++){
-#ifdef USE_OMP    
-        #pragma omp parallel 
+    // threads split the outermost index of C cyclically, so each owns a disjoint part of C and triangular ranges stay balanced
+    int tid = 0, ntd = 1;
+#ifdef USE_OMP
+    if (idim == par_idim){
+      tid = omp_get_thread_num();
+      ntd = omp_get_num_threads();
+    }
 #endif
-        {
-          int nidx[idx_max];
-          memcpy(nidx, idx, idx_max*sizeof(int));
-          nidx[idim] = i;
-          sym_seq_ctr_loop<idim-1>(alpha, A+offsets_A[idim][nidx[idim]], sr_A, order_A, edge_len_A, sym_A, idx_map_A, offsets_A, B+offsets_B[idim][nidx[idim]], sr_B, order_B, edge_len_B, sym_B, idx_map_B, offsets_B, beta, C+offsets_C[idim][nidx[idim]], sr_C, order_C, edge_len_C, sym_C, idx_map_C, offsets_C, func, nidx, rev_idx_map, idx_max);
-        }
-      }
-    } else {
-      for (int i=imin; i<imax; i++){
-        int nidx[idx_max];
-        memcpy(nidx, idx, idx_max*sizeof(int));
-        nidx[idim] = i;
-        sym_seq_ctr_loop<idim-1>(alpha, A+offsets_A[idim][nidx[idim]], sr_A, order_A, edge_len_A, sym_A, idx_map_A, offsets_A, B+offsets_B[idim][nidx[idim]], sr_B, order_B, edge_len_B, sym_B, idx_map_B, offsets_B, beta, C+offsets_C[idim][nidx[idim]], sr_C, order_C, edge_len_C, sym_C, idx_map_C, offsets_C, func, nidx, rev_idx_map, idx_max);
-      }
-
+    for (int i=imin+tid; i<imax; i+=ntd){
+      int nidx[idx_max];
+      memcpy(nidx, idx, idx_max*sizeof(int));
+      nidx[idim] = i;
+      sym_seq_ctr_loop<idim-1>(alpha, A+offsets_A[idim][nidx[idim]], sr_A, order_A, edge_len_A, sym_A, idx_map_A, offsets_A, B+offsets_B[idim][nidx[idim]], sr_B, order_B, edge_len_B, sym_B, idx_map_B, offsets_B, beta, C+offsets_C[idim][nidx[idim]], sr_C, order_C, edge_len_C, sym_C, idx_map_C, offsets_C, func, nidx, rev_idx_map, idx_max, par_idim);
     }
 //    idx[idim] = 0;
   }
@@ -160,7 +174,8 @@ namespace CTF_int{
                         bivar_function const * func,
                         int const *      idx,
                         int const *      rev_idx_map,
-                        int              idx_max){
+                        int              idx_max,
+                        int              par_idim){
     int imax=0;
     int rA = rev_idx_map[0];
     int rB = rev_idx_map[1];
@@ -203,7 +218,19 @@ namespace CTF_int{
         }
         CTF_FLOPS_ADD(imax-imin);
       } else*/ 
-      if (alpha == NULL || sr_C->isequal(alpha,sr_C->mulid())){
+      int64_t inc_A, inc_B, inc_C;
+      if (imax-imin > 1 &&
+          leaf_stride(rA, sym_A, offsets_A[0]+imin, sr_C->el_size, inc_A) &&
+          leaf_stride(rB, sym_B, offsets_B[0]+imin, sr_C->el_size, inc_B) &&
+          leaf_stride(rC, sym_C, offsets_C[0]+imin, sr_C->el_size, inc_C)){
+        // the innermost index advances each packed operand by a fixed stride, so the typed kernel can vectorize
+        char const * a = (alpha == NULL || sr_C->isequal(alpha,sr_C->mulid())) ? NULL : alpha;
+        sr_C->mul_acc(imax-imin, a,
+                      A+offsets_A[0][imin], inc_A,
+                      B+offsets_B[0][imin], inc_B,
+                      C+offsets_C[0][imin], inc_C);
+        CTF_FLOPS_ADD((a == NULL ? 2 : 3)*(imax-imin));
+      } else if (alpha == NULL || sr_C->isequal(alpha,sr_C->mulid())){
         for (int i=imin; i<imax; i++){
           char tmp[sr_C->el_size];
           sr_C->mul(A+offsets_A[0][i], 
@@ -295,7 +322,8 @@ namespace CTF_int{
                         bivar_function const * func,
                         int const *      idx,
                         int const *      rev_idx_map,
-                        int              idx_max);
+                        int              idx_max,
+                        int              par_idim);
 
 
   void compute_syoff(int              r,
@@ -462,6 +490,10 @@ namespace CTF_int{
 
       //if we have something to parallelize without needing to replicate C
       if (order_C > 1 || (order_C > 0 && idx_map_C[0] != 0)){
+        int par_idim = 0;
+        for (int l=0; l<order_C; l++){
+          par_idim = std::max(par_idim, idx_map_C[l]);
+        }
 #ifdef USE_OMP    
         #pragma omp parallel
 #endif
@@ -469,7 +501,7 @@ namespace CTF_int{
           int * idx_glb = (int*)CTF_int::alloc(sizeof(int)*idx_max);
           memset(idx_glb, 0, sizeof(int)*idx_max);
 
-          SWITCH_ORD_CALL(sym_seq_ctr_loop, idx_max-1, alpha, A, sr_A, order_A, edge_len_A, sym_A, idx_map_A, offsets_A, B, sr_B, order_B, edge_len_B, sym_B, idx_map_B, offsets_B, beta, C, sr_C, order_C, edge_len_C, sym_C, idx_map_C, offsets_C, NULL, idx_glb, rev_idx_map, idx_max);
+          SWITCH_ORD_CALL(sym_seq_ctr_loop, idx_max-1, alpha, A, sr_A, order_A, edge_len_A, sym_A, idx_map_A, offsets_A, B, sr_B, order_B, edge_len_B, sym_B, idx_map_B, offsets_B, beta, C, sr_C, order_C, edge_len_C, sym_C, idx_map_C, offsets_C, NULL, idx_glb, rev_idx_map, idx_max, par_idim);
           cdealloc(idx_glb);
         }
       } else {
@@ -477,7 +509,7 @@ namespace CTF_int{
           int * idx_glb = (int*)CTF_int::alloc(sizeof(int)*idx_max);
           memset(idx_glb, 0, sizeof(int)*idx_max);
 
-          SWITCH_ORD_CALL(sym_seq_ctr_loop, idx_max-1, alpha, A, sr_A, order_A, edge_len_A, sym_A, idx_map_A, offsets_A, B, sr_B, order_B, edge_len_B, sym_B, idx_map_B, offsets_B, beta, C, sr_C, order_C, edge_len_C, sym_C, idx_map_C, offsets_C, NULL, idx_glb, rev_idx_map, idx_max);
+          SWITCH_ORD_CALL(sym_seq_ctr_loop, idx_max-1, alpha, A, sr_A, order_A, edge_len_A, sym_A, idx_map_A, offsets_A, B, sr_B, order_B, edge_len_B, sym_B, idx_map_B, offsets_B, beta, C, sr_C, order_C, edge_len_C, sym_C, idx_map_C, offsets_C, NULL, idx_glb, rev_idx_map, idx_max, -1);
           cdealloc(idx_glb);
         }
       }
@@ -647,6 +679,10 @@ namespace CTF_int{
 
       //if we have something to parallelize without needing to replicate C
       if (order_C > 1 || (order_C > 0 && idx_map_C[0] != 0)){
+        int par_idim = 0;
+        for (int l=0; l<order_C; l++){
+          par_idim = std::max(par_idim, idx_map_C[l]);
+        }
 #ifdef USE_OMP    
         #pragma omp parallel
 #endif
@@ -654,7 +690,7 @@ namespace CTF_int{
           int * idx_glb = (int*)CTF_int::alloc(sizeof(int)*idx_max);
           memset(idx_glb, 0, sizeof(int)*idx_max);
 
-          SWITCH_ORD_CALL(sym_seq_ctr_loop, idx_max-1, alpha, A, sr_A, order_A, edge_len_A, sym_A, idx_map_A, offsets_A, B, sr_B, order_B, edge_len_B, sym_B, idx_map_B, offsets_B, beta, C, sr_C, order_C, edge_len_C, sym_C, idx_map_C, offsets_C, func, idx_glb, rev_idx_map, idx_max);
+          SWITCH_ORD_CALL(sym_seq_ctr_loop, idx_max-1, alpha, A, sr_A, order_A, edge_len_A, sym_A, idx_map_A, offsets_A, B, sr_B, order_B, edge_len_B, sym_B, idx_map_B, offsets_B, beta, C, sr_C, order_C, edge_len_C, sym_C, idx_map_C, offsets_C, func, idx_glb, rev_idx_map, idx_max, par_idim);
           cdealloc(idx_glb);
         }
       } else {
@@ -662,7 +698,7 @@ namespace CTF_int{
           int * idx_glb = (int*)CTF_int::alloc(sizeof(int)*idx_max);
           memset(idx_glb, 0, sizeof(int)*idx_max);
 
-          SWITCH_ORD_CALL(sym_seq_ctr_loop, idx_max-1, alpha, A, sr_A, order_A, edge_len_A, sym_A, idx_map_A, offsets_A, B, sr_B, order_B, edge_len_B, sym_B, idx_map_B, offsets_B, beta, C, sr_C, order_C, edge_len_C, sym_C, idx_map_C, offsets_C, func, idx_glb, rev_idx_map, idx_max);
+          SWITCH_ORD_CALL(sym_seq_ctr_loop, idx_max-1, alpha, A, sr_A, order_A, edge_len_A, sym_A, idx_map_A, offsets_A, B, sr_B, order_B, edge_len_B, sym_B, idx_map_B, offsets_B, beta, C, sr_C, order_C, edge_len_C, sym_C, idx_map_C, offsets_C, func, idx_glb, rev_idx_map, idx_max, -1);
           cdealloc(idx_glb);
         }
       }
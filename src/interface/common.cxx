@@ -10,6 +10,7 @@
 
 namespace CTF {
   int DGTOG_SWITCH = 1;
+  int OUT_OF_CORE = 0;
 }
 
 namespace CTF_int {
@@ -45,6 +46,13 @@ namespace CTF_int {
   LinModel<3> allred_mdl_cst(allred_mdl_cst_init,"allred_mdl_cst");
   LinModel<3> bcast_mdl(bcast_mdl_init,"bcast_mdl");
 
+  //models for communicators whose ranks all reside on one node
+  LinModel<3> alltoall_node_mdl(alltoall_node_mdl_init,"alltoall_node_mdl");
+  LinModel<3> alltoallv_node_mdl(alltoallv_node_mdl_init,"alltoallv_node_mdl");
+  LinModel<3> red_node_mdl(red_node_mdl_init,"red_node_mdl");
+  LinModel<3> allred_node_mdl(allred_node_mdl_init,"allred_node_mdl");
+  LinModel<3> bcast_node_mdl(bcast_node_mdl_init,"bcast_node_mdl");
+
 
   template <typename type>
   int conv_idx(int          order,
@@ -178,6 +186,16 @@ namespace CTF_int {
     return total_flop_count;
   }
 
+  int64_t total_comm_bytes = 0;
+
+  void comm_bytes_add(int64_t n){
+    total_comm_bytes+=n;
+  }
+
+  int64_t get_comm_bytes(){
+    return total_comm_bytes;
+  }
+
   void handler() {
   #if (!BGP && !BGQ && !HOPPER)
     int i, size;
@@ -217,6 +235,8 @@ namespace CTF_int {
   CommData::CommData(){
     alive = 0;
     created = 0;
+    node_np = 1;
+    intra_node = false;
   }
 
   CommData::~CommData(){
@@ -230,6 +250,8 @@ namespace CTF_int {
     np      = other.np;
     color   = other.color;
     created = 0;
+    node_np    = other.node_np;
+    intra_node = other.intra_node;
   }
 
   CommData& CommData::operator=(CommData const & other){
@@ -239,6 +261,8 @@ namespace CTF_int {
     np      = other.np;
     color   = other.color;
     created = 0;
+    node_np    = other.node_np;
+    intra_node = other.intra_node;
     return *this;
   }
 
@@ -249,6 +273,8 @@ namespace CTF_int {
     MPI_Comm_size(cm, &np);
     alive = 1;
     created = 0;
+    node_np = 1;
+    intra_node = false;
   }
 
   CommData::CommData(int rank_, int color_, int np_){
@@ -257,6 +283,8 @@ namespace CTF_int {
     np      = np_;
     alive   = 0;
     created = 0;
+    node_np = 1;
+    intra_node = false;
   }
 
   CommData::CommData(int rank_, int color_, CommData parent){
@@ -267,6 +295,8 @@ namespace CTF_int {
     MPI_Comm_size(cm, &np);
     alive   = 1;
     created = 1;
+    node_np = 1;
+    intra_node = false;
   }
 
   void CommData::activate(MPI_Comm parent){
@@ -294,13 +324,15 @@ namespace CTF_int {
 
   double CommData::estimate_bcast_time(int64_t msg_sz){
     double ps[] = {1.0, log2((double)np), (double)msg_sz};
+    if (intra_node)
+      return bcast_node_mdl.est_time(ps);
     return bcast_mdl.est_time(ps);
   }
 
   double CommData::estimate_allred_time(int64_t msg_sz, MPI_Op op){
     double ps[] = {1.0, log2((double)np), (double)msg_sz*log2((double)(np))};
     if (op >= MPI_MAX && op <= MPI_REPLACE)
-      return allred_mdl.est_time(ps);
+      return (intra_node ? allred_node_mdl : allred_mdl).est_time(ps);
     else
       return allred_mdl_cst.est_time(ps);
   }
@@ -308,7 +340,7 @@ namespace CTF_int {
   double CommData::estimate_red_time(int64_t msg_sz, MPI_Op op){
     double ps[] = {1.0, log2((double)np), (double)msg_sz*log2((double)(np))};
     if (op >= MPI_MAX && op <= MPI_REPLACE)
-      return red_mdl.est_time(ps);
+      return (intra_node ? red_node_mdl : red_mdl).est_time(ps);
     else
       return red_mdl_cst.est_time(ps);
   }
@@ -324,11 +356,15 @@ namespace CTF_int {
 
   double CommData::estimate_alltoall_time(int64_t chunk_sz) {
     double ps[] = {1.0, log2((double)np), log2((double)np)*np*chunk_sz};
+    if (intra_node)
+      return alltoall_node_mdl.est_time(ps);
     return alltoall_mdl.est_time(ps);
   }
 
   double CommData::estimate_alltoallv_time(int64_t tot_sz) {
     double ps[] = {1.0, log2((double)np), log2((double)np)*tot_sz};
+    if (intra_node)
+      return alltoallv_node_mdl.est_time(ps);
     return alltoallv_mdl.est_time(ps);
   }
 
@@ -340,21 +376,20 @@ namespace CTF_int {
     int tsize_;
     MPI_Type_size(mdtype, &tsize_);
     double tps_[] = {0.0, 1.0, log2(np), ((double)count)*tsize_};
-    if (!bcast_mdl.should_observe(tps_)) return;
+    if (!(intra_node ? bcast_node_mdl : bcast_mdl).should_observe(tps_)) return;
 #endif
 
-#ifdef TUNE
     double st_time = MPI_Wtime();
-#endif
     MPI_Bcast(buf, count, mdtype, root, cm);
+    int tsize;
+    MPI_Type_size(mdtype, &tsize);
+    comm_bytes_add(count*tsize);
 #ifdef TUNE
     MPI_Barrier(cm);
+#endif
     double exe_time = MPI_Wtime()-st_time;
-    int tsize;
-    MPI_Type_size(mdtype, &tsize);
     double tps[] = {exe_time, 1.0, log2(np), ((double)count)*tsize};
-    bcast_mdl.observe(tps);
-#endif
+    (intra_node ? bcast_node_mdl : bcast_mdl).observe(tps);
   }
 
   void CommData::allred(void * inbuf, void * outbuf, int64_t count, MPI_Datatype mdtype, MPI_Op op){
@@ -368,7 +403,7 @@ namespace CTF_int {
     double tps_[] = {0.0, 1.0, log2(np), ((double)count)*tsize_*std::max(.5,(double)log2(np))};
     bool bsr = true;
     if (op >= MPI_MAX && op <= MPI_REPLACE)
-      bsr = allred_mdl.should_observe(tps_);
+      bsr = (intra_node ? allred_node_mdl : allred_mdl).should_observe(tps_);
     else
       bsr = allred_mdl_cst.should_observe(tps_);
     if(!bsr) return;
@@ -382,9 +417,10 @@ namespace CTF_int {
     double exe_time = MPI_Wtime()-st_time;
     int tsize;
     MPI_Type_size(mdtype, &tsize);
+    comm_bytes_add(count*tsize);
     double tps[] = {exe_time, 1.0, log2(np), ((double)count)*tsize*std::max(.5,(double)log2(np))};
     if (op >= MPI_MAX && op <= MPI_REPLACE)
-      allred_mdl.observe(tps);
+      (intra_node ? allred_node_mdl : allred_mdl).observe(tps);
     else
       allred_mdl_cst.observe(tps);
   }
@@ -399,7 +435,7 @@ namespace CTF_int {
     double tps_[] = {0.0, 1.0, log2(np), ((double)count)*tsize_*std::max(.5,(double)log2(np))};
     bool bsr = true;
     if (op >= MPI_MAX && op <= MPI_REPLACE)
-      bsr = red_mdl.should_observe(tps_);
+      bsr = (intra_node ? red_node_mdl : red_mdl).should_observe(tps_);
     else
       bsr = red_mdl_cst.should_observe(tps_);
     if(!bsr) return;
@@ -413,14 +449,198 @@ namespace CTF_int {
     double exe_time = MPI_Wtime()-st_time;
     int tsize;
     MPI_Type_size(mdtype, &tsize);
+    comm_bytes_add(count*tsize);
     double tps[] = {exe_time, 1.0, log2(np), ((double)count)*tsize*std::max(.5,(double)log2(np))};
     if (op >= MPI_MAX && op <= MPI_REPLACE)
-      red_mdl.observe(tps);
+      (intra_node ? red_node_mdl : red_mdl).observe(tps);
     else
       red_mdl_cst.observe(tps);
   }
 
 
+#ifdef USE_MPI_SHM
+  /**
+   * \brief ranks of a communicator that reside on the same node,
+   *        cached as an attribute of the communicator
+   */
+  struct node_group {
+    /** \brief communicator of ranks sharing memory with this one */
+    MPI_Comm cm;
+    /** \brief number of ranks on this node and rank within cm */
+    int np, rank;
+    /** \brief rank in cm of each rank of the parent communicator, -1 if on another node */
+    int * node_rank;
+  };
+
+  static int node_group_keyval = MPI_KEYVAL_INVALID;
+
+  static int delete_node_group(MPI_Comm cm, int keyval, void * val, void * extra){
+    node_group * ng = (node_group*)val;
+    if (ng != NULL){
+      MPI_Comm_free(&ng->cm);
+      free(ng->node_rank);
+      free(ng);
+    }
+    return MPI_SUCCESS;
+  }
+
+  /**
+   * \brief returns the on-node grouping of the ranks of cm, constructed collectively on first call
+   * \param[in] cm communicator
+   * \param[in] np number of ranks in cm
+   * \param[in] rank rank in cm
+   * \return node group or NULL if no two ranks of cm share a node
+   */
+  static node_group const * get_node_group(MPI_Comm cm, int np, int rank){
+    if (np == 1) return NULL;
+    if (node_group_keyval == MPI_KEYVAL_INVALID)
+      MPI_Comm_create_keyval(MPI_COMM_NULL_COPY_FN, delete_node_group, &node_group_keyval, NULL);
+    void * val;
+    int flag;
+    MPI_Comm_get_attr(cm, node_group_keyval, &val, &flag);
+    if (flag) return (node_group const*)val;
+
+    node_group * ng = NULL;
+    int is_inter;
+    MPI_Comm_test_inter(cm, &is_inter);
+    if (!is_inter){
+      MPI_Comm ncm;
+      int nnp, nrank;
+      MPI_Comm_split_type(cm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &ncm);
+      MPI_Comm_size(ncm, &nnp);
+      MPI_Comm_rank(ncm, &nrank);
+      if (nnp == 1){
+        MPI_Comm_free(&ncm);
+      } else {
+        int * members = (int*)malloc(sizeof(int)*nnp);
+        MPI_Allgather(&rank, 1, MPI_INT, members, 1, MPI_INT, ncm);
+        ng = (node_group*)malloc(sizeof(node_group));
+        ng->cm = ncm;
+        ng->np = nnp;
+        ng->rank = nrank;
+        ng->node_rank = (int*)malloc(sizeof(int)*np);
+        std::fill(ng->node_rank, ng->node_rank+np, -1);
+        for (int i=0; i<nnp; i++){
+          ng->node_rank[members[i]] = i;
+        }
+        free(members);
+      }
+    }
+    MPI_Comm_set_attr(cm, node_group_keyval, ng);
+    return ng;
+  }
+
+  /**
+   * \brief all-to-all-v in which messages between ranks on the same node are not sent via MPI,
+   *        instead each rank places its on-node slices in an MPI-3 shared memory window,
+   *        from which the destination ranks copy them directly into their receive buffers
+   *        (parameters as for CommData::all_to_allv)
+   */
+  static void node_all_to_allv(node_group const * ng,
+                               MPI_Comm           cm,
+                               int                np,
+                               int                rank,
+                               void *             send_buffer,
+                               int64_t const *    send_counts,
+                               int64_t const *    send_displs,
+                               int64_t            datum_size,
+                               void *             recv_buffer,
+                               int64_t const *    recv_counts,
+                               int64_t const *    recv_displs){
+    TAU_FSTART(node_all_to_allv);
+    int const * node_rank = ng->node_rank;
+    int num_inter = 0;
+    for (int p=0; p<np; p++){
+      if (node_rank[p] == -1){
+        if (send_counts[p] != 0) num_inter++;
+        if (recv_counts[p] != 0) num_inter++;
+      }
+    }
+    // post messages to and from other nodes, which progress while on-node data is exchanged
+    MPI_Datatype mdt;
+    MPI_Type_contiguous(datum_size, MPI_CHAR, &mdt);
+    MPI_Type_commit(&mdt);
+    MPI_Request * reqs = (MPI_Request*)malloc(sizeof(MPI_Request)*std::max(num_inter,1));
+    int nreq = 0;
+    for (int p=0; p<np; p++){
+      if (node_rank[p] == -1 && recv_counts[p] != 0){
+        MPI_Irecv(((char*)recv_buffer)+recv_displs[p]*datum_size,
+                  recv_counts[p], mdt, p, p, cm, reqs+nreq);
+        nreq++;
+      }
+    }
+    for (int lp=0; lp<np; lp++){
+      int p = (lp+rank)%np;
+      if (node_rank[p] == -1 && send_counts[p] != 0){
+        MPI_Isend(((char*)send_buffer)+send_displs[p]*datum_size,
+                  send_counts[p], mdt, p, rank, cm, reqs+nreq);
+        nreq++;
+      }
+    }
+
+    // segment of the window owned by this rank holds the offset of the slice for each on-node rank, followed by the slices
+    int64_t hdr_sz = sizeof(int64_t)*ng->np;
+    int64_t seg_sz = hdr_sz;
+    for (int p=0; p<np; p++){
+      if (node_rank[p] != -1 && p != rank) seg_sz += send_counts[p]*datum_size;
+    }
+    char * seg;
+    MPI_Win win;
+    MPI_Win_allocate_shared(seg_sz, 1, MPI_INFO_NULL, ng->cm, &seg, &win);
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, win);
+    int64_t * seg_offs = (int64_t*)seg;
+    int64_t off = hdr_sz;
+    for (int p=0; p<np; p++){
+      if (node_rank[p] != -1 && p != rank){
+        seg_offs[node_rank[p]] = off;
+        memcpy(seg+off, ((char*)send_buffer)+send_displs[p]*datum_size, send_counts[p]*datum_size);
+        off += send_counts[p]*datum_size;
+      }
+    }
+    memcpy(((char*)recv_buffer)+recv_displs[rank]*datum_size,
+           ((char*)send_buffer)+send_displs[rank]*datum_size, send_counts[rank]*datum_size);
+    MPI_Win_sync(win);
+    MPI_Barrier(ng->cm);
+    MPI_Win_sync(win);
+    for (int p=0; p<np; p++){
+      if (node_rank[p] != -1 && p != rank && recv_counts[p] != 0){
+        MPI_Aint psz;
+        int disp_unit;
+        char * pseg;
+        MPI_Win_shared_query(win, node_rank[p], &psz, &disp_unit, &pseg);
+        memcpy(((char*)recv_buffer)+recv_displs[p]*datum_size,
+               pseg+((int64_t*)pseg)[ng->rank], recv_counts[p]*datum_size);
+      }
+    }
+    // segments may be released only once all on-node ranks are done reading them
+    MPI_Barrier(ng->cm);
+    MPI_Win_unlock_all(win);
+    MPI_Win_free(&win);
+
+    MPI_Waitall(nreq, reqs, MPI_STATUSES_IGNORE);
+    free(reqs);
+    MPI_Type_free(&mdt);
+    TAU_FSTOP(node_all_to_allv);
+  }
+#endif
+
+  void CommData::detect_nodes(){
+    node_np = 1;
+    intra_node = (np == 1);
+#ifdef USE_MPI_SHM
+    ASSERT(alive);
+    node_group const * ng = get_node_group(cm, np, rank);
+    if (ng == NULL) return;
+    // node_np is only meaningful if every node holds the same number of consecutive ranks
+    int is_blocked = (np % ng->np == 0 && rank - ng->rank == (rank/ng->np)*ng->np);
+    MPI_Allreduce(MPI_IN_PLACE, &is_blocked, 1, MPI_INT, MPI_MIN, cm);
+    int min_np;
+    MPI_Allreduce(&ng->np, &min_np, 1, MPI_INT, MPI_MIN, cm);
+    if (is_blocked && min_np == ng->np) node_np = ng->np;
+    intra_node = (ng->np == np);
+#endif
+  }
+
   void CommData::all_to_allv(void *          send_buffer,
                              int64_t const * send_counts,
                              int64_t const * send_displs,
@@ -434,16 +654,19 @@ namespace CTF_int {
     // change-of-observe
     int64_t tot_sz_ = std::max(send_displs[np-1]+send_counts[np-1], recv_displs[np-1]+recv_counts[np-1])*datum_size;
     double tps_[] = {0.0, 1.0, log2(np), (double)tot_sz_};
-    if (!alltoallv_mdl.should_observe(tps_)) return;
+    if (!(intra_node ? alltoallv_node_mdl : alltoallv_mdl).should_observe(tps_)) return;
     #endif
 
     double st_time = MPI_Wtime();
     int num_nnz_trgt = 0;
     int num_nnz_recv = 0;
+    int64_t nsend = 0;
     for (int p=0; p<np; p++){
       if (send_counts[p] != 0) num_nnz_trgt++;
       if (recv_counts[p] != 0) num_nnz_recv++;
+      nsend += send_counts[p];
     }
+    comm_bytes_add(nsend*datum_size);
     double frac_nnz = ((double)num_nnz_trgt)/np;
     double tot_frac_nnz;
     MPI_Allreduce(&frac_nnz, &tot_frac_nnz, 1, MPI_DOUBLE, MPI_SUM, cm);
@@ -454,6 +677,12 @@ namespace CTF_int {
 
     MPI_Allreduce(&max_displs, &tot_max_displs, 1, MPI_INT64_T, MPI_MAX, cm);
 
+#ifdef USE_MPI_SHM
+    node_group const * ng = get_node_group(cm, np, rank);
+    if (ng != NULL){
+      node_all_to_allv(ng, cm, np, rank, send_buffer, send_counts, send_displs, datum_size, recv_buffer, recv_counts, recv_displs);
+    } else
+#endif
     if (tot_max_displs >= INT32_MAX ||
         (datum_size != 4 && datum_size != 8 && datum_size != 16) ||
         (tot_frac_nnz <= .25 && tot_frac_nnz*np < 100)){
@@ -527,7 +756,7 @@ namespace CTF_int {
     double exe_time = MPI_Wtime()-st_time;
     int64_t tot_sz = std::max(send_displs[np-1]+send_counts[np-1], recv_displs[np-1]+recv_counts[np-1])*datum_size;
     double tps[] = {exe_time, 1.0, log2(np), (double)tot_sz};
-    alltoallv_mdl.observe(tps);
+    (intra_node ? alltoallv_node_mdl : alltoallv_mdl).observe(tps);
   }
 
   void cvrt_idx(int         order,
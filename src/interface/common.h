@@ -44,6 +44,13 @@ namespace CTF {
    */
   extern int DGTOG_SWITCH;
 
+  /**
+   * \brief if nonzero, a nonsymmetric dense contraction for which no mapping fits in the memory limit
+   *        (CTF_MEMORY_SIZE) is done as a sequence of contractions of slabs along one of its indices,
+   *        set by the environment variable CTF_OUT_OF_CORE
+   */
+  extern int OUT_OF_CORE;
+
   /**
    * \brief reduction types for tensor data
    *        deprecated types: OP_NORM1=OP_SUMABS, OP_NORM2=call norm2(), OP_NORM_INFTY=OP_MAXABS
@@ -124,6 +131,13 @@ namespace CTF_int {
 
   int64_t get_flops();
 
+  /**
+   * \brief counts bytes sent by this process in CommData collectives
+   */
+  void comm_bytes_add(int64_t n);
+
+  int64_t get_comm_bytes();
+
   class CommData {
     public:
       MPI_Comm cm;
@@ -132,6 +146,10 @@ namespace CTF_int {
       int color;
       int alive;
       int created;
+      /** \brief number of ranks per node, if the ranks of cm on each node are a contiguous block of this size, 1 otherwise */
+      int node_np;
+      /** \brief whether all ranks of this communicator reside on the same node */
+      bool intra_node;
   
       CommData();
       ~CommData();
@@ -170,6 +188,12 @@ namespace CTF_int {
 
       /* \brief deactivate (MPI_Free) this comm */
       void deactivate();
+
+      /**
+       * \brief determines which ranks of this (active) comm share a node and sets node_np and intra_node,
+       *        collective over cm
+       */
+      void detect_nodes();
      
       /* \brief provide estimate of broadcast execution time */
       double estimate_bcast_time(int64_t msg_sz);
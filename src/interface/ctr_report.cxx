@@ -0,0 +1,135 @@
+/*Copyright (c) 2011, Edgar Solomonik, all rights reserved.*/
+
+#include "timer.h"
+#include "common.h"
+#include <cfloat>
+
+namespace CTF_int {
+  // reports recorded since start_contraction_reports(), NULL if not recording
+  static std::vector<CTF::Contraction_Report> * ctr_reports = NULL;
+
+  bool is_recording_ctr_reports(){
+    return ctr_reports != NULL;
+  }
+
+  void record_ctr_report(CTF::Contraction_Report const & r){
+    if (ctr_reports != NULL) ctr_reports->push_back(r);
+  }
+
+  static void json_str(std::string & s, std::string const & v){
+    s += '"';
+    for (int i=0; i<(int)v.size(); i++){
+      if (v[i] == '"' || v[i] == '\\'){
+        s += '\\';
+        s += v[i];
+      } else if ((unsigned char)v[i] < 0x20){
+        char buf[8];
+        snprintf(buf, 8, "\\u%04x", (int)(unsigned char)v[i]);
+        s += buf;
+      } else
+        s += v[i];
+    }
+    s += '"';
+  }
+
+  static void json_num(std::string & s, double v){
+    // JSON has no representation of infinity and NaN
+    if (!(v == v) || v > DBL_MAX || v < -DBL_MAX){
+      s += "null";
+      return;
+    }
+    char buf[32];
+    snprintf(buf, 32, "%.6e", v);
+    s += buf;
+  }
+
+  static void json_int(std::string & s, int64_t v){
+    char buf[32];
+    snprintf(buf, 32, "%lld", (long long)v);
+    s += buf;
+  }
+}
+
+namespace CTF {
+  Contraction_Report::Contraction_Report(){
+    est_time     = 0.0;
+    tot_time     = 0.0;
+    map_time     = 0.0;
+    redist_time  = 0.0;
+    ctr_time     = 0.0;
+    for (int i=0; i<3; i++) redist_bytes[i] = 0;
+    flops        = 0;
+    mem_peak     = 0;
+    mem_est      = 0;
+  }
+
+  std::string Contraction_Report::to_json() const {
+    using namespace CTF_int;
+    char const * nms[] = {"A", "B", "C"};
+    std::string const * maps[] = {&map_A, &map_B, &map_C};
+    std::string s = "{\"term\":";
+    json_str(s, term);
+    s += ",\"mapping\":{";
+    for (int i=0; i<3; i++){
+      if (i>0) s += ",";
+      json_str(s, nms[i]);
+      s += ":";
+      json_str(s, *maps[i]);
+    }
+    s += "},\"est_time\":";
+    json_num(s, est_time);
+    s += ",\"tot_time\":";
+    json_num(s, tot_time);
+    s += ",\"map_time\":";
+    json_num(s, map_time);
+    s += ",\"redist_time\":";
+    json_num(s, redist_time);
+    s += ",\"ctr_time\":";
+    json_num(s, ctr_time);
+    s += ",\"redist_bytes\":{";
+    for (int i=0; i<3; i++){
+      if (i>0) s += ",";
+      json_str(s, nms[i]);
+      s += ":";
+      json_int(s, redist_bytes[i]);
+    }
+    s += "},\"flops\":";
+    json_int(s, flops);
+    s += ",\"mem_peak\":";
+    json_int(s, mem_peak);
+    s += ",\"mem_est\":";
+    json_int(s, mem_est);
+    s += ",\"layers\":[";
+    for (int i=0; i<(int)layers.size(); i++){
+      if (i>0) s += ",";
+      s += "{\"name\":";
+      json_str(s, layers[i].name);
+      s += ",\"est_time\":";
+      json_num(s, layers[i].est_time);
+      s += ",\"exe_time\":";
+      json_num(s, layers[i].exe_time);
+      s += ",\"nrun\":";
+      json_int(s, layers[i].nrun);
+      s += "}";
+    }
+    s += "]}";
+    return s;
+  }
+
+  void start_contraction_reports(){
+    if (CTF_int::ctr_reports == NULL)
+      CTF_int::ctr_reports = new std::vector<Contraction_Report>();
+    else
+      CTF_int::ctr_reports->clear();
+  }
+
+  std::vector<Contraction_Report> stop_contraction_reports(){
+    std::vector<Contraction_Report> reps;
+    if (CTF_int::ctr_reports != NULL){
+      reps.swap(*CTF_int::ctr_reports);
+      delete CTF_int::ctr_reports;
+      CTF_int::ctr_reports = NULL;
+    }
+    return reps;
+  }
+}
@@ -2,147 +2,610 @@
 #include <stdio.h>
 #include "decomposition.h"
 
-namespace CTF {
+namespace CTF_int {
+  /**
+   * \brief multiplies the contraction term t by the factor matrices of modes i,...,order-1
+   * \param[in] t contraction of the core tensor with the factor matrices of modes 0,...,i-1
+   * \param[in] i first mode to multiply by
+   * \param[in] factors factor matrices
+   * \param[in] idx_map outer indices of the decomposed tensor
+   * \param[in] core_idx inner indices of the core tensor
+   */
+  template<typename dtype>
+  Contract_Term mult_factors(Contract_Term const &                     t,
+                             int                                       i,
+                             std::vector< CTF::Matrix<dtype> > &       factors,
+                             char const *                              idx_map,
+                             char const *                              core_idx){
+    if (i == (int)factors.size()) return t;
+    char factor_idx[] = {idx_map[i], core_idx[i], '\0'};
+    return mult_factors(t*factors[i][factor_idx], i+1, factors, idx_map, core_idx);
+  }
 
+  /**
+   * \brief computes the rank leading left singular vectors of the mode unfolding of T via a randomized range finder,
+   *        products with the unfolding and its adjoint are contractions with T, so the unfolding is never formed
+   *        and T may be sparse, the left singular vectors of the sampled k-by-n block B = Q^H T_(mode)
+   *        are obtained from its k-by-k Gram matrix B B^H
+   * \param[in] T tensor
+   * \param[in] mode mode whose unfolding is decomposed
+   * \param[in] rank number of singular vectors
+   * \param[in] iter number of power iterations
+   * \param[in] oversamp number of additional random vectors
+   */
   template<typename dtype>
-  void fold_unfold(Tensor<dtype>& X, Tensor<dtype>& Y){
+  CTF::Matrix<dtype> get_factor_matrix(CTF::Tensor<dtype> & T, int mode, int rank, int iter, int oversamp){
+    CTF::World & dw = *T.wrld;
+    algstrct const & sr = *T.sr;
+    int m = T.lens[mode];
+    int64_t ncol = 1;
+    for (int i=0; i<T.order; i++){
+      if (i != mode) ncol *= T.lens[i];
+    }
+    int k = (int)std::min((int64_t)std::min(m, rank+oversamp), ncol);
+    IASSERT(rank > 0 && rank <= k);
+
+    // indices of T, of the remaining modes followed by the sample index z, and of the sampled range
+    char idx[T.order+1];
+    char oidx[T.order+1];
+    char cidx[T.order+1];
+    int olens[T.order];
+    int no = 0;
+    for (int i=0; i<T.order; i++){
+      idx[i] = 'a'+i;
+      if (i != mode){
+        oidx[no] = idx[i];
+        cidx[no] = idx[i];
+        olens[no] = T.lens[i];
+        no++;
+      }
+    }
+    idx[T.order] = '\0';
+    oidx[no] = 'z';
+    cidx[no] = 'y';
+    oidx[no+1] = '\0';
+    cidx[no+1] = '\0';
+    olens[no] = k;
+    char yidx[] = {idx[mode], 'z', '\0'};
 
-    int64_t * inds_X; 
-    double * vals_X;
-    int64_t n_X;
-    //if global index ordering is preserved between the two tensors, we can fold simply
-    X.read_local(&n_X, &inds_X, &vals_X);
-    Y.write(n_X, inds_X, vals_X);
+    CTF::Tensor<dtype> Omega(no+1, olens, dw, sr);
+    fill_rand_sample(Omega);
+    CTF::Matrix<dtype> Y(m, k, dw, sr);
+    Y[yidx] = T[idx]*Omega[oidx];
+    CTF::Matrix<dtype> Q, R;
+    Y.qr(Q, R);
+    CTF::Tensor<dtype> W(no+1, olens, dw, sr);
+    for (int it=0; it<iter; it++){
+      conj_tensor(Q);
+      W[oidx] = T[idx]*Q[yidx];
+      conj_tensor(W);
+      Y[yidx] = T[idx]*W[oidx];
+      Y.qr(Q, R);
+    }
 
+    // W = B^T, so B B^H = W^T conj(W)
+    conj_tensor(Q);
+    W[oidx] = T[idx]*Q[yidx];
+    conj_tensor(Q);
+    CTF::Tensor<dtype> Wc(W);
+    conj_tensor(Wc);
+    CTF::Matrix<dtype> G(k, k, dw, sr);
+    G["zy"] = W[oidx]*Wc[cidx];
+
+    dtype * g = (dtype*)alloc(sizeof(dtype)*k*k);
+    dtype * s = (dtype*)alloc(sizeof(dtype)*k);
+    dtype * us = (dtype*)alloc(sizeof(dtype)*k*k);
+    dtype * vsh = (dtype*)alloc(sizeof(dtype)*k*k);
+    G.read_all(g);
+    if (dw.rank == 0){
+      int info;
+      dtype dlwork;
+      CTF_LAPACK::gesvd<dtype>('S', 'S', k, k, g, k, s, us, k, vsh, k, &dlwork, -1, &info);
+      int lwork = (int)std::real(dlwork);
+      dtype * work = (dtype*)alloc(sizeof(dtype)*lwork);
+      CTF_LAPACK::gesvd<dtype>('S', 'S', k, k, g, k, s, us, k, vsh, k, work, lwork, &info);
+      cdealloc(work);
+    }
+    CTF::Matrix<dtype> Us(k, rank, dw, sr);
+    write_from_root(Us, ((int64_t)k)*rank, us);
+    CTF::Matrix<dtype> U(m, rank, dw, sr);
+    U["is"] = Q["iz"]*Us["zs"];
+
+    cdealloc(vsh);
+    cdealloc(us);
+    cdealloc(s);
+    cdealloc(g);
+    return U;
   }
 
+  /**
+   * \brief writes the indices of a tensor whose modes are a subset of those of the decomposed tensor,
+   *        mode j is labeled 'a'+j and the rank index, if present, is labeled 'z'
+   * \param[in] modes modes of the tensor
+   * \param[in] has_r whether the rank index follows the modes
+   * \param[out] idx null-terminated index string
+   */
+  inline void cp_idx(std::vector<int> const & modes, bool has_r, char * idx){
+    int i;
+    for (i=0; i<(int)modes.size(); i++){
+      idx[i] = 'a'+modes[i];
+    }
+    if (has_r) idx[i++] = 'z';
+    idx[i] = '\0';
+  }
 
+  /**
+   * \brief contracts one mode of X with a factor matrix, Y[modes\{j}, z] = X[modes(, z)] * U[j, z],
+   *        the rank index z is a Hadamard index if X already carries it
+   * \param[in] X tensor with the given modes, followed by the rank index if has_r
+   * \param[in] modes modes of X
+   * \param[in] has_r whether X carries the rank index
+   * \param[in] j mode to contract
+   * \param[in] U factor matrix of mode j
+   * \param[out] Y tensor with modes \ {j} followed by the rank index
+   */
   template<typename dtype>
-  Contract_Term HoSVD::operator[](char const * idx_map){
-    char int_inds[core_tensor.order];
-    for (int i=0; i<core_tensor.order; i++){
-      int_inds = "["+i;
-      //FIXME: how to make this robust?
+  void contract_factor(CTF::Tensor<dtype> &     X,
+                       std::vector<int> const & modes,
+                       bool                     has_r,
+                       int                      j,
+                       CTF::Matrix<dtype> &     U,
+                       CTF::Tensor<dtype> &     Y){
+    std::vector<int> ymodes;
+    for (int k=0; k<(int)modes.size(); k++){
+      if (modes[k] != j) ymodes.push_back(modes[k]);
     }
-    char factor_inds[2];
-    factor_inds[0] = idx_map[0];
-    factor_inds[1] = int_inds[0];
-    Contract_Term t(core_tensor[ind_inds],factor_matrices[0][factor_inds]);
-    for (int i=1; i<core_tensor.order; i++){
-      factor_inds[0] = idx_map[i];
-      factor_inds[1] = int_inds[i];
-      Contract_Term t(t,factor_matrices[0][factor_inds]);
-    }
-    return t;
+    char xidx[modes.size()+2];
+    char yidx[modes.size()+1];
+    char uidx[] = {(char)('a'+j), 'z', '\0'};
+    cp_idx(modes, has_r, xidx);
+    cp_idx(ymodes, true, yidx);
+    Y[yidx] = X[xidx]*U[uidx];
   }
-  
 
   /**
-   * \calculate the rank[i] left singular columns of the i-mode unfoldings of a tensor
-   * \param[in] ranks array of ints that denote number of leading columns of left singular matrix to store
+   * \brief local nonzeros of a sparse tensor with their per-mode indices, and the rows of each factor matrix they touch,
+   *        used by a fused MTTKRP kernel that accumulates v*U_1[j,:].*U_2[k,:] directly into M[i,:] for each nonzero
+   *        v=T[i,j,k], the index decoding and the sparse reads of factor rows are planned once and reused by every MTTKRP
    */
   template<typename dtype>
-  std::vector< Matrix <dtype> > get_factor_matrices(Tensor<dtype>& T, int * ranks) {
-	
-    std::vector< Matrix <dtype> > factor_matrices (T.order);
+  struct sp_mttkrp_plan {
+    int order;
+    int rank;
+    int64_t nnz;
+    dtype * vals;
+    /** \brief pos[m][z] is the position of the mode m index of nonzero z among the distinct mode m indices */
+    int ** pos;
+    /** \brief number of distinct mode m indices among the local nonzeros */
+    int64_t * nrow;
+    /** \brief global indices of the entries of factor m in rows touched by local nonzeros, row-major */
+    int64_t ** gidx;
+    /** \brief buffers for the touched rows of each factor */
+    dtype ** rows;
 
-    char arg[T.order];
-    int transformed_lens[T.order];
-    char transformed_arg[T.order];
-    for (int i = 0; i < T.order; i++) {
-      arg[i] = 'i' + i;
-      transformed_arg[i] = 'i' + i;
-      transformed_lens[i] = T.lens[i];
+    /**
+     * \brief extracts the local nonzeros of T and plans the factor rows they touch
+     * \param[in] T sparse tensor
+     * \param[in] rank number of columns R of the factor matrices
+     */
+    sp_mttkrp_plan(CTF::Tensor<dtype> const & T, int rank_){
+      order = T.order;
+      rank = rank_;
+      int64_t * inds;
+      dtype * data;
+      T.get_local_data(&nnz, &inds, &data, true);
+      vals = (dtype*)alloc(sizeof(dtype)*nnz);
+      memcpy(vals, data, sizeof(dtype)*nnz);
+      pos = (int**)alloc(sizeof(int*)*order);
+      nrow = (int64_t*)alloc(sizeof(int64_t)*order);
+      gidx = (int64_t**)alloc(sizeof(int64_t*)*order);
+      rows = (dtype**)alloc(sizeof(dtype*)*order);
+      int64_t lda = 1;
+      for (int m=0; m<order; m++){
+        pos[m] = (int*)alloc(sizeof(int)*nnz);
+        std::vector<int> dist(nnz);
+        for (int64_t z=0; z<nnz; z++){
+          pos[m][z] = (int)((inds[z]/lda)%T.lens[m]);
+          dist[z] = pos[m][z];
+        }
+        std::sort(dist.begin(), dist.end());
+        dist.erase(std::unique(dist.begin(), dist.end()), dist.end());
+        for (int64_t z=0; z<nnz; z++){
+          pos[m][z] = std::lower_bound(dist.begin(), dist.end(), pos[m][z]) - dist.begin();
+        }
+        nrow[m] = dist.size();
+        gidx[m] = (int64_t*)alloc(sizeof(int64_t)*nrow[m]*rank);
+        rows[m] = (dtype*)alloc(sizeof(dtype)*nrow[m]*rank);
+        for (int64_t u=0; u<nrow[m]; u++){
+          for (int r=0; r<rank; r++){
+            gidx[m][u*rank+r] = dist[u] + ((int64_t)r)*T.lens[m];
+          }
+        }
+        lda *= T.lens[m];
+      }
+      delete [] inds;
+      delete [] data;
     }
 
-    for (int i = 0; i < T.order; i++) {
-      for (int j = i; j > 0; j--) { 
-        transformed_lens[j] = T.lens[j-1];
+    ~sp_mttkrp_plan(){
+      for (int m=0; m<order; m++){
+        cdealloc(rows[m]);
+        cdealloc(gidx[m]);
+        cdealloc(pos[m]);
       }
+      cdealloc(rows);
+      cdealloc(gidx);
+      cdealloc(nrow);
+      cdealloc(pos);
+      cdealloc(vals);
+    }
 
-      transformed_lens[0] = T.lens[i];
-      for (int j = 0; j < i; j++) {
-        transformed_arg[j] = arg[j+1];
+    /**
+     * \brief computes M = MTTKRP(T, mode) with the fused kernel, must be called by all processes
+     * \param[in] factors factor matrices
+     * \param[in] mode mode that is not contracted
+     * \param[out] M T.lens[mode]-by-R result
+     */
+    void mttkrp(std::vector< CTF::Matrix<dtype> > & factors, int mode, CTF::Tensor<dtype> & M){
+      for (int m=0; m<order; m++){
+        if (m != mode) factors[m].read(nrow[m]*rank, gidx[m], rows[m]);
       }
-      transformed_arg[i] = arg[0];
-
-      int unfold_lens [2];
-      unfold_lens[0] = T.lens[i];
-      int ncol = 1;
-
-      for (int j = 0; j < T.order; j++) {  
-        if (j != i) 
-          ncol *= T.lens[j];	
+      dtype * acc = rows[mode];
+      std::fill(acc, acc+nrow[mode]*rank, (dtype)0);
+      dtype * tmp = (dtype*)alloc(sizeof(dtype)*rank);
+      for (int64_t z=0; z<nnz; z++){
+        for (int r=0; r<rank; r++) tmp[r] = vals[z];
+        for (int m=0; m<order; m++){
+          if (m == mode) continue;
+          dtype const * row = rows[m] + ((int64_t)pos[m][z])*rank;
+          for (int r=0; r<rank; r++) tmp[r] *= row[r];
+        }
+        dtype * out = acc + ((int64_t)pos[mode][z])*rank;
+        for (int r=0; r<rank; r++) out[r] += tmp[r];
       }
-      unfold_lens[1] = ncol;
+      cdealloc(tmp);
+      M.set_zero();
+      M.write(nrow[mode]*rank, (dtype)1, (dtype)1, gidx[mode], acc);
+    }
+  };
 
-      Tensor<dtype> transformed_T(T.order, transformed_lens, *(T.wrld));
-      transformed_T[arg] = T[transformed_arg];
+  /**
+   * \brief inverts a symmetric positive definite matrix in place via its Cholesky factorization H = R^T R, H^{-1} = R^{-1} R^{-T}
+   * \param[in] n dimension
+   * \param[in,out] H n-by-n matrix
+   * \return false if H is not numerically positive definite
+   */
+  template<typename dtype>
+  bool spd_inverse(int n, dtype * H){
+    int info;
+    CTF_LAPACK::potrf<dtype>('U', n, H, n, &info);
+    if (info != 0) return false;
+    dtype * Rinv = (dtype*)alloc(sizeof(dtype)*n*n);
+    std::fill(Rinv, Rinv+n*n, (dtype)0);
+    for (int i=0; i<n; i++) Rinv[i+i*n] = 1;
+    for (int j=0; j<n; j++){
+      for (int i=j+1; i<n; i++) H[i+j*n] = 0;
+    }
+    dtype one = 1, zero = 0;
+    CTF_BLAS::trsm<dtype>("L", "U", "N", "N", &n, &n, &one, H, &n, Rinv, &n);
+    CTF_BLAS::gemm<dtype>("N", "T", &n, &n, &n, &one, Rinv, &n, Rinv, &n, &zero, H, &n);
+    cdealloc(Rinv);
+    return true;
+  }
+
+  /**
+   * \brief multiplies the contraction term t by the factor matrices of modes i,...,order-1 of a CP decomposition
+   */
+  template<typename dtype>
+  Contract_Term mult_cp_factors(Contract_Term const &                     t,
+                                int                                       i,
+                                std::vector< CTF::Matrix<dtype> > &       factors,
+                                char const *                              idx_map,
+                                char                                      r){
+    if (i == (int)factors.size()) return t;
+    char factor_idx[] = {idx_map[i], r, '\0'};
+    return mult_cp_factors(t*factors[i][factor_idx], i+1, factors, idx_map, r);
+  }
+}
 
-      Tensor<dtype> cur_unfold(2, unfold_lens,  *(T.wrld));
-      fold_unfold(transformed_T, cur_unfold);
+namespace CTF {
 
-      Matrix<dtype> M(cur_unfold);
-      Matrix<dtype> U;
-      Matrix<dtype> VT;
-      Vector<dtype> S;
-      M.svd(U, S, VT, ranks[i]);
-      factor_matrices[i] = U;
-		
+  template<typename dtype>
+  CTF_int::Contract_Term HoSVD<dtype>::operator[](char const * idx_map){
+    int order = core_tensor.order;
+    // inner indices must not clash with the outer ones
+    char core_idx[order+1];
+    char c = 'A';
+    for (int i=0; i<order; i++){
+      while (strchr(idx_map, c) != NULL && c < 'z') c++;
+      core_idx[i] = c++;
     }
-
-    return factor_matrices;
+    core_idx[order] = '\0';
+    char factor_idx[] = {idx_map[0], core_idx[0], '\0'};
+    return CTF_int::mult_factors(core_tensor[core_idx]*factor_matrices[0][factor_idx], 1, factor_matrices, idx_map, core_idx);
   }
+
   template<typename dtype>
-  Tensor<dtype> get_core_tensor(Tensor<dtype>& T, std::vector< Matrix <dtype> > factor_matrices, int * ranks) {
+  HoSVD<dtype>::HoSVD(Tensor<dtype> & T, int const * ranks, int iter, int oversamp) {
+    for (int i=0; i<T.order; i++){
+      factor_matrices.push_back(CTF_int::get_factor_matrix(T, i, ranks[i], iter, oversamp));
+    }
 
-    std::vector< Tensor <> > core_tensors(T.order+1);
-    core_tensors[0] = T;
+    // core = T x_1 U_1^H x_2 U_2^H ... x_N U_N^H, contracting one mode at a time
+    char idx[T.order+1];
+    char core_idx[T.order+1];
     int lens[T.order];
-    for (int i = 0; i < T.order; i++) {
+    for (int i=0; i<T.order; i++){
+      idx[i] = 'a'+i;
+      core_idx[i] = 'a'+i;
       lens[i] = T.lens[i];
-    } 
-    for (int i = 1; i < T.order+1; i++) {
-      lens[i-1] = ranks[i-1];
-      Tensor<dtype> core(T.order, lens,  *(T.wrld));
-      core_tensors[i] = core;   
     }
+    idx[T.order] = '\0';
+    core_idx[T.order] = '\0';
+    Tensor<dtype> cur(T);
+    for (int i=0; i<T.order; i++){
+      lens[i] = ranks[i];
+      core_idx[i] = 'z';
+      Matrix<dtype> Uc(factor_matrices[i]);
+      CTF_int::conj_tensor(Uc);
+      char factor_idx[] = {idx[i], 'z', '\0'};
+      Tensor<dtype> next(T.order, lens, *T.wrld, *T.sr);
+      next[core_idx] = Uc[factor_idx]*cur[idx];
+      cur = next;
+      core_idx[i] = idx[i];
+    }
+    core_tensor = cur;
+  }
 
-    //calculate core tensor
-    char arg[T.order];
-    char core_arg[T.order];
-    for (int i = 0; i < T.order; i++) {
-      arg[i] = 'i' + i;
-      core_arg[i] = 'i' + i;
+  template<typename dtype>
+  HoSVD<dtype>::HoSVD(int order, int const * lens, int const * ranks, World & wrld) {
+    core_tensor = Tensor<dtype>(order, ranks, wrld);
+    for (int i=0; i<order; i++){
+      factor_matrices.push_back(Matrix<dtype>(lens[i], ranks[i], wrld));
     }
-    char matrix_arg[2];
-    matrix_arg[0] = 'a';
-    for (int i = 0; i < T.order; i++) {
-      core_arg[i] = 'a';
-      matrix_arg[1] = arg[i];
-      Matrix<dtype> transpose(factor_matrices[i].ncol, factor_matrices[i].nrow, *(T.wrld)); 
-      transpose["ij"] = factor_matrices[i]["ji"];
-      core_tensors[i+1][core_arg] = transpose[matrix_arg] * core_tensors[i][arg];
-      core_arg[i] = arg[i];
+  }
+
+
+  template<typename dtype>
+  void MTTKRP(Tensor<dtype> &                 T,
+              std::vector< Matrix<dtype> > &  factors,
+              int                             mode,
+              Matrix<dtype> &                 M){
+    int R = factors[(mode+1)%T.order].ncol;
+    if (T.is_sparse){
+      CTF_int::sp_mttkrp_plan<dtype> plan(T, R);
+      plan.mttkrp(factors, mode, M);
+      return;
     }
-    return core_tensors[T.order];
+    std::vector<int> modes;
+    for (int j=0; j<T.order; j++) modes.push_back(j);
+    Tensor<dtype> * X = &T;
+    bool has_r = false;
+    // contract the largest remaining mode first, so that each intermediate is as small as possible
+    while (modes.size() > 1){
+      int j = -1;
+      for (int k=0; k<(int)modes.size(); k++){
+        if (modes[k] != mode && (j == -1 || T.lens[modes[k]] > T.lens[j])) j = modes[k];
+      }
+      std::vector<int> ymodes;
+      int lens[modes.size()];
+      for (int k=0; k<(int)modes.size(); k++){
+        if (modes[k] != j){
+          lens[ymodes.size()] = T.lens[modes[k]];
+          ymodes.push_back(modes[k]);
+        }
+      }
+      lens[ymodes.size()] = R;
+      Tensor<dtype> * Y = new Tensor<dtype>(ymodes.size()+1, lens, *T.wrld, *T.sr);
+      CTF_int::contract_factor(*X, modes, has_r, j, factors[j], *Y);
+      if (X != &T) delete X;
+      X = Y;
+      modes = ymodes;
+      has_r = true;
+    }
+    char idx[] = {(char)('a'+mode), 'z', '\0'};
+    M[idx] = (*X)[idx];
+    if (X != &T) delete X;
   }
 
   template<typename dtype>
-  void HoSVD::HoSVD(Tensor<dtype>& T, int * ranks) {
-    factor_matrices = get_factor_matrices(T, ranks);
-	  core_tensor = get_core_tensor(T, factor_matrices, ranks); 
+  CPD<dtype>::CPD(int order, int const * lens, int rank_, World & wrld){
+    rank = rank_;
+    for (int i=0; i<order; i++){
+      factor_matrices.push_back(Matrix<dtype>(lens[i], rank, wrld));
+      CTF_int::fill_rand_sample(factor_matrices[i]);
+    }
+    sp_plan = NULL;
+    tsr = NULL;
   }
 
   template<typename dtype>
-  void HoSVD::HoSVD(int * lens, int * ranks) {
-    //initialize to zero
-    assert(0);
-    /*factor_matrices = get_factor_matrices(T, ranks);
-	  core_tensor = get_core_tensor(T, factor_matrices, ranks); */
+  CPD<dtype>::CPD(Tensor<dtype> & T, int rank_, int niter, double tol){
+    rank = rank_;
+    for (int i=0; i<T.order; i++){
+      factor_matrices.push_back(Matrix<dtype>(T.lens[i], rank, *T.wrld, *T.sr));
+      CTF_int::fill_rand_sample(factor_matrices[i]);
+    }
+    sp_plan = NULL;
+    tsr = NULL;
+    als(T, niter, tol);
   }
 
-}
-   
+  template<typename dtype>
+  CPD<dtype>::~CPD(){
+    for (int i=0; i<(int)dtree.size(); i++) delete dtree[i];
+    for (int i=0; i<(int)grams.size(); i++) CTF_int::cdealloc(grams[i]);
+    if (sp_plan != NULL) delete sp_plan;
+  }
+
+  template<typename dtype>
+  void CPD<dtype>::update_factor(int mode, Tensor<dtype> & M){
+    int N = factor_matrices.size();
+    World & dw = *factor_matrices[mode].wrld;
+    CTF_int::algstrct const & sr = *factor_matrices[mode].sr;
+    // U_mode = M * (Hadamard product of the Gram matrices of the other factors)^{-1}
+    dtype * H = (dtype*)CTF_int::alloc(sizeof(dtype)*rank*rank);
+    if (dw.rank == 0){
+      dtype * H0 = (dtype*)CTF_int::alloc(sizeof(dtype)*rank*rank);
+      std::fill(H0, H0+rank*rank, (dtype)1);
+      for (int j=0; j<N; j++){
+        if (j == mode) continue;
+        for (int i=0; i<rank*rank; i++) H0[i] *= grams[j][i];
+      }
+      // regularize if the Hadamard product is numerically singular, which happens e.g. if a factor has collinear columns
+      double shift = 0.;
+      double trace = 0.;
+      for (int i=0; i<rank; i++) trace += std::abs(H0[i+i*rank]);
+      do {
+        memcpy(H, H0, sizeof(dtype)*rank*rank);
+        for (int i=0; i<rank; i++) H[i+i*rank] += shift;
+        shift = shift == 0. ? 1.E-14*trace : shift*100.;
+      } while (!CTF_int::spd_inverse<dtype>(rank, H) && shift < trace);
+      CTF_int::cdealloc(H0);
+    }
+    Matrix<dtype> Hinv(rank, rank, dw, sr);
+    CTF_int::write_from_root(Hinv, ((int64_t)rank)*rank, H);
+    CTF_int::cdealloc(H);
+
+    char midx[] = {(char)('a'+mode), 'z', '\0'};
+    char uidx[] = {(char)('a'+mode), 'y', '\0'};
+    factor_matrices[mode][uidx] = M[midx]*Hinv["zy"];
+
+    Matrix<dtype> G(rank, rank, dw, sr);
+    G["zy"] = factor_matrices[mode][midx]*factor_matrices[mode][uidx];
+    G.read_all(grams[mode]);
+  }
+
+  template<typename dtype>
+  Tensor<dtype> * CPD<dtype>::dtree_contract(Tensor<dtype> *          X,
+                                             std::vector<int> const & modes,
+                                             bool                     has_r,
+                                             std::vector<int> const & cmodes,
+                                             int &                    step){
+    std::vector<int> cur_modes = modes;
+    std::vector<int> rem = cmodes;
+    Tensor<dtype> * cur = X;
+    bool cur_r = has_r;
+    while (rem.size() > 0){
+      int jj = 0;
+      for (int k=1; k<(int)rem.size(); k++){
+        if (factor_matrices[rem[k]].nrow > factor_matrices[rem[jj]].nrow) jj = k;
+      }
+      int j = rem[jj];
+      rem.erase(rem.begin()+jj);
+      if (step == (int)dtree.size()){
+        int lens[cur_modes.size()];
+        int nl = 0;
+        for (int k=0; k<(int)cur_modes.size(); k++){
+          if (cur_modes[k] != j) lens[nl++] = factor_matrices[cur_modes[k]].nrow;
+        }
+        lens[nl++] = rank;
+        dtree.push_back(new Tensor<dtype>(nl, lens, *X->wrld, *X->sr));
+      }
+      CTF_int::contract_factor(*cur, cur_modes, cur_r, j, factor_matrices[j], *dtree[step]);
+      cur = dtree[step];
+      step++;
+      cur_modes.erase(std::find(cur_modes.begin(), cur_modes.end(), j));
+      cur_r = true;
+    }
+    return cur;
+  }
+
+  template<typename dtype>
+  void CPD<dtype>::dtree_sweep(Tensor<dtype> *          X,
+                               std::vector<int> const & modes,
+                               bool                     has_r,
+                               int &                    step,
+                               Tensor<dtype> *&         M_last){
+    if (modes.size() == 1){
+      update_factor(modes[0], *X);
+      M_last = X;
+      return;
+    }
+    // the first half of the modes is updated from X contracted with the factors of the second half and vice versa,
+    // so each partial contraction is shared by all modes in its half
+    int h = modes.size()/2;
+    std::vector<int> lmodes(modes.begin(), modes.begin()+h);
+    std::vector<int> rmodes(modes.begin()+h, modes.end());
+    Tensor<dtype> * XL = dtree_contract(X, modes, has_r, rmodes, step);
+    dtree_sweep(XL, lmodes, true, step, M_last);
+    Tensor<dtype> * XR = dtree_contract(X, modes, has_r, lmodes, step);
+    dtree_sweep(XR, rmodes, true, step, M_last);
+  }
+
+  template<typename dtype>
+  double CPD<dtype>::als(Tensor<dtype> & T, int niter, double tol){
+    int N = T.order;
+    IASSERT(N >= 2 && N <= 25 && N == (int)factor_matrices.size());
+    World & dw = *T.wrld;
+    if (tsr != &T){
+      // intermediates and plans are specific to the tensor being decomposed
+      for (int i=0; i<(int)dtree.size(); i++) delete dtree[i];
+      dtree.clear();
+      if (sp_plan != NULL) delete sp_plan;
+      sp_plan = NULL;
+      if (T.is_sparse) sp_plan = new CTF_int::sp_mttkrp_plan<dtype>(T, rank);
+      tsr = &T;
+    }
+    if (grams.size() == 0){
+      for (int j=0; j<N; j++) grams.push_back((dtype*)CTF_int::alloc(sizeof(dtype)*rank*rank));
+    }
+    for (int j=0; j<N; j++){
+      char u1[] = {(char)('a'+j), 'z', '\0'};
+      char u2[] = {(char)('a'+j), 'y', '\0'};
+      Matrix<dtype> G(rank, rank, dw, *T.sr);
+      G["zy"] = factor_matrices[j][u1]*factor_matrices[j][u2];
+      G.read_all(grams[j]);
+    }
 
+    double nrm_T;
+    T.norm2(nrm_T);
+    double fit = 0., fit_old = 0.;
+    for (int it=0; it<niter; it++){
+      Tensor<dtype> * M_last;
+      if (T.is_sparse){
+        for (int n=0; n<N; n++){
+          if (n == (int)dtree.size()){
+            int lens[] = {T.lens[n], rank};
+            dtree.push_back(new Tensor<dtype>(2, lens, dw, *T.sr));
+          }
+          sp_plan->mttkrp(factor_matrices, n, *dtree[n]);
+          update_factor(n, *dtree[n]);
+        }
+        M_last = dtree[N-1];
+      } else {
+        std::vector<int> modes;
+        for (int j=0; j<N; j++) modes.push_back(j);
+        int step = 0;
+        dtree_sweep(&T, modes, false, step, M_last);
+      }
 
+      // ||T-[[U]]||^2 = ||T||^2 - 2<T,[[U]]> + ||[[U]]||^2, where <T,[[U]]> = sum(M_last .* U_{N-1}) and ||[[U]]||^2 = sum(Hadamard of all Gram matrices)
+      char idx[] = {(char)('a'+N-1), 'z', '\0'};
+      Scalar<dtype> inner(dw, *T.sr);
+      inner[""] = (*M_last)[idx]*factor_matrices[N-1][idx];
+      double nrm_model = 0.;
+      for (int i=0; i<rank*rank; i++){
+        dtype p = 1;
+        for (int j=0; j<N; j++) p *= grams[j][i];
+        nrm_model += (double)p;
+      }
+      double res2 = nrm_T*nrm_T - 2.*(double)inner.get_val() + nrm_model;
+      fit_old = fit;
+      fit = 1. - std::sqrt(std::max(res2, 0.))/nrm_T;
+      if (it > 0 && std::abs(fit - fit_old) < tol) break;
+    }
+    return fit;
+  }
+
+  template<typename dtype>
+  CTF_int::Contract_Term CPD<dtype>::operator[](char const * idx_map){
+    // rank index must not clash with the outer ones
+    char r = 'A';
+    while (strchr(idx_map, r) != NULL) r++;
+    char idx0[] = {idx_map[0], r, '\0'};
+    char idx1[] = {idx_map[1], r, '\0'};
+    return CTF_int::mult_cp_factors(factor_matrices[0][idx0]*factor_matrices[1][idx1], 2, factor_matrices, idx_map, r);
+  }
+
+}
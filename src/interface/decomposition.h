@@ -3,47 +3,130 @@
 #include "tensor.h"
 #include "matrix.h"
 #include "vector.h"
+namespace CTF_int {
+  template<typename dtype> struct sp_mttkrp_plan;
+}
+
 namespace CTF {
- 
-  void fold_unfold(Tensor<dtype>& X, Tensor<dtype>& Y);
 
-  template<typename dtype>  
+  template<typename dtype>
   class Decomposition {
     public:
       /**
        * \brief associated an index map with the tensor decomposition for algebra
        * \param[in] idx_map index assignment for this tensor
        */
-      virtual Contract_Term operator[](char const * idx_map) = 0;
+      virtual CTF_int::Contract_Term operator[](char const * idx_map) = 0;
+
+      virtual ~Decomposition(){}
   };
 
-  template<typename dtype>  
-  class HoSVD : public Decomposition {
+  template<typename dtype>
+  class HoSVD : public Decomposition<dtype> {
     public:
       Tensor<dtype> core_tensor;
       std::vector< Matrix<dtype> > factor_matrices;
 
       /**
-       * \calculate higher order singular value decomposition of a tensor
+       * \calculate higher order singular value decomposition of a tensor,
+       *  the factor matrices are found by randomized range finders on the mode unfoldings of T,
+       *  which are applied as contractions with T rather than formed explicitly
+       * \param[in] T tensor to decompose, may be sparse
        * \param[in] ranks ranks(dimensions) of the core tensor and factor matrices
+       * \param[in] iter number of power iterations of each range finder
+       * \param[in] oversamp number of additional random vectors used by each range finder
        */
-      HoSVD(Tensor<dtype> T, int * ranks);
+      HoSVD(Tensor<dtype> & T, int const * ranks, int iter=1, int oversamp=5);
 
       /**
        * \calculate initialize a higher order singular value decomposition of a tensor to zero
+       * \param[in] order number of modes of the factored tensor
        * \param[in] lens ranks(dimensions) of the factored tensor
        * \param[in] ranks ranks(dimensions) of the core tensor and factor matrices
+       * \param[in] wrld CTF world where the decomposition will live
        */
-      HoSVD(int * lens, int * ranks);
+      HoSVD(int order, int const * lens, int const * ranks, World & wrld=get_universe());
 
       /**
        * \brief associated an index map with the tensor decomposition for algebra
        * \param[in] idx_map index assignment for this tensor
        */
-      Contract_Term operator[](char const * idx_map);
+      CTF_int::Contract_Term operator[](char const * idx_map);
 
   };
 
-}
+  /**
+   * \brief matricized tensor times Khatri-Rao product, M["ir"] = sum over all indices of T but mode of T * prod_{j != mode} U_j["i_j r"],
+   *        the Khatri-Rao product of the factor matrices is never formed, for dense T the factors are contracted with T one mode
+   *        at a time (largest mode first), for sparse T a fused kernel multiplies each local nonzero by the rows of the factors
+   *        it touches and accumulates into the rows of M
+   * \param[in] T tensor
+   * \param[in] factors factor matrices, factors[j] is T.lens[j]-by-R, factors[mode] is ignored
+   * \param[in] mode mode that is not contracted
+   * \param[out] M T.lens[mode]-by-R result
+   */
+  template<typename dtype>
+  void MTTKRP(Tensor<dtype> &                 T,
+              std::vector< Matrix<dtype> > &  factors,
+              int                             mode,
+              Matrix<dtype> &                 M);
+
+  template<typename dtype>
+  class CPD : public Decomposition<dtype> {
+    public:
+      int rank;
+      std::vector< Matrix<dtype> > factor_matrices;
+
+      /**
+       * \brief initializes a rank-R canonical polyadic decomposition with random factor matrices
+       * \param[in] order number of modes of the factored tensor
+       * \param[in] lens dimensions of the factored tensor
+       * \param[in] rank number of rank-one terms R
+       * \param[in] wrld CTF world where the decomposition will live
+       */
+      CPD(int order, int const * lens, int rank, World & wrld=get_universe());
+
+      /**
+       * \brief computes a rank-R canonical polyadic decomposition of a real-valued tensor by alternating least squares
+       * \param[in] T tensor to decompose, may be sparse
+       * \param[in] rank number of rank-one terms R
+       * \param[in] niter maximum number of ALS sweeps
+       * \param[in] tol sweeps stop once the fit improves by less than tol
+       */
+      CPD(Tensor<dtype> & T, int rank, int niter=50, double tol=1.E-6);
 
+      ~CPD();
+
+      /**
+       * \brief performs ALS sweeps starting from the current factor matrices, each sweep updates every factor matrix by
+       *        U_n = MTTKRP(T, n) * (Hadamard product of U_j^T U_j over j != n)^{-1}.
+       *        For dense T the MTTKRPs of a sweep share partial contractions through a binary dimension tree, for sparse T
+       *        the local nonzeros and the factor rows they touch are extracted once and reused by every sweep.
+       *        The intermediate tensors are kept across sweeps, so contractions in later sweeps find them already mapped.
+       * \param[in] T tensor to decompose, may be sparse
+       * \param[in] niter maximum number of ALS sweeps
+       * \param[in] tol sweeps stop once the fit improves by less than tol
+       * \return fit 1-||T-[[U_0,...,U_{N-1}]]||/||T|| after the last sweep
+       */
+      double als(Tensor<dtype> & T, int niter, double tol=1.E-6);
+
+      /**
+       * \brief associated an index map with the tensor decomposition for algebra
+       * \param[in] idx_map index assignment for this tensor
+       */
+      CTF_int::Contract_Term operator[](char const * idx_map);
+
+    private:
+      std::vector< Tensor<dtype>* > dtree;
+      std::vector< dtype* > grams;
+      CTF_int::sp_mttkrp_plan<dtype> * sp_plan;
+      Tensor<dtype> const * tsr;
+
+      void update_factor(int mode, Tensor<dtype> & M);
+      Tensor<dtype> * dtree_contract(Tensor<dtype> * X, std::vector<int> const & modes, bool has_r, std::vector<int> const & cmodes, int & step);
+      void dtree_sweep(Tensor<dtype> * X, std::vector<int> const & modes, bool has_r, int & step, Tensor<dtype> *& M_last);
+  };
+
+}
+#include "decomposition.cxx"
 #endif
@@ -4,6 +4,7 @@
 #include "../scaling/scaling.h"
 #include "../summation/summation.h"
 #include "../contraction/contraction.h"
+#include "../sparse_formats/csr.h"
 
 
 namespace CTF {
@@ -204,22 +205,9 @@ namespace CTF {
                  dtype_C *        C,
                  CTF_int::algstrct const * sr_C) const {
         //TAU_FSTART(3type_csrmm);
-  #ifdef _OPENMP
-        #pragma omp parallel for
-  #endif
-        for (int row_A=0; row_A<m; row_A++){
-  #ifdef _OPENMP
-          #pragma omp parallel for
-  #endif
-          for (int col_B=0; col_B<n; col_B++){
-            for (int i_A=IA[row_A]-1; i_A<IA[row_A+1]-1; i_A++){
-              int col_A = JA[i_A]-1;
-              dtype_C tmp = f(A[i_A],B[col_B*k+col_A]);
-              sr_C->add((char const *)&C[col_B*m+row_A],(char const*)&tmp,(char *)&C[col_B*m+row_A]);
-
-            }
-          }
-        }
+        CTF_int::csrmm_merge_path(m, n, k, A, JA, IA, B, C, f,
+                                  [=](dtype_C a, dtype_C b){ dtype_C c; sr_C->add((char const*)&a, (char const*)&b, (char*)&c); return c; },
+                                  [=](dtype_C & c, dtype_C s){ sr_C->add((char const*)&c, (char const*)&s, (char*)&c); });
         //TAU_FSTOP(3type_csrmm);
       }
 
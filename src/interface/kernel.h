@@ -255,20 +255,10 @@ namespace CTF{
                       dtype_B const * B,
                       dtype_C *       C){
       //TAU_FSTART(3type_csrmm);
-#ifdef _OPENMP
-      #pragma omp parallel for
-#endif
-      for (int row_A=0; row_A<m; row_A++){
-#ifdef _OPENMP
-        #pragma omp parallel for
-#endif
-        for (int col_B=0; col_B<n; col_B++){
-          for (int i_A=IA[row_A]-1; i_A<IA[row_A+1]-1; i_A++){
-            int col_A = JA[i_A]-1;
-            g(f(A[i_A],B[col_B*k+col_A]),C[col_B*m+row_A]);
-          }
-        }
-      }
+      CTF_int::csrmm_merge_path(m, n, k, A, JA, IA, B, C,
+                                [](dtype_A a, dtype_B b){ return f(a, b); },
+                                [](dtype_C a, dtype_C b){ g(a, b); return b; },
+                                [](dtype_C & c, dtype_C s){ g(s, c); });
       //TAU_FSTOP(3type_csrmm);
     }
     void cgemm(char         tA,
@@ -208,6 +208,7 @@ namespace CTF {
                                 int           csrc,
                                 int           lda,
                                 dtype const * data_){
+    this->go_home();
     if (mb==1 && nb==1 && nrow%pr==0 && ncol%pc==0 && rsrc==0 && csrc==0){
       if (this->edge_map[0].np == pr && this->edge_map[1].np == pc){
         if (lda == nrow/pc){
@@ -252,6 +253,7 @@ namespace CTF {
                                int     csrc,
                                int     lda,
                                dtype * data_){
+    this->go_home();
     //FIXME: (1) can optimize sparse for this case (mapping cyclic), (2) can use permute to avoid sparse redistribution always
     if (!this->is_sparse && (mb==1 && nb==1 && nrow%pr==0 && ncol%pc==0 && rsrc==0 && csrc==0)){
       if (this->edge_map[0].np == pr && this->edge_map[1].np == pc){
@@ -294,6 +296,7 @@ namespace CTF {
 
   template<typename dtype>
   void Matrix<dtype>::get_desc(int & ictxt, int *& desc){
+    this->go_home();
     int pr, pc;
     pr = this->edge_map[0].calc_phase();       
     pc = this->edge_map[1].calc_phase();       
@@ -420,14 +423,293 @@ namespace CTF {
 
 
 
+}
+
+namespace CTF_int {
+  /**
+   * \brief complex conjugate of a scalar, identity for real types
+   */
+  template <typename dtype>
+  dtype conj_val(dtype a){ return a; }
+
+  template <typename rtype>
+  std::complex<rtype> conj_val(std::complex<rtype> a){ return std::conj(a); }
+
+  /**
+   * \brief conjugates the elements of a dense tensor in place, no-op for real types
+   * \param[in,out] A dense tensor
+   */
+  template <typename dtype>
+  void conj_tensor(CTF::Tensor<dtype> & A){ }
+
+  template <typename rtype>
+  void conj_tensor(CTF::Tensor< std::complex<rtype> > & A){
+    int64_t sz;
+    std::complex<rtype> * data = A.get_raw_data(&sz);
+    for (int64_t i=0; i<sz; i++){
+      data[i] = std::conj(data[i]);
+    }
+  }
+
+  /**
+   * \brief fills a dense tensor with random values in [-1,1), used to sample the range of an operator
+   * \param[in,out] A dense tensor
+   */
+  template <typename dtype>
+  void fill_rand_sample(CTF::Tensor<dtype> & A){
+    int64_t sz;
+    dtype * data = A.get_raw_data(&sz);
+    for (int64_t i=0; i<sz; i++){
+      data[i] = (dtype)(2.*get_rand48()-1.);
+    }
+    A.zero_out_padding();
+  }
+
+  /**
+   * \brief writes a replicated dense array into a tensor from the root process,
+   *        the array is ordered like the global indices of the tensor (first mode fastest)
+   * \param[in,out] A tensor to write to
+   * \param[in] n number of elements
+   * \param[in] data elements, only read on the root process
+   */
+  template <typename dtype>
+  void write_from_root(CTF::Tensor<dtype> & A, int64_t n, dtype const * data){
+    int64_t npair = A.wrld->rank == 0 ? n : 0;
+    int64_t * inds = (int64_t*)alloc(sizeof(int64_t)*npair);
+    for (int64_t i=0; i<npair; i++){
+      inds[i] = i;
+    }
+    A.write(npair, inds, data);
+    cdealloc(inds);
+  }
+
+  /**
+   * \brief computes the QR factorization of a matrix whose rows are distributed over the processes of cm
+   *        via TSQR: a local QR of the rows owned by each process, followed by a binary reduction tree
+   *        that factorizes pairs of stacked R factors [R_a; R_b], the Q factors of the tree are then
+   *        applied back down, so that each process obtains its rows of Q without any further communication
+   * \param[in] mloc number of rows owned by this process
+   * \param[in] n number of columns
+   * \param[in,out] A on input local rows of A, on output local rows of Q (column-major, leading dimension mloc)
+   * \param[out] R n-by-n upper-triangular factor (column-major), same on all processes
+   * \param[in] cm communicator over which the rows of A are distributed
+   */
+  template <typename dtype>
+  void tsqr(int mloc, int n, dtype * A, dtype * R, MPI_Comm cm){
+    int rank, np, info, lwork;
+    MPI_Comm_rank(cm, &rank);
+    MPI_Comm_size(cm, &np);
+    bool is_custom;
+    MPI_Datatype mdtype = get_default_mdtype<dtype>(is_custom);
+    dtype dlwork;
+
+    // local QR, padding the local rows to at least n so that R is square
+    int mb = std::max(mloc, n);
+    dtype * QL = (dtype*)alloc(sizeof(dtype)*mb*n);
+    dtype * tau = (dtype*)alloc(sizeof(dtype)*n);
+    std::fill(QL, QL+mb*n, (dtype)0);
+    for (int j=0; j<n; j++){
+      memcpy(QL+j*mb, A+j*mloc, sizeof(dtype)*mloc);
+    }
+    CTF_LAPACK::geqrf<dtype>(mb, n, QL, mb, tau, &dlwork, -1, &info);
+    lwork = (int)std::real(dlwork);
+    CTF_LAPACK::orgqr<dtype>(mb, n, n, QL, mb, tau, &dlwork, -1, &info);
+    lwork = std::max(lwork, (int)std::real(dlwork));
+    CTF_LAPACK::geqrf<dtype>(2*n, n, QL, 2*n, tau, &dlwork, -1, &info);
+    lwork = std::max(lwork, (int)std::real(dlwork));
+    CTF_LAPACK::orgqr<dtype>(2*n, n, n, QL, 2*n, tau, &dlwork, -1, &info);
+    lwork = std::max(lwork, std::max(n, (int)std::real(dlwork)));
+    dtype * work = (dtype*)alloc(sizeof(dtype)*lwork);
+    CTF_LAPACK::geqrf<dtype>(mb, n, QL, mb, tau, work, lwork, &info);
+    for (int j=0; j<n; j++){
+      for (int i=0; i<n; i++){
+        R[i+j*n] = i <= j ? QL[i+j*mb] : (dtype)0;
+      }
+    }
+    CTF_LAPACK::orgqr<dtype>(mb, n, n, QL, mb, tau, work, lwork, &info);
+
+    // reduction tree, process rank factorizes [R_rank; R_{rank+s}] at level log2(s) and keeps its explicit Q factor
+    int nlvl = 0;
+    while ((1<<nlvl) < np) nlvl++;
+    dtype ** QT = (dtype**)alloc(sizeof(dtype*)*(nlvl+1));
+    dtype * Rb = (dtype*)alloc(sizeof(dtype)*n*n);
+    int lvl;
+    for (lvl=0; lvl<nlvl; lvl++){
+      int s = 1<<lvl;
+      QT[lvl] = NULL;
+      if (rank % (2*s) == s){
+        MPI_Send(R, n*n, mdtype, rank-s, lvl, cm);
+        break;
+      }
+      if (rank + s < np){
+        MPI_Recv(Rb, n*n, mdtype, rank+s, lvl, cm, MPI_STATUS_IGNORE);
+        QT[lvl] = (dtype*)alloc(sizeof(dtype)*2*n*n);
+        for (int j=0; j<n; j++){
+          memcpy(QT[lvl]+j*2*n, R+j*n, sizeof(dtype)*n);
+          memcpy(QT[lvl]+j*2*n+n, Rb+j*n, sizeof(dtype)*n);
+        }
+        CTF_LAPACK::geqrf<dtype>(2*n, n, QT[lvl], 2*n, tau, work, lwork, &info);
+        for (int j=0; j<n; j++){
+          for (int i=0; i<=j; i++){
+            R[i+j*n] = QT[lvl][i+j*2*n];
+          }
+        }
+        CTF_LAPACK::orgqr<dtype>(2*n, n, n, QT[lvl], 2*n, tau, work, lwork, &info);
+      }
+    }
+
+    // apply the tree back down, B transforms the Q factor below this process into its part of the global Q
+    dtype * B = (dtype*)alloc(sizeof(dtype)*n*n);
+    dtype * C = (dtype*)alloc(sizeof(dtype)*2*n*n);
+    dtype one = 1, zero = 0;
+    int n2 = 2*n;
+    if (lvl == nlvl){
+      std::fill(B, B+n*n, (dtype)0);
+      for (int i=0; i<n; i++) B[i+i*n] = 1;
+    } else
+      MPI_Recv(B, n*n, mdtype, rank-(1<<lvl), nlvl+lvl, cm, MPI_STATUS_IGNORE);
+    for (int l=lvl-1; l>=0; l--){
+      if (QT[l] == NULL) continue;
+      CTF_BLAS::gemm<dtype>("N", "N", &n2, &n, &n, &one, QT[l], &n2, B, &n, &zero, C, &n2);
+      for (int j=0; j<n; j++){
+        memcpy(B+j*n, C+j*2*n, sizeof(dtype)*n);
+        memcpy(Rb+j*n, C+j*2*n+n, sizeof(dtype)*n);
+      }
+      MPI_Send(Rb, n*n, mdtype, rank+(1<<l), nlvl+l, cm);
+      cdealloc(QT[l]);
+    }
+    if (mloc > 0)
+      CTF_BLAS::gemm<dtype>("N", "N", &mloc, &n, &n, &one, QL, &mb, B, &n, &zero, A, &mloc);
+    MPI_Bcast(R, n*n, mdtype, 0, cm);
+
+    cdealloc(C);
+    cdealloc(B);
+    cdealloc(Rb);
+    cdealloc(QT);
+    cdealloc(work);
+    cdealloc(tau);
+    cdealloc(QL);
+  }
+
+  /**
+   * \brief computes the QR factorization of a matrix whose rows are distributed over the processes of cm
+   *        via Cholesky-QR, R is the Cholesky factor of the Gram matrix A^H A and Q = A R^{-1}
+   * \param[in] mloc number of rows owned by this process
+   * \param[in] n number of columns
+   * \param[in,out] A on input local rows of A, on output local rows of Q (column-major, leading dimension mloc),
+   *                  left unmodified if the factorization fails
+   * \param[out] R n-by-n upper-triangular factor (column-major), same on all processes
+   * \param[in] cm communicator over which the rows of A are distributed
+   * \return false if the Gram matrix is not numerically positive definite
+   */
+  template <typename dtype>
+  bool cholqr(int mloc, int n, dtype * A, dtype * R, MPI_Comm cm){
+    int info;
+    bool is_custom;
+    MPI_Datatype mdtype = get_default_mdtype<dtype>(is_custom);
+    dtype one = 1, zero = 0;
+    if (mloc > 0)
+      CTF_BLAS::gemm<dtype>("C", "N", &n, &n, &mloc, &one, A, &mloc, A, &mloc, &zero, R, &n);
+    else
+      std::fill(R, R+n*n, (dtype)0);
+    MPI_Allreduce(MPI_IN_PLACE, R, n*n, mdtype, MPI_SUM, cm);
+    CTF_LAPACK::potrf<dtype>('U', n, R, n, &info);
+    if (info != 0) return false;
+    for (int j=0; j<n; j++){
+      for (int i=j+1; i<n; i++){
+        R[i+j*n] = 0;
+      }
+    }
+    if (mloc > 0)
+      CTF_BLAS::trsm<dtype>("R", "U", "N", "N", &mloc, &n, &one, R, &n, A, &mloc);
+    return true;
+  }
+
+  /**
+   * \brief computes the QR factorization of a matrix whose rows are distributed over the processes of cm
+   *        via Cholesky-QR2, a second pass of Cholesky-QR on the computed Q restores its orthogonality,
+   *        falls back to TSQR for either pass that breaks down
+   * \param[in] mloc number of rows owned by this process
+   * \param[in] n number of columns
+   * \param[in,out] A on input local rows of A, on output local rows of Q (column-major, leading dimension mloc)
+   * \param[out] R n-by-n upper-triangular factor (column-major), same on all processes
+   * \param[in] cm communicator over which the rows of A are distributed
+   */
+  template <typename dtype>
+  void cholqr2(int mloc, int n, dtype * A, dtype * R, MPI_Comm cm){
+    dtype * R1 = (dtype*)alloc(sizeof(dtype)*n*n);
+    dtype * R2 = (dtype*)alloc(sizeof(dtype)*n*n);
+    dtype one = 1, zero = 0;
+    if (!cholqr<dtype>(mloc, n, A, R1, cm))
+      tsqr<dtype>(mloc, n, A, R1, cm);
+    if (!cholqr<dtype>(mloc, n, A, R2, cm))
+      tsqr<dtype>(mloc, n, A, R2, cm);
+    CTF_BLAS::gemm<dtype>("N", "N", &n, &n, &n, &one, R2, &n, R1, &n, &zero, R, &n);
+    cdealloc(R2);
+    cdealloc(R1);
+  }
+}
+
+namespace CTF {
   template<typename dtype>
-  void Matrix<dtype>::qr(Matrix<dtype> & Q, Matrix<dtype> & R){
+  void Matrix<dtype>::qr(Matrix<dtype> & Q, Matrix<dtype> & R, QR_ALG alg){
 
     int info;
 
     int m = this->nrow;
     int n = this->ncol;
 
+    if (alg == QR_DEFAULT){
+#ifdef USE_SCALAPACK
+      alg = (m >= n*this->wrld->np) ? QR_TSQR : QR_SCALAPACK;
+#else
+      alg = QR_TSQR;
+#endif
+    }
+    if (alg != QR_SCALAPACK){
+      IASSERT(m >= n);
+      // distribute rows cyclically over all processes and keep columns local, so each process owns whole rows
+      int np = this->wrld->np;
+      Partition prow(1, &np);
+      Q = Matrix<dtype>(m, n, "ij", prow["i"], Idx_Partition(), 0, *this->wrld, *this->sr);
+      Q["ij"] = (*this)["ij"];
+      int64_t sz;
+      dtype * dQ = Q.get_raw_data(&sz);
+      int mloc = sz/n;
+      dtype * dR = (dtype*)CTF_int::alloc(sizeof(dtype)*n*n);
+      if (alg == QR_CHOLQR2)
+        CTF_int::cholqr2<dtype>(mloc, n, dQ, dR, this->wrld->comm);
+      else
+        CTF_int::tsqr<dtype>(mloc, n, dQ, dR, this->wrld->comm);
+      // padding rows must remain zero
+      int phase = Q.edge_map[0].calc_phase();
+      int prank = Q.edge_map[0].calc_phys_rank(Q.topo);
+      for (int i=0; i<mloc; i++){
+        if ((int64_t)i*phase + prank >= m){
+          for (int j=0; j<n; j++) dQ[i+j*mloc] = 0;
+        }
+      }
+      R = Matrix<dtype>(n, n, *this->wrld, *this->sr);
+      int64_t npair = this->wrld->rank == 0 ? ((int64_t)n*(n+1))/2 : 0;
+      int64_t * inds = (int64_t*)CTF_int::alloc(sizeof(int64_t)*npair);
+      dtype * vals = (dtype*)CTF_int::alloc(sizeof(dtype)*npair);
+      npair = 0;
+      if (this->wrld->rank == 0){
+        for (int j=0; j<n; j++){
+          for (int i=0; i<=j; i++){
+            inds[npair] = i+((int64_t)j)*n;
+            vals[npair] = dR[i+j*n];
+            npair++;
+          }
+        }
+      }
+      R.write(npair, inds, vals);
+      CTF_int::cdealloc(vals);
+      CTF_int::cdealloc(inds);
+      CTF_int::cdealloc(dR);
+      return;
+    }
+
     int * desca;// = (int*)malloc(9*sizeof(int));
 
     int ictxt;
@@ -529,7 +811,7 @@ namespace CTF {
     dtype * s_data = S.get_raw_data(&sc);
 
     int phase = S.edge_map[0].calc_phase();
-    if (this->wrld->rank < phase){
+    if ((this->wrld->rank) < phase){
       for (int i = S.edge_map[0].calc_phys_rank(S.topo); i < k; i += phase) {
         s_data[i/phase] = s[i];
       } 
@@ -550,6 +832,87 @@ namespace CTF {
     free(work);
 
   }
-  
+
+  template<typename dtype>
+  void Matrix<dtype>::svd_rand(Matrix<dtype> & U, Vector<dtype> & S, Matrix<dtype> & VT, int rank, int iter, int oversamp){
+    int m = this->nrow;
+    int n = this->ncol;
+    int k = std::min(std::min(m, n), rank+oversamp);
+    IASSERT(rank > 0 && rank <= k);
+    World & dw = *this->wrld;
+    CTF_int::algstrct const & sr = *this->sr;
+
+    // orthonormal basis Q for the range of A sampled by random vectors
+    Matrix<dtype> Omega(n, k, dw, sr);
+    CTF_int::fill_rand_sample(Omega);
+    Matrix<dtype> Y(m, k, dw, sr);
+    Y["ir"] = (*this)["ij"]*Omega["jr"];
+    Matrix<dtype> Q, Qz, R;
+    Y.qr(Q, R);
+    // A^H Q is computed as conj(A^T conj(Q)), so that A, which may be sparse, is never conjugated
+    Matrix<dtype> Z(n, k, dw, sr);
+    for (int it=0; it<iter; it++){
+      CTF_int::conj_tensor(Q);
+      Z["jr"] = (*this)["ij"]*Q["ir"];
+      CTF_int::conj_tensor(Z);
+      Z.qr(Qz, R);
+      Y["ir"] = (*this)["ij"]*Qz["jr"];
+      Y.qr(Q, R);
+    }
+
+    // B = Q^H A is k-by-n, factorize B^H = Qb Rb, so that A ~= Q Rb^H Qb^H and only the k-by-k Rb^H is decomposed
+    CTF_int::conj_tensor(Q);
+    Z["jr"] = (*this)["ij"]*Q["ir"];
+    CTF_int::conj_tensor(Z);
+    CTF_int::conj_tensor(Q);
+    Matrix<dtype> Qb, Rb;
+    Z.qr(Qb, Rb);
+
+    dtype * X = (dtype*)CTF_int::alloc(sizeof(dtype)*k*k);
+    dtype * s = (dtype*)CTF_int::alloc(sizeof(dtype)*k);
+    dtype * us = (dtype*)CTF_int::alloc(sizeof(dtype)*k*k);
+    dtype * vsh = (dtype*)CTF_int::alloc(sizeof(dtype)*k*k);
+    dtype * vs = (dtype*)CTF_int::alloc(sizeof(dtype)*k*rank);
+    Rb.read_all(vsh);
+    if (dw.rank == 0){
+      for (int j=0; j<k; j++){
+        for (int i=0; i<k; i++){
+          X[i+j*k] = CTF_int::conj_val(vsh[j+i*k]);
+        }
+      }
+      int info;
+      dtype dlwork;
+      CTF_LAPACK::gesvd<dtype>('S', 'S', k, k, X, k, s, us, k, vsh, k, &dlwork, -1, &info);
+      int lwork = (int)std::real(dlwork);
+      dtype * work = (dtype*)CTF_int::alloc(sizeof(dtype)*lwork);
+      CTF_LAPACK::gesvd<dtype>('S', 'S', k, k, X, k, s, us, k, vsh, k, work, lwork, &info);
+      CTF_int::cdealloc(work);
+      for (int j=0; j<rank; j++){
+        for (int i=0; i<k; i++){
+          vs[i+j*k] = CTF_int::conj_val(vsh[j+i*k]);
+        }
+      }
+    }
+    Matrix<dtype> Us(k, rank, dw, sr);
+    Matrix<dtype> Vs(k, rank, dw, sr);
+    S = Vector<dtype>(rank, dw, sr);
+    CTF_int::write_from_root(Us, ((int64_t)k)*rank, us);
+    CTF_int::write_from_root(Vs, ((int64_t)k)*rank, vs);
+    CTF_int::write_from_root(S, rank, s);
+
+    U = Matrix<dtype>(m, rank, dw, sr);
+    U["is"] = Q["ir"]*Us["rs"];
+    Matrix<dtype> V(n, rank, dw, sr);
+    V["js"] = Qb["jr"]*Vs["rs"];
+    VT = Matrix<dtype>(rank, n, dw, sr);
+    VT["sj"] = V["js"];
+    CTF_int::conj_tensor(VT);
+
+    CTF_int::cdealloc(vs);
+    CTF_int::cdealloc(vsh);
+    CTF_int::cdealloc(us);
+    CTF_int::cdealloc(s);
+    CTF_int::cdealloc(X);
+  }
 
 }
@@ -7,6 +7,15 @@ namespace CTF {
    * @{
    */
 
+  /**
+   * \brief algorithm used by Matrix::qr
+   *        QR_DEFAULT: TSQR for tall-skinny matrices or when CTF is built without ScaLAPACK, otherwise ScaLAPACK
+   *        QR_SCALAPACK: Householder QR via pgeqrf from ScaLAPACK on a block-cyclic copy of the matrix
+   *        QR_TSQR: communication-avoiding TSQR, local QR of the rows owned by each process and a binary reduction tree of R factors
+   *        QR_CHOLQR2: two passes of Cholesky-QR, falls back to TSQR if the Gram matrix is numerically indefinite
+   */
+  enum QR_ALG { QR_DEFAULT, QR_SCALAPACK, QR_TSQR, QR_CHOLQR2 };
+
   /**
    * \brief Matrix class which encapsulates a 2D tensor 
    * \param[in] dtype specifies tensor element type
@@ -261,10 +270,12 @@ namespace CTF {
 
       /*
        * \calculates the reduced QR decomposition, A = Q x R for A of dimensions m by n with m>=n
+       *  TSQR and Cholesky-QR2 require only LAPACK and return Q with rows distributed cyclically over all processes
        * \param[out] Q m-by-n matrix with orthonormal columns
        * \param[out] R n-by-n upper-triangular matrix
+       * \param[in] alg algorithm to use, see QR_ALG
        */
-      void qr(Matrix<dtype> & Q, Matrix<dtype> & R);
+      void qr(Matrix<dtype> & Q, Matrix<dtype> & R, QR_ALG alg=QR_DEFAULT);
 
       /*
        * \calculates the singular value decomposition, M = U x S x VT, of matrix using pdgesvd from ScaLAPACK
@@ -275,6 +286,19 @@ namespace CTF {
        */
       void svd(Matrix<dtype> & U, Vector<dtype> & S, Matrix<dtype> & VT, int rank = 0);
 
+      /*
+       * \calculates a truncated singular value decomposition, M ~= U x S x VT, via a randomized range finder,
+       *  the range of M is sampled by contracting M with rank+oversamp random vectors, refined by iter power iterations,
+       *  and orthonormalized by QR, only matrices with rank+oversamp columns are factorized, M may be sparse
+       * \param[out] U leading rank left singular vectors of matrix
+       * \param[out] S leading rank singular values of matrix
+       * \param[out] VT leading rank right singular vectors of matrix
+       * \param[in] rank number of singular triplets to compute
+       * \param[in] iter number of power iterations, improves accuracy when singular values decay slowly
+       * \param[in] oversamp number of additional random vectors used to sample the range of the matrix
+       */
+      void svd_rand(Matrix<dtype> & U, Vector<dtype> & S, Matrix<dtype> & VT, int rank, int iter=1, int oversamp=5);
+
   };
   /**
    * @}
@@ -167,6 +167,70 @@ namespace CTF_int {
     CTF_BLAS::ZAXPY(&n,&alpha,X,&incX,Y,&incY);
   }
 
+  /** \brief vectorized body of default_mul_acc for the builtin real types, a zero stride of C is a dot product */
+  template <typename dtype>
+  void simd_mul_acc(int64_t       n,
+                    dtype         alpha,
+                    dtype const * A,
+                    int64_t       incA,
+                    dtype const * B,
+                    int64_t       incB,
+                    dtype *       C,
+                    int64_t       incC){
+    if (incC == 0){
+      dtype s = 0;
+#ifdef USE_OMP
+      #pragma omp simd reduction(+:s)
+#endif
+      for (int64_t i=0; i<n; i++){
+        s += A[incA*i]*B[incB*i];
+      }
+      C[0] += alpha*s;
+    } else if (incA == 1 && incB == 1 && incC == 1){
+#ifdef USE_OMP
+      #pragma omp simd
+#endif
+      for (int64_t i=0; i<n; i++){
+        C[i] += alpha*A[i]*B[i];
+      }
+    } else {
+#ifdef USE_OMP
+      #pragma omp simd
+#endif
+      for (int64_t i=0; i<n; i++){
+        C[incC*i] += alpha*A[incA*i]*B[incB*i];
+      }
+    }
+  }
+
+  template <>
+  bool default_mul_acc<float>
+                   (int64_t       n,
+                    float         alpha,
+                    float const * A,
+                    int64_t       incA,
+                    float const * B,
+                    int64_t       incB,
+                    float *       C,
+                    int64_t       incC){
+    simd_mul_acc<float>(n, alpha, A, incA, B, incB, C, incC);
+    return true;
+  }
+
+  template <>
+  bool default_mul_acc<double>
+                   (int64_t        n,
+                    double         alpha,
+                    double const * A,
+                    int64_t        incA,
+                    double const * B,
+                    int64_t        incB,
+                    double *       C,
+                    int64_t        incC){
+    simd_mul_acc<double>(n, alpha, A, incA, B, incB, C, incC);
+    return true;
+  }
+
   template <>
   void default_scal<float>(int n, float alpha, float * X, int incX){
     CTF_BLAS::SSCAL(&n,&alpha,X,&incX);
@@ -341,27 +405,18 @@ namespace CTF_int {
                   dtype         beta,
                   dtype *       C){
     //TAU_FSTART(muladd_csrmm);
-#ifdef USE_OMP
-    #pragma omp parallel for
-#endif
-    for (int row_A=0; row_A<m; row_A++){
+    if (beta != (dtype)1){
 #ifdef USE_OMP
       #pragma omp parallel for
 #endif
-      for (int col_B=0; col_B<n; col_B++){
-        C[col_B*m+row_A] *= beta;
-        if (IA[row_A] < IA[row_A+1]){
-          int i_A1 = IA[row_A]-1;
-          int col_A1 = JA[i_A1]-1;
-          dtype tmp = A[i_A1]*B[col_B*k+col_A1];
-          for (int i_A=IA[row_A]; i_A<IA[row_A+1]-1; i_A++){
-            int col_A = JA[i_A]-1;
-            tmp += A[i_A]*B[col_B*k+col_A];
-          }
-          C[col_B*m+row_A] += alpha*tmp;
-        }
+      for (int64_t i=0; i<((int64_t)m)*n; i++){
+        C[i] *= beta;
       }
     }
+    csrmm_merge_path(m, n, k, A, JA, IA, B, C,
+                     [](dtype a, dtype b){ return a*b; },
+                     [](dtype a, dtype b){ return a+b; },
+                     [=](dtype & c, dtype s){ c += alpha*s; });
     //TAU_FSTOP(muladd_csrmm);
   }
 
@@ -492,6 +547,29 @@ namespace CTF {
 #endif
   }
 
+  #define CSF_MM_DEF(dtype,is_ord) \
+  template<> \
+  void CTF::Semiring<dtype,is_ord>::default_csfmm \
+          (int           m, \
+           int           n, \
+           int           k, \
+           dtype         alpha, \
+           char const *  A, \
+           dtype const * B, \
+           dtype         beta, \
+           dtype *       C) const { \
+    if (beta != dtype(1)){ \
+      for (int64_t i=0; i<((int64_t)m)*n; i++) C[i] *= beta; \
+    } \
+    CTF_int::csfmm_tree<dtype>(m, n, k, alpha, A, B, C, \
+                               [](dtype a, dtype b){ return a*b; }, \
+                               [](dtype a, dtype b){ return a+b; }); \
+  }
+  CSF_MM_DEF(float,1)
+  CSF_MM_DEF(double,1)
+  CSF_MM_DEF(std::complex<float>,0)
+  CSF_MM_DEF(std::complex<double>,0)
+
 
 #if USE_MKL 
   #define CSR_MULTD_DEF(dtype,is_ord,MKL_name) \
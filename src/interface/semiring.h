@@ -3,6 +3,7 @@
 
 #include "functions.h"
 #include "../sparse_formats/csr.h"
+#include "../sparse_formats/csf.h"
 #include <iostream>
 
 using namespace std;
@@ -43,6 +44,27 @@ namespace CTF_int {
   void default_axpy< std::complex<double> >
                    (int,std::complex<double>,std::complex<double> const *,int,std::complex<double> *,int);
 
+  /** \brief vectorized C[i*incC]+=alpha*A[i*incA]*B[i*incB] for builtin types, returns false if dtype has none */
+  template <typename dtype>
+  bool default_mul_acc(int64_t       n,
+                       dtype         alpha,
+                       dtype const * A,
+                       int64_t       incA,
+                       dtype const * B,
+                       int64_t       incB,
+                       dtype *       C,
+                       int64_t       incC){
+    return false;
+  }
+
+  template <>
+  bool default_mul_acc<float>
+                   (int64_t,float,float const *,int64_t,float const *,int64_t,float *,int64_t);
+
+  template <>
+  bool default_mul_acc<double>
+                   (int64_t,double,double const *,int64_t,double const *,int64_t,double *,int64_t);
+
   template <typename dtype>
   void default_scal(int           n,
                     dtype         alpha,
@@ -499,6 +521,25 @@ namespace CTF {
         }
       }
 
+      /** \brief C[i*incC]+=alpha*A[i*incA]*B[i*incB] for i<n, strides may be zero */
+      void mul_acc(int64_t      n,
+                   char const * alpha,
+                   char const * A,
+                   int64_t      incA,
+                   char const * B,
+                   int64_t      incB,
+                   char       * C,
+                   int64_t      incC)  const {
+        dtype a          = alpha == NULL ? tmulid : ((dtype const *)alpha)[0];
+        dtype const * dA = (dtype const *) A;
+        dtype const * dB = (dtype const *) B;
+        dtype * dC       = (dtype*) C;
+        if (is_def && CTF_int::default_mul_acc<dtype>(n, a, dA, incA, dB, incB, dC, incC)) return;
+        for (int64_t i=0; i<n; i++){
+          dC[incC*i] = this->fadd(fmul(a,fmul(dA[incA*i],dB[incB*i])), dC[incC*i]);
+        }
+      }
+
       /** \brief beta*C["ij"]=alpha*A^tA["ik"]*B^tB["kj"]; */
       void gemm(char         tA,
                 char         tB,
@@ -640,27 +681,18 @@ namespace CTF {
                       dtype const * B,
                       dtype         beta,
                       dtype *       C) const {
-#ifdef _OPENMP
-        #pragma omp parallel for
-#endif
-        for (int row_A=0; row_A<m; row_A++){
+        if (!this->isequal((char const*)&beta, (char const*)&tmulid)){
 #ifdef _OPENMP
           #pragma omp parallel for
 #endif
-          for (int col_B=0; col_B<n; col_B++){
-            C[col_B*m+row_A] = this->fmul(beta,C[col_B*m+row_A]);
-            if (IA[row_A] < IA[row_A+1]){
-              int i_A1 = IA[row_A]-1;
-              int col_A1 = JA[i_A1]-1;
-              dtype tmp = this->fmul(A[i_A1],B[col_B*k+col_A1]);
-              for (int i_A=IA[row_A]; i_A<IA[row_A+1]-1; i_A++){
-                int col_A = JA[i_A]-1;
-                tmp = this->fadd(tmp, this->fmul(A[i_A],B[col_B*k+col_A]));
-              }
-              C[col_B*m+row_A] = this->fadd(C[col_B*m+row_A], this->fmul(alpha,tmp));
-            }
+          for (int64_t i=0; i<((int64_t)m)*n; i++){
+            C[i] = this->fmul(beta, C[i]);
           }
         }
+        dtype (*fm)(dtype, dtype) = this->fmul;
+        dtype (*fa)(dtype, dtype) = this->fadd;
+        CTF_int::csrmm_merge_path(m, n, k, A, JA, IA, B, C, fm, fa,
+                                  [=](dtype & c, dtype s){ c = fa(c, fm(alpha, s)); });
       }
 
 //      void (*fcsrmultd)(int,int,int,dtype const*,int const*,int const*,dtype const*,int const*, int const*,dtype*,int);
@@ -683,6 +715,37 @@ namespace CTF {
         this->default_csrmm(m,n,k,((dtype*)alpha)[0],(dtype*)A,JA,IA,nnz_A,(dtype*)B,((dtype*)beta)[0],(dtype*)C);
       }
 
+      void default_csfmm
+                     (int           m,
+                      int           n,
+                      int           k,
+                      dtype         alpha,
+                      char const *  A,
+                      dtype const * B,
+                      dtype         beta,
+                      dtype *       C) const {
+        if (!this->isequal((char const*)&beta, (char const*)&tmulid)){
+          for (int64_t i=0; i<((int64_t)m)*n; i++){
+            C[i] = this->fmul(beta, C[i]);
+          }
+        }
+        dtype (*fm)(dtype, dtype) = this->fmul;
+        dtype (*fa)(dtype, dtype) = this->fadd;
+        CTF_int::csfmm_tree<dtype>(m, n, k, alpha, A, B, C, fm, fa);
+      }
+
+      /** \brief sparse version of gemm using CSF format for A */
+      void csfmm(int          m,
+                 int          n,
+                 int          k,
+                 char const * alpha,
+                 char const * A,
+                 char const * B,
+                 char const * beta,
+                 char *       C) const {
+        this->default_csfmm(m,n,k,((dtype*)alpha)[0],A,(dtype*)B,((dtype*)beta)[0],(dtype*)C);
+      }
+
       void default_csrmultd
                      (int           m,
                       int           n,
@@ -985,6 +1048,15 @@ namespace CTF {
   void CTF::Semiring<std::complex<double>,0>::default_csrmm(int,int,int,std::complex<double>,std::complex<double> const *,int const *,int const *,int,std::complex<double> const *,std::complex<double>,std::complex<double> *) const;
 
 
+  template <>
+  void CTF::Semiring<float,1>::default_csfmm(int,int,int,float,char const *,float const *,float,float *) const;
+  template <>
+  void CTF::Semiring<double,1>::default_csfmm(int,int,int,double,char const *,double const *,double,double *) const;
+  template <>
+  void CTF::Semiring<std::complex<float>,0>::default_csfmm(int,int,int,std::complex<float>,char const *,std::complex<float> const *,std::complex<float>,std::complex<float> *) const;
+  template <>
+  void CTF::Semiring<std::complex<double>,0>::default_csfmm(int,int,int,std::complex<double>,char const *,std::complex<double> const *,std::complex<double>,std::complex<double> *) const;
+
   template <>
   void CTF::Semiring<float,1>::default_csrmultd(int,int,int,float,float const *,int const *,int const *,int,float const *,int const *,int const *,int,float,float *) const;
   template <>
@@ -27,15 +27,10 @@ namespace CTF_int {
     for (int i=1; i<nrow+1; i++){
       csr_ia[i] = 0;
     }
-#ifdef _OPENMP
-    #pragma omp parallel for
-#endif
+    // the row histogram and its prefix sum carry dependences across iterations, so they stay sequential
     for (int64_t i=0; i<nz; i++){
       csr_ia[coo_rs[i]]++;
     }
-#ifdef _OPENMP
-    #pragma omp parallel for
-#endif
     for (int i=0; i<nrow; i++){
       csr_ia[i+1] += csr_ia[i];
     }
@@ -0,0 +1,211 @@
+#ifndef __SORT_H__
+#define __SORT_H__
+
+#include <type_traits>
+#include <algorithm>
+#include <string.h>
+
+namespace CTF_int {
+
+  /**
+   * \brief a tensor value together with its global index, ordered by value and then by index
+   */
+  template<typename dtype>
+  struct val_idx {
+    dtype v;
+    int64_t k;
+  };
+
+  /**
+   * \brief total order on values of type dtype, the specialization below uses an order-preserving
+   *        unsigned key for the arithmetic types so that local sorts are radix sorts
+   */
+  template<typename dtype, bool is_radix=(std::is_integral<dtype>::value || std::is_floating_point<dtype>::value) && sizeof(dtype) <= 8>
+  struct value_order {
+    static bool lt(dtype const & a, dtype const & b){ return a < b; }
+
+    static bool less(val_idx<dtype> const & a, val_idx<dtype> const & b){
+      return lt(a.v, b.v) || (!lt(b.v, a.v) && a.k < b.k);
+    }
+
+    static void sort(int64_t n, val_idx<dtype> * a){
+      std::sort(a, a+n, less);
+    }
+  };
+
+  template<typename dtype>
+  struct value_order<dtype, true> {
+    /**
+     * \brief unsigned key of v of the width of dtype with the same order as v, signed values have the sign bit flipped
+     *        and negative floating point values all bits flipped
+     */
+    static uint64_t key(dtype v){
+      uint64_t sgn = ((uint64_t)1) << (8*sizeof(dtype)-1);
+      uint64_t msk = sizeof(dtype) == 8 ? ~(uint64_t)0 : (sgn << 1) - 1;
+      if (std::is_floating_point<dtype>::value){
+        uint64_t b = 0;
+        memcpy(&b, &v, sizeof(dtype));
+        return (b & sgn) ? (~b & msk) : (b | sgn);
+      } else if (std::is_signed<dtype>::value){
+        return (((uint64_t)(int64_t)v) ^ sgn) & msk;
+      } else
+        return (uint64_t)v;
+    }
+
+    static bool lt(dtype const & a, dtype const & b){ return key(a) < key(b); }
+
+    static bool less(val_idx<dtype> const & a, val_idx<dtype> const & b){
+      uint64_t ka = key(a.v), kb = key(b.v);
+      return ka < kb || (ka == kb && a.k < b.k);
+    }
+
+    /**
+     * \brief least-significant-digit radix sort by (key, index), one byte per pass, skipping the bytes
+     *        in which all elements agree (e.g. the high bytes of the indices)
+     */
+    static void sort(int64_t n, val_idx<dtype> * a){
+      if (n < 2) return;
+      int const nbyte = 8+sizeof(dtype);
+      int64_t * cnt = (int64_t*)alloc(sizeof(int64_t)*nbyte*256);
+      std::fill(cnt, cnt+nbyte*256, 0);
+      for (int64_t i=0; i<n; i++){
+        uint64_t ki = (uint64_t)a[i].k, kv = key(a[i].v);
+        for (int d=0; d<8; d++)
+          cnt[d*256+((ki>>(8*d))&255)]++;
+        for (int d=8; d<nbyte; d++)
+          cnt[d*256+((kv>>(8*(d-8)))&255)]++;
+      }
+      val_idx<dtype> * b = (val_idx<dtype>*)alloc(sizeof(val_idx<dtype>)*n);
+      val_idx<dtype> * src = a, * dst = b;
+      for (int d=0; d<nbyte; d++){
+        int64_t * c = cnt+d*256;
+        if (std::find(c, c+256, n) != c+256) continue;
+        int64_t pfx = 0;
+        for (int j=0; j<256; j++){
+          int64_t cj = c[j];
+          c[j] = pfx;
+          pfx += cj;
+        }
+        for (int64_t i=0; i<n; i++){
+          uint64_t w = d < 8 ? (uint64_t)src[i].k : key(src[i].v);
+          dst[c[(w>>(8*(d<8 ? d : d-8)))&255]++] = src[i];
+        }
+        std::swap(src, dst);
+      }
+      if (src != a) memcpy(a, src, sizeof(val_idx<dtype>)*n);
+      cdealloc(b);
+      cdealloc(cnt);
+    }
+  };
+
+  /**
+   * \brief sorts the elements of all processes in cm so that each process ends with a sorted block and the blocks
+   *        are in order of rank: sorts locally, picks splitters from regular samples of every process, then moves
+   *        every element to its block with a single all-to-all exchange and sorts the received runs locally
+   * \param[in,out] n number of local elements, on output the size of the local block
+   * \param[in,out] a local elements, allocated with alloc, reallocated to the local block
+   * \param[in] cm communicator
+   */
+  template<typename dtype>
+  void sample_sort(int64_t * n, val_idx<dtype> ** a, MPI_Comm cm){
+    typedef value_order<dtype> ord;
+    int np;
+    MPI_Comm_size(cm, &np);
+    ord::sort(*n, *a);
+    if (np == 1) return;
+
+    int const sz = sizeof(val_idx<dtype>);
+    int ns = *n > 0 ? np-1 : 0;
+    val_idx<dtype> * smp = (val_idx<dtype>*)alloc(sz*std::max(ns,1));
+    for (int i=0; i<ns; i++)
+      smp[i] = (*a)[((int64_t)(i+1))*(*n)/np];
+    int * cnts = (int*)alloc(sizeof(int)*np);
+    int * displs = (int*)alloc(sizeof(int)*np);
+    int bns = ns*sz;
+    MPI_Allgather(&bns, 1, MPI_INT, cnts, 1, MPI_INT, cm);
+    int tot = 0;
+    for (int p=0; p<np; p++){
+      displs[p] = tot;
+      tot += cnts[p];
+    }
+    val_idx<dtype> * all_smp = (val_idx<dtype>*)alloc(std::max(tot,sz));
+    MPI_Allgatherv(smp, bns, MPI_CHAR, all_smp, cnts, displs, MPI_CHAR, cm);
+    int64_t nsmp = tot/sz;
+    std::sort(all_smp, all_smp+nsmp, ord::less);
+
+    // elements before the i-th splitter go to processes up to i
+    int * scnts = (int*)alloc(sizeof(int)*np);
+    int * sdispls = (int*)alloc(sizeof(int)*np);
+    int64_t prv = 0;
+    for (int p=0; p<np; p++){
+      int64_t nxt = *n;
+      if (p < np-1 && nsmp > 0)
+        nxt = std::lower_bound(*a+prv, *a+*n, all_smp[(p+1)*nsmp/np], ord::less) - *a;
+      sdispls[p] = prv*sz;
+      scnts[p] = (nxt-prv)*sz;
+      prv = nxt;
+    }
+    MPI_Alltoall(scnts, 1, MPI_INT, cnts, 1, MPI_INT, cm);
+    tot = 0;
+    for (int p=0; p<np; p++){
+      displs[p] = tot;
+      tot += cnts[p];
+    }
+    val_idx<dtype> * b = (val_idx<dtype>*)alloc(std::max(tot,sz));
+    MPI_Alltoallv(*a, scnts, sdispls, MPI_CHAR, b, cnts, displs, MPI_CHAR, cm);
+    cdealloc(*a);
+    *a = b;
+    *n = tot/sz;
+    ord::sort(*n, *a);
+
+    cdealloc(sdispls);
+    cdealloc(scnts);
+    cdealloc(all_smp);
+    cdealloc(displs);
+    cdealloc(cnts);
+    cdealloc(smp);
+  }
+
+  /**
+   * \brief finds the k greatest elements over all processes in cm with respect to greater, which must
+   *        be a strict total order, selecting locally before gathering the candidates
+   * \param[in] k number of elements to find
+   * \param[in] n number of local elements
+   * \param[in,out] a local elements, reordered
+   * \param[in] greater comparison, true if the first argument precedes the second
+   * \param[in] cm communicator
+   * \param[out] out preallocated array of size k, in which the greatest elements are put in order on all processes
+   * \return the number of elements put in out, min(k, total number of elements)
+   */
+  template<typename dtype, typename cmp_t>
+  int64_t top_k(int64_t k, int64_t n, val_idx<dtype> * a, cmp_t greater, MPI_Comm cm, val_idx<dtype> * out){
+    int np;
+    MPI_Comm_size(cm, &np);
+    int64_t nl = std::min(k, n);
+    if (nl < n)
+      std::nth_element(a, a+nl, a+n, greater);
+    std::sort(a, a+nl, greater);
+
+    int const sz = sizeof(val_idx<dtype>);
+    int * cnts = (int*)alloc(sizeof(int)*np);
+    int * displs = (int*)alloc(sizeof(int)*np);
+    int bnl = nl*sz;
+    MPI_Allgather(&bnl, 1, MPI_INT, cnts, 1, MPI_INT, cm);
+    int tot = 0;
+    for (int p=0; p<np; p++){
+      displs[p] = tot;
+      tot += cnts[p];
+    }
+    val_idx<dtype> * cand = (val_idx<dtype>*)alloc(std::max(tot,sz));
+    MPI_Allgatherv(a, bnl, MPI_CHAR, cand, cnts, displs, MPI_CHAR, cm);
+    int64_t nc = tot/sz;
+    int64_t nk = std::min(k, nc);
+    std::partial_sort(cand, cand+nk, cand+nc, greater);
+    std::copy(cand, cand+nk, out);
+    cdealloc(cand);
+    cdealloc(displs);
+    cdealloc(cnts);
+    return nk;
+  }
+}
+#endif
@@ -0,0 +1,276 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include "spmspv.h"
+
+namespace CTF_int {
+  /**
+   * \brief reads the local entries of T that are not the additive identity
+   * \param[in] T tensor, sparse or dense
+   * \param[out] n number of entries
+   * \param[out] keys global indices of the entries, to be freed with cdealloc
+   * \param[out] vals values of the entries, to be freed with cdealloc
+   */
+  inline void read_local_nonzero_pairs(tensor const * T, int64_t * n, int64_t ** keys, char ** vals){
+    algstrct const * sr = T->sr;
+    T->read_local(n, keys, vals);
+    int64_t nk = 0;
+    for (int64_t z=0; z<*n; z++){
+      if (!sr->isequal(*vals+z*sr->el_size, sr->addid())){
+        (*keys)[nk] = (*keys)[z];
+        memcpy(*vals+nk*sr->el_size, *vals+z*sr->el_size, sr->el_size);
+        nk++;
+      }
+    }
+    *n = nk;
+  }
+
+  /**
+   * \brief sorts the nonzeros (k[z], v[z]) by key and combines those with equal keys by the addition of sr
+   * \param[in] sr algebraic structure
+   * \param[in,out] n number of nonzeros, reduced to the number of distinct keys
+   * \param[in,out] k keys
+   * \param[in,out] v values
+   */
+  template<typename dtype>
+  void combine_by_key(algstrct const * sr, int64_t & n, std::vector<int64_t> & k, std::vector<dtype> & v){
+    std::vector<int64_t> perm(n);
+    for (int64_t z=0; z<n; z++) perm[z] = z;
+    std::sort(perm.begin(), perm.end(), [&](int64_t a, int64_t b){ return k[a] < k[b]; });
+    std::vector<int64_t> nk;
+    std::vector<dtype> nv;
+    for (int64_t z=0; z<n; z++){
+      if (nk.size() > 0 && nk.back() == k[perm[z]]){
+        sr->add((char const*)&nv.back(), (char const*)&v[perm[z]], (char*)&nv.back());
+      } else {
+        nk.push_back(k[perm[z]]);
+        nv.push_back(v[perm[z]]);
+      }
+    }
+    n = nk.size();
+    k.swap(nk);
+    v.swap(nv);
+  }
+}
+
+namespace CTF {
+
+  template<typename dtype>
+  SpMSpV<dtype>::SpMSpV(Matrix<dtype> & A, double push_cost_){
+    push_cost = push_cost_;
+    pushed = false;
+    wrld = A.wrld;
+    sr = A.sr;
+    nrow = A.nrow;
+    ncol = A.ncol;
+    nnz_tot = A.nnz_tot;
+
+    int64_t nnz;
+    int64_t * inds;
+    char * data;
+    CTF_int::read_local_nonzero_pairs(&A, &nnz, &inds, &data);
+    if (!A.is_sparse){
+      nnz_tot = nnz;
+      MPI_Allreduce(MPI_IN_PLACE, &nnz_tot, 1, MPI_INT64_T, MPI_SUM, wrld->comm);
+    }
+    dtype const * vals = (dtype const*)data;
+
+    // CSC first, so that the columns are sorted and distinct before the CSR refers to them by position
+    std::vector<int64_t> perm(nnz);
+    for (int64_t z=0; z<nnz; z++) perm[z] = z;
+    std::sort(perm.begin(), perm.end(), [&](int64_t a, int64_t b){ return inds[a] < inds[b]; });
+    std::vector<int64_t> dcols;
+    col_ptr = (int64_t*)CTF_int::alloc(sizeof(int64_t)*(nnz+1));
+    col_row = (int64_t*)CTF_int::alloc(sizeof(int64_t)*std::max(nnz,(int64_t)1));
+    col_val = (dtype*)CTF_int::alloc(sizeof(dtype)*std::max(nnz,(int64_t)1));
+    for (int64_t z=0; z<nnz; z++){
+      int64_t j = inds[perm[z]]/nrow;
+      if (dcols.size() == 0 || dcols.back() != j){
+        col_ptr[dcols.size()] = z;
+        dcols.push_back(j);
+      }
+      col_row[z] = inds[perm[z]]%nrow;
+      col_val[z] = vals[perm[z]];
+    }
+    nc = dcols.size();
+    col_ptr[nc] = nnz;
+    cols = (int64_t*)CTF_int::alloc(sizeof(int64_t)*std::max(nc,(int64_t)1));
+    std::copy(dcols.begin(), dcols.end(), cols);
+
+    std::sort(perm.begin(), perm.end(), [&](int64_t a, int64_t b){
+      int64_t ia = inds[a]%nrow, ib = inds[b]%nrow;
+      return ia < ib || (ia == ib && inds[a] < inds[b]);
+    });
+    std::vector<int64_t> drows;
+    row_ptr = (int64_t*)CTF_int::alloc(sizeof(int64_t)*(nnz+1));
+    row_col = (int64_t*)CTF_int::alloc(sizeof(int64_t)*std::max(nnz,(int64_t)1));
+    row_val = (dtype*)CTF_int::alloc(sizeof(dtype)*std::max(nnz,(int64_t)1));
+    for (int64_t z=0; z<nnz; z++){
+      int64_t i = inds[perm[z]]%nrow;
+      if (drows.size() == 0 || drows.back() != i){
+        row_ptr[drows.size()] = z;
+        drows.push_back(i);
+      }
+      row_col[z] = std::lower_bound(cols, cols+nc, inds[perm[z]]/nrow) - cols;
+      row_val[z] = vals[perm[z]];
+    }
+    nr = drows.size();
+    row_ptr[nr] = nnz;
+    rows = (int64_t*)CTF_int::alloc(sizeof(int64_t)*std::max(nr,(int64_t)1));
+    std::copy(drows.begin(), drows.end(), rows);
+    CTF_int::cdealloc(inds);
+    CTF_int::cdealloc(data);
+  }
+
+  template<typename dtype>
+  SpMSpV<dtype>::~SpMSpV(){
+    CTF_int::cdealloc(rows);
+    CTF_int::cdealloc(cols);
+    CTF_int::cdealloc(row_ptr);
+    CTF_int::cdealloc(row_col);
+    CTF_int::cdealloc(row_val);
+    CTF_int::cdealloc(col_ptr);
+    CTF_int::cdealloc(col_row);
+    CTF_int::cdealloc(col_val);
+  }
+
+  template<typename dtype>
+  void SpMSpV<dtype>::multiply(Vector<dtype> & x, Vector<dtype> & y, CTF_int::tensor * visited){
+    IASSERT(x.len == ncol && y.len == nrow && (visited == NULL || (visited->order == 1 && visited->lens[0] == nrow)));
+    Timer t_spmspv("SpMSpV");
+    t_spmspv.start();
+    int64_t nx;
+    int64_t * xk;
+    char * xv;
+    CTF_int::read_local_nonzero_pairs(&x, &nx, &xk, &xv);
+
+    // frontier size and number of visited rows, the latter only matters for the share of edges left to pull over
+    int64_t cnts[2] = {nx, 0};
+    if (visited != NULL){
+      int64_t nv;
+      int64_t * vk;
+      char * vv;
+      CTF_int::read_local_nonzero_pairs(visited, &nv, &vk, &vv);
+      cnts[1] = nv;
+      CTF_int::cdealloc(vk);
+      CTF_int::cdealloc(vv);
+    }
+    MPI_Allreduce(MPI_IN_PLACE, cnts, 2, MPI_INT64_T, MPI_SUM, wrld->comm);
+    double push_edges = ((double)cnts[0])*nnz_tot/std::max(ncol,1);
+    double pull_edges = ((double)nnz_tot)*(nrow-cnts[1])/std::max(nrow,1);
+    pushed = push_edges*push_cost < pull_edges || cnts[0] == 0;
+
+    if (pushed) push(nx, xk, (dtype const*)xv, y, visited);
+    else pull(x, y, visited);
+    CTF_int::cdealloc(xk);
+    CTF_int::cdealloc(xv);
+    t_spmspv.stop();
+  }
+
+  template<typename dtype>
+  void SpMSpV<dtype>::push(int64_t nx, int64_t const * xk, dtype const * xv, Vector<dtype> & y, CTF_int::tensor * visited){
+    Timer t_spmspv_push("SpMSpV_push");
+    t_spmspv_push.start();
+    // every process sees the whole frontier and scatters it along the local parts of its columns
+    int np = wrld->np;
+    int * cnts = (int*)CTF_int::alloc(sizeof(int)*np);
+    int * displs = (int*)CTF_int::alloc(sizeof(int)*np);
+    int * bcnts = (int*)CTF_int::alloc(sizeof(int)*np);
+    int * bdispls = (int*)CTF_int::alloc(sizeof(int)*np);
+    int inx = (int)nx;
+    MPI_Allgather(&inx, 1, MPI_INT, cnts, 1, MPI_INT, wrld->comm);
+    int64_t f = 0;
+    for (int p=0; p<np; p++){
+      displs[p] = f;
+      bcnts[p] = cnts[p]*sizeof(dtype);
+      bdispls[p] = f*sizeof(dtype);
+      f += cnts[p];
+    }
+    int64_t * fk = (int64_t*)CTF_int::alloc(sizeof(int64_t)*std::max(f,(int64_t)1));
+    dtype * fv = (dtype*)CTF_int::alloc(sizeof(dtype)*std::max(f,(int64_t)1));
+    MPI_Allgatherv(xk, inx, MPI_INT64_T, fk, cnts, displs, MPI_INT64_T, wrld->comm);
+    MPI_Allgatherv(xv, inx*sizeof(dtype), MPI_CHAR, fv, bcnts, bdispls, MPI_CHAR, wrld->comm);
+
+    std::vector<int64_t> ok;
+    std::vector<dtype> ov;
+    for (int64_t z=0; z<f; z++){
+      int64_t c = std::lower_bound(cols, cols+nc, fk[z]) - cols;
+      if (c == nc || cols[c] != fk[z]) continue;
+      for (int64_t e=col_ptr[c]; e<col_ptr[c+1]; e++){
+        dtype w;
+        sr->mul((char const*)&col_val[e], (char const*)&fv[z], (char*)&w);
+        ok.push_back(col_row[e]);
+        ov.push_back(w);
+      }
+    }
+    int64_t no = ok.size();
+    CTF_int::combine_by_key(sr, no, ok, ov);
+
+    if (visited != NULL){
+      CTF_int::algstrct const * vsr = visited->sr;
+      char * vv = (char*)CTF_int::alloc(vsr->el_size*std::max(no,(int64_t)1));
+      vsr->set(vv, vsr->addid(), no);
+      visited->read(no, vsr->mulid(), vsr->addid(), ok.data(), vv);
+      int64_t nk = 0;
+      for (int64_t z=0; z<no; z++){
+        if (vsr->isequal(vv+z*vsr->el_size, vsr->addid())){
+          ok[nk] = ok[z];
+          ov[nk] = ov[z];
+          nk++;
+        }
+      }
+      no = nk;
+      CTF_int::cdealloc(vv);
+    }
+    y.write(no, *(dtype const*)sr->mulid(), *(dtype const*)sr->mulid(), ok.data(), ov.data());
+    CTF_int::cdealloc(fv);
+    CTF_int::cdealloc(fk);
+    CTF_int::cdealloc(bdispls);
+    CTF_int::cdealloc(bcnts);
+    CTF_int::cdealloc(displs);
+    CTF_int::cdealloc(cnts);
+    t_spmspv_push.stop();
+  }
+
+  template<typename dtype>
+  void SpMSpV<dtype>::pull(Vector<dtype> & x, Vector<dtype> & y, CTF_int::tensor * visited){
+    Timer t_spmspv_pull("SpMSpV_pull");
+    t_spmspv_pull.start();
+    // values of x at the local columns, the additive identity where x has no nonzero
+    char * xc = (char*)CTF_int::alloc(sizeof(dtype)*std::max(nc,(int64_t)1));
+    sr->set(xc, sr->addid(), nc);
+    ((CTF_int::tensor&)x).read(nc, sr->mulid(), sr->addid(), cols, xc);
+    dtype const * xcv = (dtype const*)xc;
+
+    char * vv = NULL;
+    CTF_int::algstrct const * vsr = NULL;
+    if (visited != NULL){
+      vsr = visited->sr;
+      vv = (char*)CTF_int::alloc(vsr->el_size*std::max(nr,(int64_t)1));
+      vsr->set(vv, vsr->addid(), nr);
+      visited->read(nr, vsr->mulid(), vsr->addid(), rows, vv);
+    }
+
+    std::vector<int64_t> ok;
+    std::vector<dtype> ov;
+    for (int64_t r=0; r<nr; r++){
+      if (vv != NULL && !vsr->isequal(vv+r*vsr->el_size, vsr->addid())) continue;
+      bool any = false;
+      dtype acc, w;
+      for (int64_t e=row_ptr[r]; e<row_ptr[r+1]; e++){
+        if (sr->isequal((char const*)&xcv[row_col[e]], sr->addid())) continue;
+        sr->mul((char const*)&row_val[e], (char const*)&xcv[row_col[e]], (char*)&w);
+        if (any) sr->add((char const*)&acc, (char const*)&w, (char*)&acc);
+        else acc = w;
+        any = true;
+      }
+      if (any){
+        ok.push_back(rows[r]);
+        ov.push_back(acc);
+      }
+    }
+    y.write(ok.size(), *(dtype const*)sr->mulid(), *(dtype const*)sr->mulid(), ok.data(), ov.data());
+    if (vv != NULL) CTF_int::cdealloc(vv);
+    CTF_int::cdealloc(xc);
+    t_spmspv_pull.stop();
+  }
+}
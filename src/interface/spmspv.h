@@ -0,0 +1,70 @@
+#ifndef __SPMSPV_H__
+#define __SPMSPV_H__
+#include "tensor.h"
+#include "matrix.h"
+#include "vector.h"
+
+namespace CTF {
+
+  /**
+   * \brief multiplies a sparse matrix by frontier vectors, y["i"] += A["ij"]*x["j"] in the algebraic structure of A,
+   *        for frontier-based graph algorithms. Each multiplication either pushes, scattering every nonzero of x along
+   *        its column of A, or pulls, gathering x over the rows of A that have not been visited yet, depending on
+   *        how many edges leave the frontier relative to how many reach unvisited rows.
+   *        The local nonzeros of A are extracted into CSR and CSC form once and reused by every multiplication,
+   *        so the object must be rebuilt if A changes.
+   */
+  template<typename dtype>
+  class SpMSpV {
+    public:
+      /**
+       * \brief relative cost of an edge traversed by pushing to one traversed by pulling, x is pushed when
+       *        the edges leaving it times push_cost are fewer than the edges of A in unvisited rows
+       */
+      double push_cost;
+
+      /** \brief whether the last multiplication pushed (true) or pulled (false) */
+      bool pushed;
+
+      /**
+       * \brief extracts the local nonzeros of A into CSR and CSC form
+       * \param[in] A matrix, usually sparse
+       * \param[in] push_cost relative cost of a pushed edge to a pulled one
+       */
+      SpMSpV(Matrix<dtype> & A, double push_cost=14.);
+
+      ~SpMSpV();
+
+      /**
+       * \brief computes y["i"] += A["ij"]*x["j"] for the rows i at which visited is zero, must be called by all processes
+       * \param[in] x frontier of length ncol, sparse or dense
+       * \param[in,out] y vector of length nrow, usually sparse
+       * \param[in] visited vector of length nrow of any type, rows at which it is nonzero are skipped, NULL to compute all rows
+       */
+      void multiply(Vector<dtype> & x, Vector<dtype> & y, CTF_int::tensor * visited=NULL);
+
+    private:
+      World * wrld;
+      CTF_int::algstrct const * sr;
+      int nrow;
+      int ncol;
+      int64_t nnz_tot;
+      /** \brief distinct local rows and columns, each sorted */
+      int64_t nr, nc;
+      int64_t * rows;
+      int64_t * cols;
+      /** \brief CSR of the local nonzeros over the local rows, columns are stored as positions in cols */
+      int64_t * row_ptr;
+      int64_t * row_col;
+      dtype * row_val;
+      /** \brief CSC of the local nonzeros over the local columns, rows are stored as global indices */
+      int64_t * col_ptr;
+      int64_t * col_row;
+      dtype * col_val;
+
+      void push(int64_t nx, int64_t const * xk, dtype const * xv, Vector<dtype> & y, CTF_int::tensor * visited);
+      void pull(Vector<dtype> & x, Vector<dtype> & y, CTF_int::tensor * visited);
+  };
+}
+#include "spmspv.cxx"
+#endif
@@ -4,6 +4,7 @@
 #include "world.h"
 #include "idx_tensor.h"
 #include "../tensor/untyped_tensor.h"
+#include "sort.h"
 
 
 namespace CTF {
@@ -844,12 +845,89 @@ NORM_INFTY_INST(double)
 #undef NORM2_COMPLEX_INST
 #undef NORM_INFTY_INST
 
+  /**
+   * \brief reads the local elements of T into value-index pairs
+   * \param[in] T tensor
+   * \param[in] nonzeros_only whether to skip elements equivalent to the additive identity
+   * \param[out] n number of elements
+   * \return pairs, to be freed with cdealloc
+   */
+  template<typename dtype>
+  CTF_int::val_idx<dtype> * get_local_val_idx(Tensor<dtype> const & T, bool nonzeros_only, int64_t * n){
+    int64_t npair;
+    int64_t * inds;
+    dtype * data;
+    T.get_local_data(&npair, &inds, &data);
+    CTF_int::val_idx<dtype> * a = (CTF_int::val_idx<dtype>*)CTF_int::alloc(sizeof(CTF_int::val_idx<dtype>)*std::max(npair,(int64_t)1));
+    *n = 0;
+    for (int64_t i=0; i<npair; i++){
+      if (nonzeros_only && T.sr->isequal((char const*)&data[i], T.sr->addid())) continue;
+      a[*n].v = data[i];
+      a[*n].k = inds[i];
+      (*n)++;
+    }
+    CTF_int::cdealloc(inds);
+    T.sr->dealloc((char*)data);
+    return a;
+  }
+
   template<typename dtype>
   void Tensor<dtype>::get_max_abs(int     n,
                                   dtype * data) const {
-    int ret;
-    ret = CTF_int::tensor::get_max_abs(n, data);
-    if (ret != CTF_int::SUCCESS){ printf("CTF ERROR: failed to execute function get_max_abs\n"); IASSERT(0); return; }
+    int64_t nl;
+    CTF_int::val_idx<dtype> * a = get_local_val_idx(*this, false, &nl);
+    CTF_int::val_idx<dtype> * top = (CTF_int::val_idx<dtype>*)CTF_int::alloc(sizeof(CTF_int::val_idx<dtype>)*std::max(n,1));
+    int64_t nt = CTF_int::top_k(n, nl, a, [](CTF_int::val_idx<dtype> const & x, CTF_int::val_idx<dtype> const & y){
+      return std::abs(x.v) > std::abs(y.v) || (!(std::abs(y.v) > std::abs(x.v)) && x.k < y.k);
+    }, wrld->comm, top);
+    for (int64_t i=0; i<nt; i++) data[i] = top[i].v;
+    CTF_int::cdealloc(top);
+    CTF_int::cdealloc(a);
+  }
+
+  template<typename dtype>
+  void Tensor<dtype>::sort(int64_t *  npair,
+                           int64_t ** global_idx,
+                           dtype **   data,
+                           bool       nonzeros_only) const {
+    CTF_int::val_idx<dtype> * a = get_local_val_idx(*this, nonzeros_only, npair);
+    CTF_int::sample_sort(npair, &a, wrld->comm);
+    *global_idx = (int64_t*)CTF_int::alloc((*npair)*sizeof(int64_t));
+    *data = (dtype*)sr->alloc((*npair));
+    for (int64_t i=0; i<*npair; i++){
+      (*global_idx)[i] = a[i].k;
+      (*data)[i] = a[i].v;
+    }
+    CTF_int::cdealloc(a);
+  }
+
+  template<typename dtype>
+  int64_t Tensor<dtype>::topk(int64_t   k,
+                              int64_t * global_idx,
+                              dtype *   data) const {
+    typedef CTF_int::value_order<dtype> ord;
+    int64_t nl;
+    CTF_int::val_idx<dtype> * a = get_local_val_idx(*this, false, &nl);
+    CTF_int::val_idx<dtype> * top = (CTF_int::val_idx<dtype>*)CTF_int::alloc(sizeof(CTF_int::val_idx<dtype>)*std::max(k,(int64_t)1));
+    int64_t nt = CTF_int::top_k(k, nl, a, [](CTF_int::val_idx<dtype> const & x, CTF_int::val_idx<dtype> const & y){
+      return ord::lt(y.v, x.v) || (!ord::lt(x.v, y.v) && x.k < y.k);
+    }, wrld->comm, top);
+    for (int64_t i=0; i<nt; i++){
+      global_idx[i] = top[i].k;
+      data[i] = top[i].v;
+    }
+    CTF_int::cdealloc(top);
+    CTF_int::cdealloc(a);
+    return nt;
+  }
+
+  template<typename dtype>
+  int64_t Tensor<dtype>::argmax(dtype * val) const {
+    int64_t idx;
+    dtype v;
+    if (topk(1, &idx, &v) == 0) return -1;
+    if (val != NULL) *val = v;
+    return idx;
   }
 
   template<typename dtype>
@@ -1001,6 +1079,26 @@ NORM_INFTY_INST(double)
     ctr.execute();
   }
 
+  template<typename dtype>
+  void Tensor<dtype>::contract(dtype            alpha,
+                               CTF_int::tensor& A,
+                               const char *     idx_A,
+                               CTF_int::tensor& B,
+                               const char *     idx_B,
+                               dtype            beta,
+                               const char *     idx_C,
+                               CTF_int::tensor& M,
+                               bool             complement){
+    if (A.wrld->cdt.cm != wrld->cdt.cm || B.wrld->cdt.cm != wrld->cdt.cm || M.wrld->cdt.cm != wrld->cdt.cm){
+      printf("CTF ERROR: worlds of contracted tensors must match\n");
+      IASSERT(0);
+      return;
+    }
+    CTF_int::contraction ctr 
+      = CTF_int::contraction(&A, idx_A, &B, idx_B, (char*)&alpha, this, idx_C, (char*)&beta);
+    ctr.execute_masked(&M, complement);
+  }
+
 
   template<typename dtype>
   void Tensor<dtype>::sum(dtype            alpha,
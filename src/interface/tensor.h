@@ -486,6 +486,32 @@ namespace CTF {
                     char const *          idx_C,
                     Bivar_Function<dtype> fseq);
 
+      /**
+       * \brief contracts C[idx_C] = beta*C[idx_C] + alpha*A[idx_A]*B[idx_B] only at the entries where M[idx_C] is nonzero,
+       *        or, if complement, only where M[idx_C] is zero, the other entries of C are scaled by beta.
+       *        Without complement the work is proportional to the number of nonzeros of M: for dense A and B each entry is
+       *        a dot product of the parts of A and B it touches (SDDMM), sparse operands are first restricted to the parts
+       *        that reach the mask
+       * \param[in] alpha A*B scaling factor
+       * \param[in] A first operand tensor
+       * \param[in] idx_A indices of A in contraction, e.g. "ik" -> A_{ik}
+       * \param[in] B second operand tensor
+       * \param[in] idx_B indices of B in contraction, e.g. "kj" -> B_{kj}
+       * \param[in] beta C scaling factor
+       * \param[in] idx_C indices of C (this tensor),  e.g. "ij" -> C_{ij}
+       * \param[in] M nonsymmetric mask with the lengths of C, may be of a different type than C
+       * \param[in] complement whether to compute the entries where M is zero instead
+       */
+      void contract(dtype             alpha,
+                    CTF_int::tensor & A,
+                    char const *      idx_A,
+                    CTF_int::tensor & B,
+                    char const *      idx_B,
+                    dtype             beta,
+                    char const *      idx_C,
+                    CTF_int::tensor & M,
+                    bool              complement=false);
+
       /**
        * \brief sums B[idx_B] = beta*B[idx_B] + alpha*A[idx_A]
        * \param[in] alpha A scaling factor
@@ -829,15 +855,47 @@ namespace CTF {
       const dtype * raw_data(int64_t * size) const;
       /**
        * \brief obtains a small number of the biggest elements of the
-       *        tensor in sorted order (e.g. eigenvalues)
+       *        tensor in absolute value in sorted order (e.g. eigenvalues)
        * \param[in] n number of elements to collect
-       * \param[in] data output data (should be preallocated to size at least n)
-       *
-       * WARNING: currently functional only for dtype=double
+       * \param[in] data output data (should be preallocated to size at least n),
+       *            entries past the number of tensor elements are left unchanged
        */
       void get_max_abs(int     n,
                        dtype * data) const;
 
+      /**
+       * \brief sorts the tensor elements by value across all processes with a sample sort, after which each
+       *        process holds a block of the sorted elements and the blocks are in order of rank,
+       *        elements of equal value are ordered by global index, must be called by all processes
+       * \param[out] npair number of elements in the local block
+       * \param[out] global_idx global index of each element of the block, should be released with free
+       * \param[out] data values of the block in ascending order, should be released with delete []
+       * \param[in] nonzeros_only if true, elements equivalent to the additive identity (zero) are not sorted
+       */
+      void sort(int64_t *  npair,
+                int64_t ** global_idx,
+                dtype **   data,
+                bool       nonzeros_only=false) const;
+
+      /**
+       * \brief obtains the k largest elements of the tensor and their global indices in descending order on all processes,
+       *        elements of equal value are ordered by global index, for sparse tensors only stored elements are considered
+       * \param[in] k number of elements to collect
+       * \param[out] global_idx preallocated array of size at least k, in which to put the global indices
+       * \param[out] data preallocated array of size at least k, in which to put the values
+       * \return number of elements collected, min(k, number of elements)
+       */
+      int64_t topk(int64_t   k,
+                   int64_t * global_idx,
+                   dtype *   data) const;
+
+      /**
+       * \brief obtains the global index of the largest element of the tensor, the smallest such index if there are ties
+       * \param[out] val if not NULL, set to the value of the largest element
+       * \return global index of the largest element, -1 if the tensor has no elements
+       */
+      int64_t argmax(dtype * val=NULL) const;
+
       /**
        * \brief fills local unique tensor elements to random values in the range [min,max]
        *        works only for dtype in {float,double,int,int64_t}, for others you can use Transform()
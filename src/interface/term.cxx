@@ -96,6 +96,8 @@ namespace CTF_int {
     }
     bool is_sparse_C = A.parent->is_sparse && B.parent->is_sparse;
     tensor * tsr_C = new tensor(A.parent->sr, order_C, len_C, sym_C, A.parent->wrld, true, NULL, 1, is_sparse_C);
+    //intermediates need no home mapping, so they stay in the mapping of the operation producing them
+    if (!is_sparse_C) tsr_C->leave_home_with_buffer();
     Idx_Tensor * out = new Idx_Tensor(tsr_C, idx_C);
     //printf("A_inds =");
     //for (int i=0; i<A.parent->order; i++){
@@ -118,6 +120,16 @@ namespace CTF_int {
 
   }
 
+  /**
+   * \brief scaling of a freshly allocated (zero) intermediate when it is the output of a contraction,
+   *        zero allows the contraction to allocate it directly in the selected mapping
+   * \param[in] intm intermediate obtained via get_full_intm
+   */
+  char const * get_intm_beta(Idx_Tensor const * intm){
+    if (intm->sr->addid() != NULL) return intm->sr->addid();
+    return intm->scale;
+  }
+
   Idx_Tensor * get_full_intm(Idx_Tensor& A, 
                              Idx_Tensor& B,
                              int num_out_inds,
@@ -165,6 +177,7 @@ namespace CTF_int {
       }
     }
     tensor * tsr_C = new tensor(A.parent->sr, order_C, len_C, sym_C, A.parent->wrld, 1);
+    tsr_C->leave_home_with_buffer();
     Idx_Tensor * out = new Idx_Tensor(tsr_C, idx_C);
     out->is_intm = 1;
     cdealloc(sym_C);
@@ -212,6 +225,8 @@ namespace CTF_int {
     }
   }
 
+  void Term::prefetch(Idx_Tensor output) const { }
+
   Contract_Term Term::operator*(Term const & A) const {
     Contract_Term trm(this->clone(),A.clone());
     return trm;
@@ -466,6 +481,20 @@ namespace CTF_int {
   void Sum_Term::execute(Idx_Tensor output) const{
     std::vector< Term* > tmp_ops = operands;
     for (int i=0; i<((int)tmp_ops.size())-1; i++){
+      //remap operands of next term while this one executes, if they are disjoint
+      if (i+1<((int)tmp_ops.size())-1){
+        std::set<Idx_Tensor*, tensor_name_less > inputs, next_inputs;
+        tmp_ops[i]->get_inputs(&inputs);
+        tmp_ops[i+1]->get_inputs(&next_inputs);
+        bool is_disjoint = true;
+        for (std::set<Idx_Tensor*>::iterator j=next_inputs.begin(); j!=next_inputs.end(); j++){
+          if ((*j)->parent == output.parent) is_disjoint = false;
+          for (std::set<Idx_Tensor*>::iterator k=inputs.begin(); k!=inputs.end(); k++){
+            if ((*j)->parent == (*k)->parent) is_disjoint = false;
+          }
+        }
+        if (is_disjoint) tmp_ops[i+1]->prefetch(output);
+      }
       tmp_ops[i]->execute(output);
       sr->safecopy(output.scale, sr->mulid());
     }
@@ -586,7 +615,7 @@ namespace CTF_int {
         sr->safemul(tscale, op_B.scale, tscale);
         contraction c(op_A.parent, op_A.idx_map,
                       op_B.parent, op_B.idx_map, tscale,
-                      intm->parent, intm->idx_map, intm->scale);
+                      intm->parent, intm->idx_map, get_intm_beta(intm));
         c.execute(); 
         sr->safecopy(tscale, sr->mulid());
         tmp_ops.push_back(intm);
@@ -632,6 +661,18 @@ namespace CTF_int {
   }
 
 
+  void Contract_Term::prefetch(Idx_Tensor output) const {
+    if (operands.size() != 2 || output.parent == NULL) return;
+    Idx_Tensor const * op_A = dynamic_cast<Idx_Tensor const *>(operands[0]);
+    Idx_Tensor const * op_B = dynamic_cast<Idx_Tensor const *>(operands[1]);
+    if (op_A == NULL || op_B == NULL || op_A->parent == NULL || op_B->parent == NULL) return;
+    contraction c(op_A->parent, op_A->idx_map,
+                  op_B->parent, op_B->idx_map, sr->mulid(),
+                  output.parent, output.idx_map, output.scale);
+    c.prefetch();
+  }
+
+
   Idx_Tensor Contract_Term::execute() const {
     std::vector< Term* > tmp_ops;
     for (int i=0; i<(int)operands.size(); i++){
@@ -658,7 +699,7 @@ namespace CTF_int {
         sr->safemul(tscale, op_B.scale, tscale);
         contraction c(op_A.parent, op_A.idx_map,
                       op_B.parent, op_B.idx_map, tscale,
-                      intm->parent, intm->idx_map, intm->scale);
+                      intm->parent, intm->idx_map, get_intm_beta(intm));
         c.execute(); 
         sr->safecopy(tscale, sr->mulid());
         tmp_ops.push_back(intm);
@@ -698,7 +739,7 @@ namespace CTF_int {
         Idx_Tensor * intm = get_full_intm(op_A, op_B);
         contraction c(op_A.parent, op_A.idx_map,
                       op_B.parent, op_B.idx_map, this->scale, 
-                      intm->parent, intm->idx_map, intm->scale);
+                      intm->parent, intm->idx_map, get_intm_beta(intm));
         cost += c.estimate_time();
         tmp_ops.push_back(intm);
       }
@@ -757,7 +798,7 @@ namespace CTF_int {
         Idx_Tensor * intm = get_full_intm(op_A, op_B);
         contraction c(op_A.parent, op_A.idx_map,
                       op_B.parent, op_B.idx_map, this->scale, 
-                      intm->parent, intm->idx_map, intm->scale);
+                      intm->parent, intm->idx_map, get_intm_beta(intm));
         cost += c.estimate_time();
 
         tmp_ops.push_back(intm);
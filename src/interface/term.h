@@ -70,6 +70,13 @@ namespace CTF_int {
        *        all expression indices remaining
        */
       virtual CTF::Idx_Tensor execute() const = 0;
+
+      /**
+       * \brief starts asynchronous redistribution of the operands of the term
+       *        to the mapping execute(output) will use, does nothing by default
+       * \param[in] output tensor the term will be written into and its indices
+       */
+      virtual void prefetch(CTF::Idx_Tensor output) const;
       
       /**
       * \brief appends the tensors this depends on to the input set
@@ -301,6 +308,13 @@ namespace CTF_int {
        * \return output tensor to write results into and its indices
        */
       CTF::Idx_Tensor estimate_time(double  & cost) const;
+
+      /**
+       * \brief starts redistributing the operands of a pairwise contraction
+       *        to the mapping with which it will be executed into output
+       * \param[in] output tensor the term will be written into and its indices
+       */
+      void prefetch(CTF::Idx_Tensor output) const;
       
       
       /**
@@ -50,13 +50,30 @@ namespace CTF {
   class Timer{
     public:
       char const * timer_name;
+      int id;
       int index;
       int exited;
       int original;
     
     public:
       Timer(char const * name);
+
+      /**
+       * \brief constructor for a timer whose name has already been interned,
+       *        so that the name need not be looked up (used by TAU_FSTART/TAU_FSTOP)
+       * \param[in] name name of timer
+       * \param[in] id result of get_id(name)
+       */
+      Timer(char const * name, int id);
+
       ~Timer();
+
+      /**
+       * \brief interns a timer name, returning the same id for every call with the same name
+       * \param[in] name name of timer
+       */
+      static int get_id(char const * name);
+
       void stop();
       void start();
       void exit();
@@ -119,11 +136,89 @@ namespace CTF {
 
   };
 
+  /**
+   * \brief predicted and measured cost of one layer of the nested algorithm that executes a contraction
+   */
+  struct Contraction_Layer_Report {
+    /** \brief type of the layer, e.g. ctr_replicate, ctr_2d_general, ctr_virt, or seq_tsr_ctr for the local kernel */
+    std::string name;
+    /** \brief time predicted by the models for this layer and the layers below it */
+    double est_time;
+    /** \brief measured time of this layer and the layers below it, summed over its calls */
+    double exe_time;
+    /** \brief number of times the layer was run */
+    int64_t nrun;
+  };
+
+  /**
+   * \brief performance report of a contraction on this process, recorded between
+   *        start_contraction_reports() and stop_contraction_reports(). If the contraction is done
+   *        in multiple parts (e.g. due to symmetry), times, bytes and flops are summed over the parts
+   *        and the mapping and layers are those of the last part.
+   */
+  class Contraction_Report {
+    public:
+      /** \brief the contraction, e.g. C[ij]+=A[ik]*B[kj] with the names of the tensors and the indices relabeled as letters */
+      std::string term;
+      /** \brief chosen mappings of the operands, each index is mapped to p<np>(<grid dimension>) and/or v<virtualization> */
+      std::string map_A, map_B, map_C;
+      /** \brief time predicted for the chosen algorithm */
+      double est_time;
+      /** \brief total time of the contraction */
+      double tot_time;
+      /** \brief time spent selecting the mapping */
+      double map_time;
+      /** \brief time spent redistributing operands to the chosen mapping */
+      double redist_time;
+      /** \brief time spent in the nested algorithm */
+      double ctr_time;
+      /** \brief bytes sent by this process to redistribute A, B, and C */
+      int64_t redist_bytes[3];
+      /** \brief flops counted on this process */
+      int64_t flops;
+      /** \brief peak of the memory used by tensor data on this process during the contraction */
+      int64_t mem_peak;
+      /** \brief memory predicted to be needed for buffers by the chosen algorithm */
+      int64_t mem_est;
+      /** \brief layers of the nested algorithm, from the outermost to the local kernel */
+      std::vector<Contraction_Layer_Report> layers;
+
+      Contraction_Report();
+
+      /**
+       * \brief returns the report as a JSON object
+       */
+      std::string to_json() const;
+  };
+
+  /**
+   * \brief starts recording a report of every contraction executed by this process, discarding reports recorded previously
+   */
+  void start_contraction_reports();
+
+  /**
+   * \brief stops recording contraction reports
+   * \return the reports recorded since start_contraction_reports(), in order of execution
+   */
+  std::vector<Contraction_Report> stop_contraction_reports();
+
 /**
  * @}
  */
 }
 
+namespace CTF_int {
+  /**
+   * \brief whether contraction reports are being recorded
+   */
+  bool is_recording_ctr_reports();
+
+  /**
+   * \brief appends a report to those recorded, if recording
+   */
+  void record_ctr_report(CTF::Contraction_Report const & r);
+}
+
 
 #endif
 
@@ -120,6 +120,8 @@ namespace CTF {
 #ifdef HPM
       HPM_Stop("CTF");
 #endif
+      char * file_path = getenv("CTF_MODEL_FILE");
+      CTF_int::finish_model_learning(file_path == NULL ? "" : std::string(file_path));
       TAU_FSTOP(CTF);
     }
 
@@ -131,6 +133,7 @@ namespace CTF {
                   int             argc,
                   const char * const *  argv){
     cdt = CommData(comm);
+    cdt.detect_nodes();
     if (mach == TOPOLOGY_GENERIC)
       phys_topology = NULL;
     else
@@ -146,6 +149,7 @@ namespace CTF {
                   const char * const * argv){
 
     cdt = CommData(global_context);
+    cdt.detect_nodes();
     phys_topology = new topology(order, dim_len, cdt, 1);
 
     return initialize(argc, argv);
@@ -212,11 +216,22 @@ namespace CTF {
   #endif
       // Get the environment variable FILE_PATH
       char * file_path = getenv("CTF_MODEL_FILE");
+      char * learn_sample = getenv("CTF_LEARN_MODELS");
+      bool learn = learn_sample != NULL && atoi(learn_sample) > 0;
       if (file_path != NULL && strcmp(file_path,"")!=0){
-        VPRINTF(1,"Reading model coefficients from file %s (CTF_MODEL_FILE)\n", file_path);
-        std::string coeff_file;
-        coeff_file = std::string(file_path);
-        CTF_int::load_all_models(coeff_file);
+        FILE * coeff_fp = fopen(file_path, "r");
+        // when learning, a missing file is created at exit
+        if (coeff_fp != NULL || !learn){
+          VPRINTF(1,"Reading model coefficients from file %s (CTF_MODEL_FILE)\n", file_path);
+          std::string coeff_file;
+          coeff_file = std::string(file_path);
+          CTF_int::load_all_models(coeff_file);
+        }
+        if (coeff_fp != NULL) fclose(coeff_fp);
+      }
+      if (learn){
+        VPRINTF(1,"Learning models from every %d-th observation (CTF_LEARN_MODELS)\n", atoi(learn_sample));
+        CTF_int::start_model_learning(atoi(learn_sample));
       }
     
       mst_size = getenv("CTF_MST_SIZE");
@@ -252,6 +267,12 @@ namespace CTF {
                     imem_size);
         CTF_int::set_mem_size(imem_size);
       }
+      char * ooc = getenv("CTF_OUT_OF_CORE");
+      if (ooc != NULL && atoi(ooc) > 0){
+        if (rank == 0)
+          VPRINTF(1,"Streaming contractions that do not fit in memory in slabs (CTF_OUT_OF_CORE)\n");
+        CTF::OUT_OF_CORE = 1;
+      }
       ppn = getenv("CTF_PPN");
       if (ppn != NULL){
         if (rank == 0)
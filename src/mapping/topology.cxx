@@ -34,6 +34,8 @@ namespace CTF_int {
     lda          = (int*)CTF_int::alloc(order*sizeof(int));
     memcpy(lda, other.lda, order*sizeof(int));
 
+    intra_order  = other.intra_order;
+
     dim_comm = (CommData*)CTF_int::alloc(order*sizeof(CommData));
     for (int i=0; i<order; i++){
       dim_comm[i] = CommData(other.dim_comm[i]);
@@ -69,6 +71,14 @@ namespace CTF_int {
       stride*=lens[i];
       cut = (rank - (rank/stride)*stride);
     }
+    // a dimension lies within a node if the block of consecutive ranks it spans divides the node
+    intra_order = 0;
+    for (int i=0; i<order; i++){
+      if (glb_comm.node_np > 1 && glb_comm.node_np % (lda[i]*lens[i]) == 0){
+        dim_comm[i].intra_node = true;
+        intra_order = i+1;
+      }
+    }
     if (activate)
       this->activate();
   }
@@ -106,7 +116,20 @@ namespace CTF_int {
     }
     if (mach == TOPOLOGY_GENERIC){
       int order;
-      factorize(np, &order, &dim_len);
+      int node_np = glb_comm.node_np;
+      if (node_np > 1 && node_np < np && np % node_np == 0){
+        int intra_order, inter_order;
+        int * intra_lens, * inter_lens;
+        factorize(node_np, &intra_order, &intra_lens);
+        factorize(np/node_np, &inter_order, &inter_lens);
+        order = intra_order + inter_order;
+        dim_len = (int*)CTF_int::alloc(order*sizeof(int));
+        memcpy(dim_len, intra_lens, intra_order*sizeof(int));
+        memcpy(dim_len+intra_order, inter_lens, inter_order*sizeof(int));
+        CTF_int::cdealloc(intra_lens);
+        CTF_int::cdealloc(inter_lens);
+      } else
+        factorize(np, &order, &dim_len);
       topo = new topology(order, dim_len, glb_comm, 1);
       if (order>0) CTF_int::cdealloc(dim_len);
       return topo;
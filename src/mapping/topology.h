@@ -16,6 +16,8 @@ namespace CTF_int {
       int        order;
       int *      lens;
       int *      lda;
+      /** \brief number of leading torus dimensions each of whose rank sets resides on a single node */
+      int        intra_order;
       bool       is_activated;
       CommData * dim_comm;
       CommData   glb_comm;
@@ -49,7 +51,8 @@ namespace CTF_int {
   };
 
   /**
-   * \brief get dimension and torus lengths of specified topology
+   * \brief get dimension and torus lengths of specified topology,
+   *        for generic topologies, the ranks on each node (if glb_comm.node_np > 1) are factored into the leading dimensions
    *
    * \param[in] glb_comm communicator
    * \param[in] mach specified topology
@@ -0,0 +1,378 @@
+/*Copyright (c) 2011, Edgar Solomonik, all rights reserved.*/
+
+#include "dense_slice.h"
+#include "../shared/util.h"
+#include "../tensor/untyped_tensor.h"
+#include "../mapping/mapping.h"
+#include "../mapping/topology.h"
+
+namespace CTF_int {
+
+  /**
+   * \brief where each element of a tensor resides: local offsets of owned indices along each mode
+   *        and the contribution of each mode to the rank of the owning process
+   */
+  struct cyclic_layout {
+    int order;
+    /** \brief phase, physical phase, and physical rank of this process along each mode */
+    int * phase, * phys_phase, * phys_rank;
+    /** \brief local stride between virtual blocks and between elements of a block along each mode */
+    int64_t * virt_lda, * blk_lda;
+    /** \brief rank_contrib[i][p] is the offset in the world rank of the process with physical rank p along mode i */
+    int ** rank_contrib;
+    /** \brief number of copies of the tensor and offset of each copy in the world rank */
+    int nrep;
+    int * rep_offset;
+    /** \brief offset of this process's world rank from that of the process holding the first copy */
+    int my_rep_offset;
+  };
+
+  static void init_layout(cyclic_layout & l, tensor const * T){
+    l.order = T->order;
+    l.phase        = (int*)alloc(sizeof(int)*T->order);
+    l.phys_phase   = (int*)alloc(sizeof(int)*T->order);
+    l.phys_rank    = (int*)alloc(sizeof(int)*T->order);
+    l.virt_lda     = (int64_t*)alloc(sizeof(int64_t)*T->order);
+    l.blk_lda      = (int64_t*)alloc(sizeof(int64_t)*T->order);
+    l.rank_contrib = (int**)alloc(sizeof(int*)*T->order);
+
+    int nvirt = 1;
+    for (int i=0; i<T->order; i++){
+      mapping const * map = T->edge_map+i;
+      l.phase[i]      = map->calc_phase();
+      l.phys_phase[i] = map->calc_phys_phase();
+      l.phys_rank[i]  = map->calc_phys_rank(T->topo);
+      nvirt *= l.phase[i]/l.phys_phase[i];
+    }
+    int64_t blk_sz = T->size/nvirt;
+    for (int i=0; i<T->order; i++){
+      if (i == 0){
+        l.virt_lda[i] = blk_sz;
+        l.blk_lda[i]  = 1;
+      } else {
+        l.virt_lda[i] = l.virt_lda[i-1]*(l.phase[i-1]/l.phys_phase[i-1]);
+        l.blk_lda[i]  = l.blk_lda[i-1]*(T->pad_edge_len[i-1]/l.phase[i-1]);
+      }
+    }
+
+    // physical ranks are composed over the chain of mappings of each mode, as in mapping::calc_phys_rank
+    bool is_mapped[T->topo->order];
+    std::fill(is_mapped, is_mapped+T->topo->order, false);
+    for (int i=0; i<T->order; i++){
+      l.rank_contrib[i] = (int*)alloc(sizeof(int)*l.phys_phase[i]);
+      for (int p=0; p<l.phys_phase[i]; p++){
+        int pr = p;
+        int contrib = 0;
+        mapping const * map = T->edge_map+i;
+        while (map != NULL && map->type != NOT_MAPPED){
+          if (map->type == PHYSICAL_MAP){
+            contrib += (pr % map->np)*T->topo->lda[map->cdt];
+            pr = pr / map->np;
+            is_mapped[map->cdt] = true;
+          }
+          map = map->has_child ? map->child : NULL;
+        }
+        l.rank_contrib[i][p] = contrib;
+      }
+    }
+
+    l.nrep = 1;
+    for (int j=0; j<T->topo->order; j++){
+      if (!is_mapped[j]) l.nrep *= T->topo->lens[j];
+    }
+    l.rep_offset = (int*)alloc(sizeof(int)*l.nrep);
+    l.rep_offset[0] = 0;
+    l.my_rep_offset = 0;
+    int nr = 1;
+    for (int j=0; j<T->topo->order; j++){
+      if (!is_mapped[j]){
+        for (int c=1; c<T->topo->lens[j]; c++){
+          for (int r=0; r<nr; r++){
+            l.rep_offset[c*nr+r] = l.rep_offset[r] + c*T->topo->lda[j];
+          }
+        }
+        nr *= T->topo->lens[j];
+        l.my_rep_offset += T->topo->dim_comm[j].rank*T->topo->lda[j];
+      }
+    }
+  }
+
+  static void free_layout(cyclic_layout & l){
+    for (int i=0; i<l.order; i++){
+      cdealloc(l.rank_contrib[i]);
+    }
+    cdealloc(l.rank_contrib);
+    cdealloc(l.phase);
+    cdealloc(l.phys_phase);
+    cdealloc(l.phys_rank);
+    cdealloc(l.virt_lda);
+    cdealloc(l.blk_lda);
+    cdealloc(l.rep_offset);
+  }
+
+  /**
+   * \brief enumerates the indices of a block along one mode that are stored by this process
+   * \param[in] l layout of local tensor
+   * \param[in] i mode
+   * \param[in] lo first index of block
+   * \param[in] hi index past end of block
+   * \param[out] glb_idx global indices of owned elements (preallocated to hi-lo)
+   * \param[out] loc_off offsets of owned elements in local data (preallocated to hi-lo)
+   * \return number of owned elements
+   */
+  static int owned_indices(cyclic_layout const & l,
+                           int                   i,
+                           int                   lo,
+                           int                   hi,
+                           int *                 glb_idx,
+                           int64_t *             loc_off){
+    int n = 0;
+    for (int g=lo; g<hi; g++){
+      int pr = g % l.phase[i];
+      if (pr % l.phys_phase[i] == l.phys_rank[i]){
+        glb_idx[n] = g;
+        loc_off[n] = (pr / l.phys_phase[i])*l.virt_lda[i] + (g / l.phase[i])*l.blk_lda[i];
+        n++;
+      }
+    }
+    return n;
+  }
+
+  /**
+   * \brief visits the owned elements of a block in slice order (first mode fastest), passing their local offset and remote rank
+   * \param[in] order number of modes
+   * \param[in] num number of owned indices along each mode
+   * \param[in] loc_off local offsets of owned indices along each mode
+   * \param[in] rank_off contribution of each owned index to the remote rank along each mode
+   * \param[in] base_rank remote rank contribution common to all elements
+   * \param[in] f function called with local offset and remote rank of each element
+   */
+  template <typename func>
+  static void for_each_owned(int                     order,
+                             int const *             num,
+                             int64_t const * const * loc_off,
+                             int const * const *     rank_off,
+                             int                     base_rank,
+                             func                    f){
+    for (int i=0; i<order; i++){
+      if (num[i] == 0) return;
+    }
+    int idx[order];
+    std::fill(idx, idx+order, 0);
+    for (;;){
+      int64_t off = 0;
+      int rank = base_rank;
+      for (int i=1; i<order; i++){
+        off  += loc_off[i][idx[i]];
+        rank += rank_off[i][idx[i]];
+      }
+      for (int j=0; j<num[0]; j++){
+        f(off+loc_off[0][j], rank+rank_off[0][j]);
+      }
+      int i;
+      for (i=1; i<order; i++){
+        idx[i]++;
+        if (idx[i] < num[i]) break;
+        idx[i] = 0;
+      }
+      if (i >= order) break;
+    }
+  }
+
+  /**
+   * \brief computes the owned indices of the block of tensor T along each mode and the rank of the process
+   *        owning the corresponding element of the block of the other tensor R
+   * \param[in] lT layout of T
+   * \param[in] offsets_T bottom corner of block of T
+   * \param[in] ends_T top corner of block of T
+   * \param[in] lR layout of R
+   * \param[in] offsets_R bottom corner of block of R
+   * \param[in] ends_R top corner of block of R
+   * \param[out] num number of owned indices along each mode of T
+   * \param[out] loc_off local offsets of owned indices along each mode of T
+   * \param[out] rank_off contribution to rank of owner in R along each mode of T
+   * \return contribution to rank of owner in R of modes of R that have extent one and are not matched with a mode of T
+   */
+  static int match_block(cyclic_layout const & lT,
+                         int const *           offsets_T,
+                         int const *           ends_T,
+                         cyclic_layout const & lR,
+                         int const *           offsets_R,
+                         int const *           ends_R,
+                         int *                 num,
+                         int64_t **            loc_off,
+                         int **                rank_off){
+    // modes of extent greater than one are matched in order, modes of extent one may be unmatched
+    int match_R[lT.order];
+    bool is_matched_R[lR.order];
+    std::fill(is_matched_R, is_matched_R+lR.order, false);
+    int iR = 0;
+    for (int i=0; i<lT.order; i++){
+      match_R[i] = -1;
+      if (ends_T[i] - offsets_T[i] > 1){
+        while (ends_R[iR] - offsets_R[iR] == 1) iR++;
+        ASSERT(ends_R[iR] - offsets_R[iR] == ends_T[i] - offsets_T[i]);
+        match_R[i] = iR;
+        is_matched_R[iR] = true;
+        iR++;
+      }
+    }
+    int base_rank = 0;
+    for (int j=0; j<lR.order; j++){
+      if (!is_matched_R[j])
+        base_rank += lR.rank_contrib[j][(offsets_R[j] % lR.phase[j]) % lR.phys_phase[j]];
+    }
+    for (int i=0; i<lT.order; i++){
+      int ext = ends_T[i] - offsets_T[i];
+      int * glb_idx = (int*)alloc(sizeof(int)*ext);
+      loc_off[i]  = (int64_t*)alloc(sizeof(int64_t)*ext);
+      rank_off[i] = (int*)alloc(sizeof(int)*ext);
+      num[i] = owned_indices(lT, i, offsets_T[i], ends_T[i], glb_idx, loc_off[i]);
+      int j = match_R[i];
+      for (int k=0; k<num[i]; k++){
+        if (j == -1)
+          rank_off[i][k] = 0;
+        else {
+          int g = glb_idx[k] - offsets_T[i] + offsets_R[j];
+          rank_off[i][k] = lR.rank_contrib[j][(g % lR.phase[j]) % lR.phys_phase[j]];
+        }
+      }
+      cdealloc(glb_idx);
+    }
+    return base_rank;
+  }
+
+  bool can_dense_slice(tensor const * A,
+                       tensor const * B){
+    tensor const * tsrs[] = {A, B};
+    for (int t=0; t<2; t++){
+      tensor const * T = tsrs[t];
+      if (T->is_sparse || !T->is_mapped || T->is_folded || !T->is_cyclic ||
+          T->order == 0 || T->has_zero_edge_len) return false;
+      for (int i=0; i<T->order; i++){
+        if (T->sym[i] != NS) return false;
+      }
+    }
+    return A->wrld->cdt.cm == B->wrld->cdt.cm && A->sr->el_size == B->sr->el_size;
+  }
+
+  void dense_slice(int const *  offsets_B,
+                   int const *  ends_B,
+                   char const * beta,
+                   tensor *     B,
+                   tensor *     A,
+                   int const *  offsets_A,
+                   int const *  ends_A,
+                   char const * alpha){
+    TAU_FSTART(dense_slice);
+    A->wait_redistribute();
+    B->wait_redistribute();
+
+    algstrct const * sr = B->sr;
+    int64_t el_size = sr->el_size;
+    int np = B->wrld->np;
+
+    cyclic_layout lA, lB;
+    init_layout(lA, A);
+    init_layout(lB, B);
+
+    int64_t * send_counts = (int64_t*)alloc(sizeof(int64_t)*np);
+    int64_t * send_displs = (int64_t*)alloc(sizeof(int64_t)*np);
+    int64_t * recv_counts = (int64_t*)alloc(sizeof(int64_t)*np);
+    int64_t * recv_displs = (int64_t*)alloc(sizeof(int64_t)*np);
+    std::fill(send_counts, send_counts+np, 0);
+    std::fill(recv_counts, recv_counts+np, 0);
+
+    // only the first copy of A sends its elements, to every copy of B
+    int num_A[A->order];
+    int64_t * loc_off_A[A->order];
+    int * rank_off_A[A->order];
+    int base_A = match_block(lA, offsets_A, ends_A, lB, offsets_B, ends_B, num_A, loc_off_A, rank_off_A);
+    bool is_sender = (lA.my_rep_offset == 0);
+    if (is_sender){
+      for_each_owned(A->order, num_A, loc_off_A, rank_off_A, base_A,
+        [&](int64_t off, int rank){
+          for (int r=0; r<lB.nrep; r++)
+            send_counts[rank+lB.rep_offset[r]]++;
+        });
+    }
+
+    int num_B[B->order];
+    int64_t * loc_off_B[B->order];
+    int * rank_off_B[B->order];
+    int base_B = match_block(lB, offsets_B, ends_B, lA, offsets_A, ends_A, num_B, loc_off_B, rank_off_B);
+    for_each_owned(B->order, num_B, loc_off_B, rank_off_B, base_B,
+      [&](int64_t off, int rank){
+        recv_counts[rank]++;
+      });
+
+    send_displs[0] = 0;
+    recv_displs[0] = 0;
+    for (int p=1; p<np; p++){
+      send_displs[p] = send_displs[p-1] + send_counts[p-1];
+      recv_displs[p] = recv_displs[p-1] + recv_counts[p-1];
+    }
+    int64_t send_sz = send_displs[np-1] + send_counts[np-1];
+    int64_t recv_sz = recv_displs[np-1] + recv_counts[np-1];
+    char * send_buffer = (char*)alloc(std::max((int64_t)1,send_sz)*el_size);
+    char * recv_buffer = (char*)alloc(std::max((int64_t)1,recv_sz)*el_size);
+
+    int64_t * cursor = (int64_t*)alloc(sizeof(int64_t)*np);
+    if (is_sender){
+      memcpy(cursor, send_displs, sizeof(int64_t)*np);
+      char const * data_A = A->data;
+      for_each_owned(A->order, num_A, loc_off_A, rank_off_A, base_A,
+        [&](int64_t off, int rank){
+          for (int r=0; r<lB.nrep; r++){
+            int p = rank+lB.rep_offset[r];
+            memcpy(send_buffer+el_size*cursor[p], data_A+el_size*off, el_size);
+            cursor[p]++;
+          }
+        });
+    }
+
+    B->wrld->cdt.all_to_allv(send_buffer, send_counts, send_displs, el_size,
+                             recv_buffer, recv_counts, recv_displs);
+    cdealloc(send_buffer);
+
+    memcpy(cursor, recv_displs, sizeof(int64_t)*np);
+    char * data_B = B->data;
+    bool is_overwrite = (beta == NULL || sr->isequal(beta, sr->addid()));
+    bool is_copy = is_overwrite && (alpha == NULL || sr->isequal(alpha, sr->mulid()));
+    char * tmp = (char*)alloc(el_size);
+    for_each_owned(B->order, num_B, loc_off_B, rank_off_B, base_B,
+      [&](int64_t off, int rank){
+        char const * val = recv_buffer+el_size*cursor[rank];
+        char * dst = data_B+el_size*off;
+        cursor[rank]++;
+        if (is_copy)
+          sr->copy(dst, val);
+        else if (is_overwrite)
+          sr->mul(alpha, val, dst);
+        else {
+          sr->mul(alpha, val, tmp);
+          sr->mul(beta, dst, dst);
+          sr->add(dst, tmp, dst);
+        }
+      });
+    cdealloc(tmp);
+    cdealloc(cursor);
+    cdealloc(recv_buffer);
+
+    for (int i=0; i<A->order; i++){
+      cdealloc(loc_off_A[i]);
+      cdealloc(rank_off_A[i]);
+    }
+    for (int i=0; i<B->order; i++){
+      cdealloc(loc_off_B[i]);
+      cdealloc(rank_off_B[i]);
+    }
+    cdealloc(send_counts);
+    cdealloc(send_displs);
+    cdealloc(recv_counts);
+    cdealloc(recv_displs);
+    free_layout(lA);
+    free_layout(lB);
+    TAU_FSTOP(dense_slice);
+  }
+}
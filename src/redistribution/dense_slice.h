@@ -0,0 +1,44 @@
+/*Copyright (c) 2011, Edgar Solomonik, all rights reserved.*/
+
+#ifndef __DENSE_SLICE_H__
+#define __DENSE_SLICE_H__
+
+#include "../tensor/algstrct.h"
+
+namespace CTF_int {
+  class tensor;
+
+  /**
+   * \brief whether dense_slice can move the given slice between A and B,
+   *        requires dense, nonsymmetric, mapped and unfolded tensors with cyclic layouts on the same communicator
+   * \param[in] A tensor to read slice from
+   * \param[in] B tensor to write slice to
+   */
+  bool can_dense_slice(tensor const * A,
+                       tensor const * B);
+
+  /**
+   * \brief accumulates a block of A into a block of B, B[offsets_B:ends_B] = beta*B[offsets_B:ends_B] + alpha*A[offsets_A:ends_A],
+   *        without forming key-value pairs, each process determines from the cyclic distributions of A and B
+   *        which of its elements belong to the slice and which process owns their counterparts,
+   *        packs the strided elements in slice order and exchanges them via a single all-to-all-v.
+   *        Modes of extent one may be present in one block but not the other, as in tensor::slice.
+   * \param[in] offsets_B bottom corner of block of B
+   * \param[in] ends_B top corner of block of B
+   * \param[in] beta scaling factor for the block of B
+   * \param[in,out] B tensor to write slice to
+   * \param[in] A tensor to read slice from
+   * \param[in] offsets_A bottom corner of block of A
+   * \param[in] ends_A top corner of block of A
+   * \param[in] alpha scaling factor for the block of A
+   */
+  void dense_slice(int const *  offsets_B,
+                   int const *  ends_B,
+                   char const * beta,
+                   tensor *     B,
+                   tensor *     A,
+                   int const *  offsets_A,
+                   int const *  ends_A,
+                   char const * alpha);
+}
+#endif
@@ -111,4 +111,33 @@ namespace CTF_int {
     }
 
   }
+
+  redist_request * dgtog_reshuffle_post(int const *          sym,
+                                        int const *          edge_len,
+                                        distribution const & old_dist,
+                                        distribution const & new_dist,
+                                        char **              ptr_tsr_data,
+                                        algstrct const *     sr,
+                                        CommData             ord_glb_comm){
+    switch (CTF::DGTOG_SWITCH){
+      case 0:
+        return CTF_redist_noror::dgtog_post(sym, edge_len, old_dist, new_dist, ptr_tsr_data, sr, ord_glb_comm);
+      case 1:
+        return CTF_redist_ror::dgtog_post(sym, edge_len, old_dist, new_dist, ptr_tsr_data, sr, ord_glb_comm);
+      case 2:
+        return CTF_redist_ror_isr::dgtog_post(sym, edge_len, old_dist, new_dist, ptr_tsr_data, sr, ord_glb_comm);
+      case 3:
+        return CTF_redist_ror_put::dgtog_post(sym, edge_len, old_dist, new_dist, ptr_tsr_data, sr, ord_glb_comm);
+      case 4:
+        return CTF_redist_ror_isr_any::dgtog_post(sym, edge_len, old_dist, new_dist, ptr_tsr_data, sr, ord_glb_comm);
+#ifdef USE_FOMPI
+      case 5:
+        return CTF_redist_ror_put_any::dgtog_post(sym, edge_len, old_dist, new_dist, ptr_tsr_data, sr, ord_glb_comm);
+#endif
+      default:
+        if (ord_glb_comm.rank == 0) printf("CTF ERROR: redistribution variant %d cannot be posted asynchronously\n", CTF::DGTOG_SWITCH);
+        assert(0);
+        return NULL;
+    }
+  }
 }
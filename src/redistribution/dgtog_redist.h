@@ -9,6 +9,41 @@ namespace CTF_int {
    */
   double dgtog_est_time(int64_t tot_sz, int np);
 
+  /**
+   * \brief handle for a redistribution whose data has been packed and whose
+   *        messages have been posted, but which has not yet been completed
+   */
+  class redist_request {
+    public:
+      virtual ~redist_request(){}
+
+      /**
+       * \brief completes communication and unpacks received data
+       * \return buffer containing the tensor data in the new distribution
+       */
+      virtual char * wait() = 0;
+  };
+
+  /**
+   * \brief starts a dense redistribution, packing data and posting messages,
+   *        so that local work may proceed before the data is needed
+   * \param[in] sym symmetry relations between tensor dimensions
+   * \param[in] edge_len unpadded edge lengths of tensor
+   * \param[in] old_dist starting data distrubtion
+   * \param[in] new_dist target data distrubtion
+   * \param[in,out] ptr_tsr_data starting data buffer, consumed and set to NULL
+   * \param[in] sr algstrct defining data
+   * \param[in] ord_glb_comm communicator on which to redistribute
+   * \return request which must be completed via wait() and deleted
+   */
+  redist_request * dgtog_reshuffle_post(int const *          sym,
+                                        int const *          edge_len,
+                                        distribution const & old_dist,
+                                        distribution const & new_dist,
+                                        char **              ptr_tsr_data,
+                                        algstrct const *     sr,
+                                        CommData             ord_glb_comm);
+
   void dgtog_reshuffle(int const *          sym,
                        int const *          edge_len,
                        distribution const & old_dist,
@@ -64,8 +64,10 @@ void isendrecv<0>
 #else
     if (dir)
       MPI_Irecv(buffer+displs[bucket]*sr->el_size, counts[bucket], sr->mdtype(), pe, MTAG, cm, reqs+bucket);
-    else
+    else {
       MPI_Isend(buffer+displs[bucket]*sr->el_size, counts[bucket], sr->mdtype(), pe, MTAG, cm, reqs+bucket);
+      comm_bytes_add(counts[bucket]*sr->el_size);
+    }
 #endif
   }
 }
@@ -154,6 +156,7 @@ void put_buckets<0>(
 #else
     MPI_Put(buckets[rec_bucket_off], counts[rec_bucket_off], sr->mdtype(), rec_pe_off, put_displs[rec_bucket_off], counts[rec_bucket_off], sr->mdtype(), win);
 #endif
+    comm_bytes_add(counts[rec_bucket_off]*sr->el_size);
   }
 }
 #endif
@@ -286,6 +289,7 @@ void redist_bucket_isr<0>
       int bucket = bucket_off + bucket_offset[0][r];
       int pe = pe_off + pe_offset[0][r];
       MPI_Isend(buckets[bucket], counts[bucket], sr->mdtype(), pe, MTAG, cm, rep_reqs+bucket);
+      comm_bytes_add(counts[bucket]*sr->el_size);
     }
     //progressss please
     if (bucket_off > 0){
@@ -301,36 +305,106 @@ void redist_bucket_isr<0>
 }
 #endif
 
-void dgtog_reshuffle(int const *          sym,
-                     int const *          edge_len,
-                     distribution const & old_dist,
-                     distribution const & new_dist,
-                     char **              ptr_tsr_data,
-                     char **              ptr_tsr_new_data,
-                     algstrct const *     sr,
-                     CommData             ord_glb_comm){
+/**
+ * \brief state of a dense redistribution whose data has been packed and whose
+ *        communication has been posted, but not yet completed
+ */
+class dgtog_request : public CTF_int::redist_request {
+  public:
+    int order;
+    algstrct const * sr;
+    CommData ord_glb_comm;
+    double st_time;
+    int64_t old_size;
+    int64_t new_size;
+    int new_virt_dim0;
+    int old_idx_lyr;
+    int new_idx_lyr;
+    int nold_rep;
+    int nnew_rep;
+    char * tsr_data;
+    char * recv_buffer;
+    char * done_data;
+    int * old_virt_lda;
+    int * new_virt_lda;
+    int * old_phys_edge_len;
+    int * new_phys_edge_len;
+    int * old_virt_edge_len;
+    int * new_virt_edge_len;
+    int * old_rep_phase;
+    int * new_rep_phase;
+    int64_t * send_counts;
+    int64_t * recv_counts;
+    int64_t * recv_displs;
+    int ** recv_bucket_offset;
+    int ** recv_pe_offset;
+    int ** recv_ivmax_pre;
+    int64_t ** recv_data_offset;
+    int ** send_bucket_offset;
+    int ** send_pe_offset;
+    int ** send_ivmax_pre;
+    int64_t ** send_data_offset;
+#ifdef IREDIST
+    CTF_Request * recv_reqs;
+    CTF_Request * send_reqs;
+#endif
+#if !defined(IREDIST) && !defined(PUTREDIST)
+    int64_t * send_displs;
+    CTF_Request * reqs;
+    int nrecv;
+    int nsent;
+#endif
+#ifdef PUTREDIST
+    int64_t * put_displs;
+    CTF_Win win;
+#endif
+
+    /** \brief request for a redistribution which completed on posting, e.g. order 0 */
+    dgtog_request(char * done_data_){
+      done_data = done_data_;
+    }
+
+    dgtog_request(){
+      done_data = NULL;
+    }
+
+    char * wait();
+};
+
+dgtog_request * dgtog_post(int const *          sym,
+                           int const *          edge_len,
+                           distribution const & old_dist,
+                           distribution const & new_dist,
+                           char **              ptr_tsr_data,
+                           algstrct const *     sr,
+                           CommData             ord_glb_comm){
   int order = old_dist.order;
 
   char * tsr_data = *ptr_tsr_data;
-  char * tsr_new_data = *ptr_tsr_new_data;
+  *ptr_tsr_data = NULL;
 
   if (order == 0){
-    tsr_new_data = sr->alloc(1);
+    char * tsr_new_data = sr->alloc(1);
     if (ord_glb_comm.rank == 0){
       sr->copy(tsr_new_data, tsr_data);
     } else {
       sr->copy(tsr_new_data, sr->addid());
     }
-    *ptr_tsr_new_data = tsr_new_data;
     sr->dealloc(tsr_data);
-    return;
+    return new dgtog_request(tsr_new_data);
   }
 #ifdef TUNE
   MPI_Barrier(ord_glb_comm.cm);
 #endif
   TAU_FSTART(dgtog_reshuffle);
-  double st_time = MPI_Wtime();
-
+  dgtog_request * req = new dgtog_request();
+  req->order = order;
+  req->sr = sr;
+  req->ord_glb_comm = ord_glb_comm;
+  req->st_time = MPI_Wtime();
+  req->old_size = old_dist.size;
+  req->new_size = new_dist.size;
+  req->new_virt_dim0 = new_dist.virt_phase[0];
   int * old_virt_lda, * new_virt_lda;
   alloc_ptr(order*sizeof(int),     (void**)&old_virt_lda);
   alloc_ptr(order*sizeof(int),     (void**)&new_virt_lda);
@@ -512,14 +586,10 @@ void dgtog_reshuffle(int const *          sym,
 #endif
     sr->dealloc(aux_buf);
   }
-#ifndef WAITANY
-#ifndef IREDIST
-#ifndef PUTREDIST
+#if !defined(IREDIST) && !defined(PUTREDIST)
   char * recv_buffer = sr->alloc(new_dist.size);
 
-  /* Communicate data */
-  TAU_FSTART(COMM_RESHUFFLE);
-
+  /* Post communication, completed by wait() */
   CTF_Request * reqs = (CTF_Request*)alloc(sizeof(CTF_Request)*(nnew_rep+nold_rep));
   int nrecv = 0;
   if (new_idx_lyr == 0){
@@ -531,38 +601,79 @@ void dgtog_reshuffle(int const *          sym,
     nsent = nold_rep;
     SWITCH_ORD_CALL(isendrecv, order-1, send_pe_offset, send_bucket_offset, old_rep_phase, send_counts, send_displs, reqs+nrecv, ord_glb_comm.cm, tsr_data, sr, 0, 0, 0);
   }
+  req->send_displs        = send_displs;
+  req->reqs               = reqs;
+  req->nrecv              = nrecv;
+  req->nsent              = nsent;
+#endif
+#ifdef IREDIST
+  req->recv_reqs          = recv_reqs;
+  req->send_reqs          = send_reqs;
+#endif
+#ifdef PUTREDIST
+  req->put_displs         = put_displs;
+  req->win                = win;
+#endif
+  req->old_idx_lyr        = old_idx_lyr;
+  req->new_idx_lyr        = new_idx_lyr;
+  req->nold_rep           = nold_rep;
+  req->nnew_rep           = nnew_rep;
+  req->tsr_data           = tsr_data;
+  req->recv_buffer        = recv_buffer;
+  req->old_virt_lda       = old_virt_lda;
+  req->new_virt_lda       = new_virt_lda;
+  req->old_phys_edge_len  = old_phys_edge_len;
+  req->new_phys_edge_len  = new_phys_edge_len;
+  req->old_virt_edge_len  = old_virt_edge_len;
+  req->new_virt_edge_len  = new_virt_edge_len;
+  req->old_rep_phase      = old_rep_phase;
+  req->new_rep_phase      = new_rep_phase;
+  req->send_counts        = send_counts;
+  req->recv_counts        = recv_counts;
+  req->recv_displs        = recv_displs;
+  req->recv_bucket_offset = recv_bucket_offset;
+  req->recv_pe_offset     = recv_pe_offset;
+  req->recv_ivmax_pre     = recv_ivmax_pre;
+  req->recv_data_offset   = recv_data_offset;
+  req->send_bucket_offset = send_bucket_offset;
+  req->send_pe_offset     = send_pe_offset;
+  req->send_ivmax_pre     = send_ivmax_pre;
+  req->send_data_offset   = send_data_offset;
+  TAU_FSTOP(dgtog_reshuffle);
+  return req;
+}
+
+char * dgtog_request::wait(){
+  if (done_data != NULL) return done_data;
+  TAU_FSTART(dgtog_reshuffle_wait);
+#if !defined(IREDIST) && !defined(PUTREDIST)
+  TAU_FSTART(COMM_RESHUFFLE);
   if (nrecv+nsent > 0){
-//      MPI_Status * stat = (MPI_Status*)alloc(sizeof(MPI_Status)*(nrecv+nsent));
     MPI_Waitall(nrecv+nsent, reqs, MPI_STATUSES_IGNORE);
   }
   cdealloc(reqs);
-  //ord_glb_comm.all_to_allv(tsr_data, send_counts, send_displs, sr->el_size,
-  //                         recv_buffer, recv_counts, recv_displs);
   TAU_FSTOP(COMM_RESHUFFLE);
   CTF_int::cdealloc(send_displs);
-#else
+  sr->dealloc(tsr_data);
+#elif !defined(IREDIST)
   CTF_int::cdealloc(put_displs);
   TAU_FSTART(redist_fence);
   MPI_Win_fence(0, win);
   TAU_FSTOP(redist_fence);
   MPI_Win_free(&win);
-#endif
   sr->dealloc(tsr_data);
-#endif
 #endif
   CTF_int::cdealloc(send_counts);
 
   if (new_idx_lyr == 0){
-    char * aux_buf = sr->alloc(new_dist.size);
-    sr->init(new_dist.size, aux_buf);
+    char * aux_buf = sr->alloc(new_size);
+    sr->init(new_size, aux_buf);
 
     char ** buckets = (char**)alloc(sizeof(char**)*nnew_rep);
 
     buckets[0] = recv_buffer;
-    //printf("[%d] size of %dth bucket is %ld\n", ord_glb_comm.rank, 0, send_counts[0]);
     for (int i=1; i<nnew_rep; i++){
       buckets[i] = buckets[i-1] + sr->el_size*recv_counts[i-1];
-      //printf("[%d] size of %dth bucket is %ld\n", ord_glb_comm.rank, i, send_counts[i]);
     }
 
 #if DEBUG >= 1
@@ -575,42 +686,20 @@ void dgtog_reshuffle(int const *          sym,
 
 #ifdef WAITANY
     for (int nb=0; nb<nnew_rep; nb++){
-      //int source;
-/*#ifdef PUT_NOTIFY
-      foMPI_Request req;
-      foMPI_Wait(&req, MPY_ANY_TAG);
-      source = req.source;
-#else*/
       MPI_Status stat;
       int bucket_off;
       MPI_Waitany(nnew_rep, recv_reqs, &bucket_off, &stat);
-//        foMPI_Start(recv_reqs+bucket_off);
-//      ASSERT(ret== MPI_SUCCESS);
       ASSERT(bucket_off != MPI_UNDEFINED);
       ASSERT(bucket_off >= 0 && bucket_off <nnew_rep);
       ASSERT(recv_counts[bucket_off] == 0);
-      //source = stat.source;
-//#endif
       int rep_idx[order];
       int iboff=bucket_off;
       for (int i=0; i<order; i++){
-/*          //FIXME: lame
-        int pe_offi = ((source/MAX(1,old_dist.pe_lda[i]))%old_dist.phys_phase[i])*MAX(1,old_dist.pe_lda[i]);
-        int pidx = -1;
-        for (int j=0; j<new_rep_phase[i]; j++){
-          printf("source = %d i = %d pe_offi=%d recv_pe_offset[i][%d]=%d\n",source,i,pe_offi,j,recv_pe_offset[i][j]);
-          if (pe_offi == recv_pe_offset[i][j]) pidx=j;
-        }
-        ASSERT(pidx!=-1);
-        rep_idx[i] = pidx;
-        bucket_off += recv_bucket_offset[i][pidx];*/
         rep_idx[i] = iboff%new_rep_phase[i];
         iboff = iboff/new_rep_phase[i];
       }
 
-      SWITCH_ORD_CALL(redist_bucket_ror, order-1, recv_bucket_offset, recv_data_offset, recv_ivmax_pre, new_rep_phase, rep_idx, new_dist.virt_phase[0], 0, aux_buf, buckets, recv_counts, sr, 0, bucket_off, 0)
-      //printf("recv_counts[%d]=%d, saved_counts[%d]=%d\n",bucket_off,recv_counts[bucket_off],bucket_off,save_counts[bucket_off]);
-
+      SWITCH_ORD_CALL(redist_bucket_ror, order-1, recv_bucket_offset, recv_data_offset, recv_ivmax_pre, new_rep_phase, rep_idx, new_virt_dim0, 0, aux_buf, buckets, recv_counts, sr, 0, bucket_off, 0)
     }
 #ifdef PUT_NOTIFY
     for (int nb=0; nb<nnew_rep; nb++){
@@ -623,7 +712,7 @@ void dgtog_reshuffle(int const *          sym,
     memset(new_rep_idx, 0, sizeof(int)*order);
     new_rep_idx[0] = -1;
     SWITCH_ORD_CALL(redist_bucket_isr, order-1, order, recv_pe_offset, recv_bucket_offset, recv_data_offset,
-                    recv_ivmax_pre, new_rep_phase, new_rep_idx, new_dist.virt_phase[0],
+                    recv_ivmax_pre, new_rep_phase, new_rep_idx, new_virt_dim0,
 #ifdef IREDIST
                     recv_reqs, ord_glb_comm.cm,
 #endif
@@ -635,7 +724,7 @@ void dgtog_reshuffle(int const *          sym,
 #else
     SWITCH_ORD_CALL(redist_bucket, order-1,
                     recv_bucket_offset, recv_data_offset, recv_ivmax_pre,
-                    new_rep_phase[0], new_dist.virt_phase[0], 0, aux_buf, buckets, recv_counts, sr);
+                    new_rep_phase[0], new_virt_dim0, 0, aux_buf, buckets, recv_counts, sr);
 #endif
 #endif
     TAU_FSTOP(redist_debucket);
@@ -652,16 +741,14 @@ void dgtog_reshuffle(int const *          sym,
     }
     ASSERT(pass);
 #endif
-    *ptr_tsr_new_data = aux_buf;
+    done_data = aux_buf;
     sr->dealloc(recv_buffer);
   } else {
     if (sr->addid() != NULL)
-      sr->set(recv_buffer, sr->addid(), new_dist.size);
-    *ptr_tsr_new_data = recv_buffer;
+      sr->set(recv_buffer, sr->addid(), new_size);
+    done_data = recv_buffer;
   }
-  //printf("[%d] reached final barrier %d\n",ord_glb_comm.rank, MTAG);
 #ifdef IREDIST
-
   CTF_int::cdealloc(recv_reqs);
   CTF_int::cdealloc(send_reqs);
 #endif
@@ -712,9 +799,23 @@ void dgtog_reshuffle(int const *          sym,
   MPI_Barrier(ord_glb_comm.cm);
 #endif
   double exe_time = MPI_Wtime()-st_time;
-  double tps[] = {exe_time, 1.0, (double)log2(ord_glb_comm.np), (double)std::max(old_dist.size, new_dist.size)*log2(ord_glb_comm.np)*sr->el_size};
+  double tps[] = {exe_time, 1.0, (double)log2(ord_glb_comm.np), (double)std::max(old_size, new_size)*log2(ord_glb_comm.np)*sr->el_size};
 
   // double-check
    dgtog_res_mdl.observe(tps);
-  TAU_FSTOP(dgtog_reshuffle);
+  TAU_FSTOP(dgtog_reshuffle_wait);
+  return done_data;
+}
+
+void dgtog_reshuffle(int const *          sym,
+                     int const *          edge_len,
+                     distribution const & old_dist,
+                     distribution const & new_dist,
+                     char **              ptr_tsr_data,
+                     char **              ptr_tsr_new_data,
+                     algstrct const *     sr,
+                     CommData             ord_glb_comm){
+  dgtog_request * req = dgtog_post(sym, edge_len, old_dist, new_dist, ptr_tsr_data, sr, ord_glb_comm);
+  *ptr_tsr_new_data = req->wait();
+  delete req;
 }
@@ -425,8 +425,8 @@ namespace CTF_int {
     int nvirt_A = A->calc_nvirt();
 
 
-#ifdef TUNE
     double st_time = MPI_Wtime();
+#ifdef TUNE
     {
       // Check if we need to execute this function for the sake of training
       int64_t contig0 = 1;
@@ -489,7 +489,6 @@ namespace CTF_int {
       }
     }
 
-#ifdef TUNE 
     int64_t contig0 = 1;
     for (int i=0; i<all_fdim_A; i++){
       if (new_order[i] == i) contig0 *= all_flen_A[i];
@@ -511,7 +510,6 @@ namespace CTF_int {
     } else {
       long_contig_transp_mdl.observe(tps);
     }
-#endif
     TAU_FSTOP(nosym_transpose);
   }
                         
@@ -0,0 +1,181 @@
+/*Copyright (c) 2011, Edgar Solomonik, all rights reserved.*/
+
+#include "pair_cmp.h"
+#include "../shared/util.h"
+
+namespace CTF_int {
+
+  /** \brief maps a signed key difference to an unsigned integer that is small when the difference is small in magnitude */
+  static inline uint64_t zigzag(int64_t d){
+    return (((uint64_t)d) << 1) ^ (uint64_t)(d >> 63);
+  }
+
+  static inline int64_t unzigzag(uint64_t u){
+    return (int64_t)(u >> 1) ^ -(int64_t)(u & 1);
+  }
+
+  static inline int64_t varint_size(uint64_t u){
+    int64_t sz = 1;
+    while (u >= 128){
+      u >>= 7;
+      sz++;
+    }
+    return sz;
+  }
+
+  int64_t get_cmp_pairs_size(int64_t n, char const * pairs, algstrct const * sr){
+    ConstPairIterator pi(sr, pairs);
+    int64_t sz = n*sr->el_size;
+    int64_t prv = 0;
+    for (int64_t i=0; i<n; i++){
+      int64_t k = pi[i].k();
+      sz += varint_size(zigzag(k-prv));
+      prv = k;
+    }
+    return sz;
+  }
+
+  int64_t cmp_pairs(int64_t n, char const * pairs, algstrct const * sr, char * buf){
+    TAU_FSTART(cmp_pairs);
+    ConstPairIterator pi(sr, pairs);
+    int el_size = sr->el_size;
+    for (int64_t i=0; i<n; i++){
+      pi[i].read_val(buf+i*el_size);
+    }
+    uint8_t * kbuf = (uint8_t*)(buf+n*el_size);
+    int64_t pos = 0;
+    int64_t prv = 0;
+    for (int64_t i=0; i<n; i++){
+      int64_t k = pi[i].k();
+      uint64_t u = zigzag(k-prv);
+      prv = k;
+      while (u >= 128){
+        kbuf[pos++] = (uint8_t)(u | 128);
+        u >>= 7;
+      }
+      kbuf[pos++] = (uint8_t)u;
+    }
+    TAU_FSTOP(cmp_pairs);
+    return n*el_size+pos;
+  }
+
+  void decmp_pairs(int64_t n, char const * buf, algstrct const * sr, char * pairs){
+    TAU_FSTART(decmp_pairs);
+    PairIterator pi(sr, pairs);
+    int el_size = sr->el_size;
+    uint8_t const * kbuf = (uint8_t const*)(buf+n*el_size);
+    int64_t pos = 0;
+    int64_t prv = 0;
+    for (int64_t i=0; i<n; i++){
+      uint64_t u = 0;
+      int shift = 0;
+      uint8_t b;
+      do {
+        b = kbuf[pos++];
+        u |= ((uint64_t)(b & 127)) << shift;
+        shift += 7;
+      } while (b & 128);
+      prv += unzigzag(u);
+      pi[i].write_key(prv);
+      // values travel as raw bytes, as they would in the pairs themselves
+      memcpy(pi[i].d(), buf+i*el_size, el_size);
+    }
+    TAU_FSTOP(decmp_pairs);
+  }
+
+  bool cmp_pairs_pays(double t_saved, int64_t raw_sz, int64_t cmp_sz){
+#ifdef COMPRESS_PAIRS
+    if (cmp_sz >= raw_sz) return false;
+    // encoding and decoding each stream through both representations
+    return t_saved > 2.*COST_MEMBW*(raw_sz+cmp_sz);
+#else
+    return false;
+#endif
+  }
+
+  void sp_all_to_allv(CommData &        cdt,
+                      algstrct const *  sr,
+                      char *            send_pairs,
+                      int64_t const *   send_counts,
+                      int64_t const *   send_displs,
+                      char *            recv_pairs,
+                      int64_t const *   recv_counts,
+                      int64_t const *   recv_displs){
+#ifndef COMPRESS_PAIRS
+    cdt.all_to_allv(send_pairs, send_counts, send_displs, sr->pair_size(),
+                    recv_pairs, recv_counts, recv_displs);
+#else
+    TAU_FSTART(sp_all_to_allv);
+    int np = cdt.np;
+    int64_t psz = sr->pair_size();
+    int64_t * send_sz = (int64_t*)alloc(sizeof(int64_t)*np);
+    int64_t * recv_sz = (int64_t*)alloc(sizeof(int64_t)*np);
+    int64_t * send_bdispls = (int64_t*)alloc(sizeof(int64_t)*np);
+    int64_t * recv_bdispls = (int64_t*)alloc(sizeof(int64_t)*np);
+
+    int64_t raw_sz = 0;
+    int64_t cmp_sz = 0;
+    for (int p=0; p<np; p++){
+      // a bucket is sent as it is unless its wire format is strictly smaller, so receivers can tell the two apart
+      send_sz[p] = std::min(send_counts[p]*psz, get_cmp_pairs_size(send_counts[p], send_pairs+send_displs[p]*psz, sr));
+      raw_sz += send_counts[p]*psz;
+      cmp_sz += send_sz[p];
+    }
+    bool do_cmp = cmp_pairs_pays(cdt.estimate_alltoallv_time(raw_sz)-cdt.estimate_alltoallv_time(cmp_sz), raw_sz, cmp_sz);
+    char * send_buf = send_pairs;
+    if (do_cmp){
+      send_buf = (char*)alloc(cmp_sz);
+      int64_t off = 0;
+      for (int p=0; p<np; p++){
+        send_bdispls[p] = off;
+        char const * bucket = send_pairs+send_displs[p]*psz;
+        if (send_sz[p] < send_counts[p]*psz)
+          cmp_pairs(send_counts[p], bucket, sr, send_buf+off);
+        else
+          memcpy(send_buf+off, bucket, send_sz[p]);
+        off += send_sz[p];
+      }
+    } else {
+      for (int p=0; p<np; p++){
+        send_sz[p] = send_counts[p]*psz;
+        send_bdispls[p] = send_displs[p]*psz;
+      }
+    }
+    MPI_Alltoall(send_sz, 1, MPI_INT64_T, recv_sz, 1, MPI_INT64_T, cdt.cm);
+
+    bool any_cmp = false;
+    int64_t recv_tot = 0;
+    for (int p=0; p<np; p++){
+      if (recv_sz[p] < recv_counts[p]*psz) any_cmp = true;
+      recv_bdispls[p] = recv_tot;
+      recv_tot += recv_sz[p];
+    }
+    char * recv_buf = recv_pairs;
+    if (any_cmp){
+      recv_buf = (char*)alloc(recv_tot);
+    } else {
+      for (int p=0; p<np; p++){
+        recv_bdispls[p] = recv_displs[p]*psz;
+      }
+    }
+    cdt.all_to_allv(send_buf, send_sz, send_bdispls, 1,
+                    recv_buf, recv_sz, recv_bdispls);
+    if (any_cmp){
+      for (int p=0; p<np; p++){
+        char * bucket = recv_pairs+recv_displs[p]*psz;
+        if (recv_sz[p] < recv_counts[p]*psz)
+          decmp_pairs(recv_counts[p], recv_buf+recv_bdispls[p], sr, bucket);
+        else
+          memcpy(bucket, recv_buf+recv_bdispls[p], recv_sz[p]);
+      }
+      cdealloc(recv_buf);
+    }
+    if (do_cmp) cdealloc(send_buf);
+    cdealloc(recv_bdispls);
+    cdealloc(send_bdispls);
+    cdealloc(recv_sz);
+    cdealloc(send_sz);
+    TAU_FSTOP(sp_all_to_allv);
+#endif
+  }
+}
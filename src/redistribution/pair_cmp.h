@@ -0,0 +1,70 @@
+#ifndef __PAIR_CMP_H__
+#define __PAIR_CMP_H__
+
+#include "../interface/common.h"
+#include "../tensor/algstrct.h"
+
+namespace CTF_int {
+
+  /**
+   * \brief computes the size of the wire format of a key-value pair buffer, in which the values are stored contiguously
+   *        and each key is stored as the variable-byte encoded difference from the previous key (zigzag-mapped, so keys
+   *        need not be sorted), keys of sorted blocks typically take one or two bytes rather than eight
+   * \param[in] n number of pairs
+   * \param[in] pairs key-value pairs
+   * \param[in] sr algebraic structure of the values
+   * \return size in bytes
+   */
+  int64_t get_cmp_pairs_size(int64_t n, char const * pairs, algstrct const * sr);
+
+  /**
+   * \brief writes key-value pairs in the wire format
+   * \param[in] n number of pairs
+   * \param[in] pairs key-value pairs
+   * \param[in] sr algebraic structure of the values
+   * \param[out] buf buffer of size get_cmp_pairs_size(n, pairs, sr)
+   * \return number of bytes written
+   */
+  int64_t cmp_pairs(int64_t n, char const * pairs, algstrct const * sr, char * buf);
+
+  /**
+   * \brief restores key-value pairs from the wire format
+   * \param[in] n number of pairs
+   * \param[in] buf pairs in wire format
+   * \param[in] sr algebraic structure of the values
+   * \param[out] pairs buffer of n key-value pairs
+   */
+  void decmp_pairs(int64_t n, char const * buf, algstrct const * sr, char * pairs);
+
+  /**
+   * \brief decides whether sending pairs in the wire format pays off, i.e. whether the estimated communication time
+   *        saved exceeds the cost of encoding and decoding them
+   * \param[in] t_saved estimated communication time saved by sending cmp_sz rather than raw_sz bytes
+   * \param[in] raw_sz size of the pairs in bytes
+   * \param[in] cmp_sz size of the pairs in wire format
+   */
+  bool cmp_pairs_pays(double t_saved, int64_t raw_sz, int64_t cmp_sz);
+
+  /**
+   * \brief all-to-all-v exchange of key-value pairs, same interface as CommData::all_to_allv with counts in pairs,
+   *        each process sends its pairs in the wire format if cmp_pairs_pays for the whole exchange
+   * \param[in] cdt communicator
+   * \param[in] sr algebraic structure of the values
+   * \param[in] send_pairs pairs to send, bucketed by destination
+   * \param[in] send_counts number of pairs to send to each process
+   * \param[in] send_displs offset (in pairs) of the pairs sent to each process
+   * \param[out] recv_pairs buffer for received pairs
+   * \param[in] recv_counts number of pairs received from each process
+   * \param[in] recv_displs offset (in pairs) of the pairs received from each process
+   */
+  void sp_all_to_allv(CommData &        cdt,
+                      algstrct const *  sr,
+                      char *            send_pairs,
+                      int64_t const *   send_counts,
+                      int64_t const *   send_displs,
+                      char *            recv_pairs,
+                      int64_t const *   recv_counts,
+                      int64_t const *   recv_displs);
+}
+
+#endif
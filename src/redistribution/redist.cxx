@@ -570,6 +570,7 @@ namespace CTF_int {
                 glb_comm.rank, loc_idx, loc_idx, blk_sz, prc_idx, sr->el_size, tsr_data, reqs+num_new_virt+loc_idx);
         MPI_Isend(tsr_data+sr->el_size*loc_idx*blk_sz, blk_sz,
                   sr->mdtype(), prc_idx, loc_idx, glb_comm.cm, reqs+num_new_virt+loc_idx);
+        comm_bytes_add(blk_sz*sr->el_size);
         for (i=0; i<order; i++){
           idx[i]++;
           if (idx[i] >= old_dist.virt_phase[i])
@@ -2,6 +2,7 @@
 
 #include "sparse_rw.h"
 #include "pad.h"
+#include "pair_cmp.h"
 #include "../shared/util.h"
 
 
@@ -1094,8 +1095,8 @@ namespace CTF_int {
       buf_data  = PairIterator(sr, buf_datab);
       swap_data  = PairIterator(sr, swap_datab);
     } else {
-      glb_comm.all_to_allv(buf_data.ptr, bucket_counts, send_displs, sr->pair_size(),
-                           swap_data.ptr, recv_counts, recv_displs);
+      sp_all_to_allv(glb_comm, sr, buf_data.ptr, bucket_counts, send_displs,
+                     swap_data.ptr, recv_counts, recv_displs);
     }
     
 
@@ -1170,8 +1171,8 @@ namespace CTF_int {
       /* Inverse the transpose we did above to get the keys back to requestors */
       //ALL_TO_ALLV(swap_data, recv_counts, recv_displs, MPI_CHAR,
       //            buf_data, bucket_counts, send_displs, MPI_CHAR, glb_comm);
-      glb_comm.all_to_allv(swap_data.ptr, recv_counts, recv_displs, sr->pair_size(),
-                      buf_data.ptr, bucket_counts, send_displs);
+      sp_all_to_allv(glb_comm, sr, swap_data.ptr, recv_counts, recv_displs,
+                     buf_data.ptr, bucket_counts, send_displs);
 
       /* unpad the keys if necesary */
       if (!is_sparse){
@@ -76,6 +76,7 @@ namespace CTF_int {
 
     is_top = 1;
     tsr = A;
+    tsr->wait_redistribute();
     if (tsr->has_zero_edge_len){
       return SUCCESS;
     }
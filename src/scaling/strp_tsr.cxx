@@ -194,6 +194,7 @@ namespace CTF_int {
 
 
   void strp_ctr::run(char * A, char * B, char * C){
+    double st_run = MPI_Wtime();
     char * bA, * bB, * bC;
 
     if (strip_A) {
@@ -227,7 +228,8 @@ namespace CTF_int {
     if (strip_A) rec_strp_A->free_exp();
     if (strip_B) rec_strp_B->free_exp();
     if (strip_C) rec_strp_C->run(1);
-
+    run_time += MPI_Wtime()-st_run;
+    nrun++;
   }
 
     strp_scl::~strp_scl(){
@@ -137,6 +137,8 @@ namespace CTF_int {
        * \brief runs strip for contraction of tensors
        */
       void run(char * A, char * B, char * C);
+      ctr * get_rec_ctr() { return rec_ctr; };
+      char const * get_name() { return "strp_ctr"; };
 
       /**
        * \brief returns the number of bytes of buffer space we need recursively 
@@ -42,6 +42,44 @@ namespace CTF_BLAS {
   INST_GEMM(std::complex<double>,Z)
 #undef INST_GEMM
 
+  template <typename dtype>
+  void trsm(const char *,
+            const char *,
+            const char *,
+            const char *,
+            const int *,
+            const int *,
+            const dtype *,
+            const dtype *,
+            const int *,
+            dtype *,
+            const int *){
+    printf("CTF ERROR TRSM not available for this type.\n");
+    ASSERT(0);
+    assert(0);
+  }
+#define INST_TRSM(dtype,s)                     \
+  template <>                                  \
+  void trsm<dtype>(const char * a,             \
+            const char * b,                    \
+            const char * c,                    \
+            const char * d,                    \
+            const int * e,                     \
+            const int * f,                     \
+            const dtype * g,                   \
+            const dtype * h,                   \
+            const int * i,                     \
+            dtype * j,                         \
+            const int * k){                    \
+    s ## TRSM(a,b,c,d,e,f,g,h,i,j,k);          \
+  }
+  INST_TRSM(float,S)
+  INST_TRSM(double,D)
+  INST_TRSM(std::complex<float>,C)
+  INST_TRSM(std::complex<double>,Z)
+#undef INST_TRSM
+
+
 
 #ifdef USE_BATCH_GEMM
   template <typename dtype>
@@ -23,6 +23,10 @@
 #define SCOPY scopy_
 #define DCOPY dcopy_
 #define ZCOPY zcopy_
+#define STRSM strsm_
+#define DTRSM dtrsm_
+#define CTRSM ctrsm_
+#define ZTRSM ztrsm_
 #else
 #define DDOT ddot
 #define SGEMM sgemm
@@ -44,6 +48,10 @@
 #define SCOPY scopy
 #define DCOPY dcopy
 #define ZCOPY zcopy
+#define STRSM strsm
+#define DTRSM dtrsm
+#define CTRSM ctrsm
+#define ZTRSM ztrsm
 #endif
 
 
@@ -222,6 +230,39 @@ namespace CTF_BLAS {
              const int *            incX);
 
 
+#define DECL_TRSM(dtype,s)                   \
+  extern "C"                                 \
+  void s ## TRSM(const char *,               \
+                 const char *,               \
+                 const char *,               \
+                 const char *,               \
+                 const int *,                \
+                 const int *,                \
+                 const dtype *,              \
+                 const dtype *,              \
+                 const int *,                \
+                 dtype *,                    \
+                 const int *);
+  DECL_TRSM(float,S)
+  DECL_TRSM(double,D)
+  DECL_TRSM(std::complex<float>,C)
+  DECL_TRSM(std::complex<double>,Z)
+#undef DECL_TRSM
+
+  template <typename dtype>
+  void trsm(const char *,
+            const char *,
+            const char *,
+            const char *,
+            const int *,
+            const int *,
+            const dtype *,
+            const dtype *,
+            const int *,
+            dtype *,
+            const int *);
+
+
 #ifdef USE_BATCH_GEMM
   extern "C"
   void SGEMM_BATCH(
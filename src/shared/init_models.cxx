@@ -15,6 +15,7 @@ double seq_tsr_spctr_k1_init[] = {5.3745E-06, 3.6464E-08, 2.2334E-10};
 double seq_tsr_spctr_k2_init[] = {3.0917E-08, 5.2181E-11, 4.1634E-12};
 double seq_tsr_spctr_k3_init[] = {7.2456E-08, 1.5128E-10, -1.5528E-12};
 double seq_tsr_spctr_k4_init[] = {1.6880E-07, 4.9411E-10, 9.2847E-13};
+double seq_tsr_spctr_k5_init[] = {3.0917E-08, 5.2181E-11, 4.1634E-12};
 double pin_keys_mdl_init[] = {3.1189E-09, 6.6717E-08};
 double seq_tsr_ctr_mdl_cst_init[] = {5.1626E-06, -6.3215E-11, 3.9638E-09};
 double seq_tsr_ctr_mdl_ref_init[] = {4.9138E-08, 5.8290E-10, 4.8575E-11};
@@ -34,6 +35,11 @@ double red_mdl_cst_init[] = {5.7302E-07, 4.7347E-06, 6.0191E-10};
 double allred_mdl_init[] = {8.4416E-07, 6.8651E-06, 3.5845E-08};
 double allred_mdl_cst_init[] = {-3.3754E-04, 2.1343E-04, 3.0801E-09};
 double bcast_mdl_init[] = {1.5045E-06, 1.4485E-05, 3.2876E-09};
+double alltoall_node_mdl_init[] = {3.0000E-07, 3.0000E-07, 1.2500E-10};
+double alltoallv_node_mdl_init[] = {8.2311E-07, 6.7248E-06, 2.6173E-09};
+double red_node_mdl_init[] = {1.8881E-07, 1.3883E-06, 2.3061E-10};
+double allred_node_mdl_init[] = {2.5325E-07, 2.0595E-06, 8.9613E-09};
+double bcast_node_mdl_init[] = {4.5135E-07, 4.3455E-06, 8.2190E-10};
 double spredist_mdl_init[] = {1.2744E-04, 1.0278E-03, 7.6837E-08};
 double csrred_mdl_init[] = {3.7005E-05, 1.1854E-04, 5.5165E-09};
 double csrred_mdl_cst_init[] = {-1.8323E-04, 1.3076E-04, 2.8732E-09};
@@ -13,6 +13,11 @@ namespace CTF_int{
   extern double allred_mdl_init[];
   extern double allred_mdl_cst_init[];
   extern double bcast_mdl_init[];
+  extern double alltoall_node_mdl_init[];
+  extern double alltoallv_node_mdl_init[];
+  extern double red_node_mdl_init[];
+  extern double allred_node_mdl_init[];
+  extern double bcast_node_mdl_init[];
   extern double dgtog_res_mdl_init[];
   extern double spredist_mdl_init[];
   extern double blres_mdl_init[];
@@ -41,6 +46,7 @@ namespace CTF_int{
   extern double seq_tsr_spctr_k2_init[];
   extern double seq_tsr_spctr_k3_init[];
   extern double seq_tsr_spctr_k4_init[];
+  extern double seq_tsr_spctr_k5_init[];
 }
 
 #endif
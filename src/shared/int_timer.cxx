@@ -7,6 +7,8 @@
 //#include <assert.h>
 //#include <iostream>
 //#include <vector>
+#include <unordered_map>
+#include <string>
 #include "util.h"
 #include "int_timer.h"
 #include "model.h"
@@ -104,9 +106,58 @@ namespace CTF{
 
   static std::vector<Function_timer> * function_timers = NULL;
 
-  Timer::Timer(const char * name){
+  // interned timer names, which are never released, and the position of each id in function_timers (-1 if absent)
+  static std::unordered_map<std::string,int> * timer_ids = NULL;
+  static std::vector<std::string> timer_names;
+  static std::vector<int> timer_index;
+
+  /**
+   * \brief recomputes the position of every timer id in function_timers after it is reordered, cleared or replaced
+   */
+  static void reindex_timers(){
+    std::fill(timer_index.begin(), timer_index.end(), -1);
+    if (function_timers == NULL) return;
+    for (int i=0; i<(int)function_timers->size(); i++){
+      int id = Timer::get_id((*function_timers)[i].name);
+      if (id >= (int)timer_index.size()) timer_index.resize(id+1, -1);
+      timer_index[id] = i;
+    }
+  }
+
+  /**
+   * \brief completed timer interval of the trace enabled by the environment variable CTF_TRACE
+   */
+  struct trace_event {
+    int id;
+    int depth;
+    double start_time;
+    double end_time;
+    int64_t flops;
+    int64_t bytes;
+  };
+
+  static char const * trace_file = NULL;
+  static bool trace_checked = false;
+  static double trace_origin;
+  static int trace_depth = 0;
+  static std::vector<trace_event> trace;
+  // flop and byte counts at the last start of each timer id
+  static std::vector< std::pair<int64_t,int64_t> > trace_start;
+
+  int Timer::get_id(char const * name){
+    if (timer_ids == NULL) timer_ids = new std::unordered_map<std::string,int>();
+    std::unordered_map<std::string,int>::const_iterator it = timer_ids->find(name);
+    if (it != timer_ids->end()) return it->second;
+    int id = timer_names.size();
+    timer_ids->insert(std::make_pair(std::string(name), id));
+    timer_names.push_back(name);
+    return id;
+  }
+
+  Timer::Timer(const char * name) : Timer(name, -1) { }
+
+  Timer::Timer(const char * name, int id_){
   #ifdef PROFILE
-    int i;
     if (function_timers == NULL) {
       if (name[0] == 'M' && name[1] == 'P' && 
           name[2] == 'I' && name[3] == '_'){
@@ -114,25 +165,24 @@ namespace CTF{
         original = 0;
         return;
       }
-      original = 1;
-      index = 0;
+      if (!trace_checked){
+        trace_checked = true;
+        trace_file = getenv("CTF_TRACE");
+        trace_origin = MPI_Wtime();
+      }
       excl_time = 0.0;
       function_timers = new std::vector<Function_timer>();
-      function_timers->push_back(Function_timer(name, MPI_Wtime(), 0.0)); 
-    } else {
-      for (i=0; i<(int)function_timers->size(); i++){
-        if (strcmp((*function_timers)[i].name, name) == 0){
-          /*(*function_timers)[i].start_time = MPI_Wtime();
-          (*function_timers)[i].start_excl_time = excl_time;*/
-          break;
-        }
-      }
-      index = i;
-      original = (index==0);
+      reindex_timers();
     }
-    if (index == (int)function_timers->size()) {
+    id = id_ < 0 ? get_id(name) : id_;
+    if (id >= (int)timer_index.size()) timer_index.resize(id+1, -1);
+    index = timer_index[id];
+    if (index == -1){
+      index = function_timers->size();
+      timer_index[id] = index;
       function_timers->push_back(Function_timer(name, MPI_Wtime(), excl_time)); 
     }
+    original = (index==0);
     timer_name = name;
     exited = 0;
   #endif
@@ -144,6 +194,11 @@ namespace CTF{
       exited = 0;
       (*function_timers)[index].start_time = MPI_Wtime();
       (*function_timers)[index].start_excl_time = excl_time;
+      if (trace_file != NULL){
+        if (id >= (int)trace_start.size()) trace_start.resize(id+1);
+        trace_start[id] = std::make_pair(CTF_int::get_flops(), CTF_int::get_comm_bytes());
+        trace_depth++;
+      }
     }
   #endif
   }
@@ -154,12 +209,24 @@ namespace CTF{
       int is_fin;
       MPI_Finalized(&is_fin);
       if (!is_fin){
-        double delta_time = MPI_Wtime() - (*function_timers)[index].start_time;
+        double end_time = MPI_Wtime();
+        double delta_time = end_time - (*function_timers)[index].start_time;
         (*function_timers)[index].acc_time += delta_time;
         (*function_timers)[index].acc_excl_time += delta_time - 
               (excl_time- (*function_timers)[index].start_excl_time); 
         excl_time = (*function_timers)[index].start_excl_time + delta_time;
         (*function_timers)[index].calls++;
+        if (trace_file != NULL && id < (int)trace_start.size()){
+          trace_depth--;
+          trace_event ev;
+          ev.id = id;
+          ev.depth = trace_depth;
+          ev.start_time = (*function_timers)[index].start_time - trace_origin;
+          ev.end_time = end_time - trace_origin;
+          ev.flops = CTF_int::get_flops() - trace_start[id].first;
+          ev.bytes = CTF_int::get_comm_bytes() - trace_start[id].second;
+          trace.push_back(ev);
+        }
       }
       exit();
       exited = 1;
@@ -275,6 +342,7 @@ namespace CTF{
       (*function_timers)[i].compute_totals(comm);
     }
     std::sort(function_timers->begin(), function_timers->end());
+    reindex_timers();
     complete_time = (*function_timers)[0].total_time;
     if (rank == 0){
       for (i=0; i<(int)function_timers->size(); i++){
@@ -291,6 +359,71 @@ namespace CTF{
 
   }
 
+  /**
+   * \brief writes the trace events of all processes to the file named by CTF_TRACE in the Chrome trace event format,
+   *        which can be viewed in Perfetto or chrome://tracing, with one process row per rank
+   */
+  static void write_trace(){
+    int rank, np;
+    int is_fin = 0;
+    MPI_Finalized(&is_fin);
+    if (is_fin || trace_file == NULL) return;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &np);
+
+    std::string evs;
+    char buf[MAX_NAME_LENGTH+300];
+    sprintf(buf, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"rank %d\"}},\n", rank, rank);
+    evs += buf;
+    for (int i=0; i<(int)trace.size(); i++){
+      trace_event const & ev = trace[i];
+      // timer names are C identifiers or user strings, quotes and backslashes would break the JSON
+      std::string nm = timer_names[ev.id];
+      std::replace(nm.begin(), nm.end(), '"', '\'');
+      std::replace(nm.begin(), nm.end(), '\\', '/');
+      snprintf(buf, sizeof(buf), "{\"name\":\"%.*s\",\"cat\":\"ctf\",\"ph\":\"X\",\"pid\":%d,\"tid\":0,\"ts\":%.3f,\"dur\":%.3f,"
+                                 "\"args\":{\"depth\":%d,\"flops\":%ld,\"bytes\":%ld}},\n",
+               MAX_NAME_LENGTH, nm.c_str(), rank, 1.e6*ev.start_time, 1.e6*(ev.end_time-ev.start_time),
+               ev.depth, (long)ev.flops, (long)ev.bytes);
+      evs += buf;
+    }
+    trace.clear();
+
+    int len = evs.size();
+    int * lens = NULL, * displs = NULL;
+    char * all_evs = NULL;
+    if (rank == 0){
+      lens = (int*)CTF_int::alloc(sizeof(int)*np);
+      displs = (int*)CTF_int::alloc(sizeof(int)*np);
+    }
+    PMPI_Gather(&len, 1, MPI_INT, lens, 1, MPI_INT, 0, comm);
+    int64_t tot = 0;
+    if (rank == 0){
+      for (int p=0; p<np; p++){
+        displs[p] = tot;
+        tot += lens[p];
+      }
+      all_evs = (char*)CTF_int::alloc(tot+1);
+    }
+    PMPI_Gatherv(evs.c_str(), len, MPI_CHAR, all_evs, lens, displs, MPI_CHAR, 0, comm);
+    if (rank == 0){
+      FILE * fp = fopen(trace_file, "w");
+      if (fp == NULL){
+        printf("CTF ERROR: could not open trace file %s\n", trace_file);
+      } else {
+        // the last event is followed by ",\n", which is dropped to keep the JSON valid
+        fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+        fwrite(all_evs, 1, std::max((int64_t)0, tot-2), fp);
+        fprintf(fp, "\n]}\n");
+        fclose(fp);
+        printf("CTF trace of %d processes written to %s\n", np, trace_file);
+      }
+      CTF_int::cdealloc(all_evs);
+      CTF_int::cdealloc(displs);
+      CTF_int::cdealloc(lens);
+    }
+  }
+
   void Timer::exit(){
   #ifdef PROFILE
     if (set_contxt && original && !exited) {
@@ -299,9 +432,11 @@ namespace CTF{
         return;
       }
       print_timers("all");  
+      write_trace();
       function_timers->clear();
       delete function_timers;
       function_timers = NULL;
+      reindex_timers();
     }
   #endif
   }
@@ -331,6 +466,7 @@ namespace CTF{
     save_excl_time = excl_time;
     excl_time = 0.0;
     function_timers->clear();
+    reindex_timers();
     tmr_inner = new Timer(name);
     tmr_inner->start();
   #endif
@@ -345,6 +481,7 @@ namespace CTF{
     }
     function_timers = new std::vector<Function_timer>();
     *function_timers = saved_function_timers;
+    reindex_timers();
     excl_time = save_excl_time;
     tmr_outer->stop();
     //delete tmr_inner;
@@ -20,10 +20,12 @@ namespace CTF {
 
 #ifdef TAU
 #define TAU_FSTART(ARG)                                           \
-  do { CTF::Timer t(#ARG); t.start(); } while (0);
+  do { static int const ctf_tid = CTF::Timer::get_id(#ARG);       \
+       CTF::Timer t(#ARG, ctf_tid); t.start(); } while (0);
 
 #define TAU_FSTOP(ARG)                                            \
-  do { CTF::Timer t(#ARG); t.stop(); } while (0);
+  do { static int const ctf_tid = CTF::Timer::get_id(#ARG);       \
+       CTF::Timer t(#ARG, ctf_tid); t.stop(); } while (0);
 
 #define TAU_PROFILE_TIMER(ARG1, ARG2, ARG3, ARG4)                 
 
@@ -8,6 +8,21 @@
 #define DGELSD dgelsd_
 #define DGEQRF dgeqrf_
 #define DORMQR dormqr_
+#define SGEQRF sgeqrf_
+#define CGEQRF cgeqrf_
+#define ZGEQRF zgeqrf_
+#define SORGQR sorgqr_
+#define DORGQR dorgqr_
+#define CUNGQR cungqr_
+#define ZUNGQR zungqr_
+#define SPOTRF spotrf_
+#define DPOTRF dpotrf_
+#define CPOTRF cpotrf_
+#define ZPOTRF zpotrf_
+#define SGESVD sgesvd_
+#define DGESVD dgesvd_
+#define CGESVD cgesvd_
+#define ZGESVD zgesvd_
 #define PDGESVD pdgesvd_
 #define PSGESVD psgesvd_
 #define PCGESVD pcgesvd_
@@ -27,6 +42,21 @@
 #define DGELSD dgelsd
 #define DGEQRF dgeqrf
 #define DORMQR dormqr
+#define SGEQRF sgeqrf
+#define CGEQRF cgeqrf
+#define ZGEQRF zgeqrf
+#define SORGQR sorgqr
+#define DORGQR dorgqr
+#define CUNGQR cungqr
+#define ZUNGQR zungqr
+#define SPOTRF spotrf
+#define DPOTRF dpotrf
+#define CPOTRF cpotrf
+#define ZPOTRF zpotrf
+#define SGESVD sgesvd
+#define DGESVD dgesvd
+#define CGESVD cgesvd
+#define ZGESVD zgesvd
 #define PDGESVD pdgesvd
 #define PSGESVD psgesvd
 #define PCGESVD pcgesvd
@@ -56,6 +86,166 @@ namespace CTF_LAPACK{
 
   extern "C"
   void DORMQR(char const * SIDE, char const * TRANS, int const *  M, int const *  N, int const *  K, double const * A, int const *  LDA, double const * TAU2, double * C, int const *  LDC, double * WORK, int const *  LWORK, int  * INFO);
+
+  extern "C"
+  void SGEQRF(int const *  M, int const *  N, float * A, int const *  LDA, float * TAU2, float * WORK, int const *  LWORK, int  * INFO);
+
+  extern "C"
+  void CGEQRF(int const *  M, int const *  N, std::complex<float> * A, int const *  LDA, std::complex<float> * TAU2, std::complex<float> * WORK, int const *  LWORK, int  * INFO);
+
+  extern "C"
+  void ZGEQRF(int const *  M, int const *  N, std::complex<double> * A, int const *  LDA, std::complex<double> * TAU2, std::complex<double> * WORK, int const *  LWORK, int  * INFO);
+
+  extern "C"
+  void SORGQR(int const *  M, int const *  N, int const *  K, float * A, int const *  LDA, float const * TAU2, float * WORK, int const *  LWORK, int  * INFO);
+
+  extern "C"
+  void DORGQR(int const *  M, int const *  N, int const *  K, double * A, int const *  LDA, double const * TAU2, double * WORK, int const *  LWORK, int  * INFO);
+
+  extern "C"
+  void CUNGQR(int const *  M, int const *  N, int const *  K, std::complex<float> * A, int const *  LDA, std::complex<float> const * TAU2, std::complex<float> * WORK, int const *  LWORK, int  * INFO);
+
+  extern "C"
+  void ZUNGQR(int const *  M, int const *  N, int const *  K, std::complex<double> * A, int const *  LDA, std::complex<double> const * TAU2, std::complex<double> * WORK, int const *  LWORK, int  * INFO);
+
+  extern "C"
+  void SPOTRF(char const * UPLO, int const *  N, float * A, int const *  LDA, int  * INFO);
+
+  extern "C"
+  void DPOTRF(char const * UPLO, int const *  N, double * A, int const *  LDA, int  * INFO);
+
+  extern "C"
+  void CPOTRF(char const * UPLO, int const *  N, std::complex<float> * A, int const *  LDA, int  * INFO);
+
+  extern "C"
+  void ZPOTRF(char const * UPLO, int const *  N, std::complex<double> * A, int const *  LDA, int  * INFO);
+
+  extern "C"
+  void SGESVD(char const * JOBU, char const * JOBVT, int const * M, int const * N, float * A, int const * LDA, float * S, float * U, int const * LDU, float * VT, int const * LDVT, float * WORK, int const * LWORK, int * INFO);
+
+  extern "C"
+  void DGESVD(char const * JOBU, char const * JOBVT, int const * M, int const * N, double * A, int const * LDA, double * S, double * U, int const * LDU, double * VT, int const * LDVT, double * WORK, int const * LWORK, int * INFO);
+
+  extern "C"
+  void CGESVD(char const * JOBU, char const * JOBVT, int const * M, int const * N, std::complex<float> * A, int const * LDA, float * S, std::complex<float> * U, int const * LDU, std::complex<float> * VT, int const * LDVT, std::complex<float> * WORK, int const * LWORK, float * RWORK, int * INFO);
+
+  extern "C"
+  void ZGESVD(char const * JOBU, char const * JOBVT, int const * M, int const * N, std::complex<double> * A, int const * LDA, double * S, std::complex<double> * U, int const * LDU, std::complex<double> * VT, int const * LDVT, std::complex<double> * WORK, int const * LWORK, double * RWORK, int * INFO);
+#endif
+
+  template <typename dtype>
+  inline void geqrf(int     M,
+                    int     N,
+                    dtype * A,
+                    int     LDA,
+                    dtype * TAU2,
+                    dtype * WORK,
+                    int     LWORK,
+                    int *   INFO){
+    assert(0); // GEQRF not available for this type or without LAPACK
+  }
+
+  template <typename dtype>
+  inline void orgqr(int           M,
+                    int           N,
+                    int           K,
+                    dtype *       A,
+                    int           LDA,
+                    dtype const * TAU2,
+                    dtype *       WORK,
+                    int           LWORK,
+                    int *         INFO){
+    assert(0); // ORGQR not available for this type or without LAPACK
+  }
+
+  template <typename dtype>
+  inline void potrf(char    UPLO,
+                    int     N,
+                    dtype * A,
+                    int     LDA,
+                    int *   INFO){
+    assert(0); // POTRF not available for this type or without LAPACK
+  }
+
+  template <typename dtype>
+  inline void gesvd(char    JOBU,
+                    char    JOBVT,
+                    int     M,
+                    int     N,
+                    dtype * A,
+                    int     LDA,
+                    dtype * S,
+                    dtype * U,
+                    int     LDU,
+                    dtype * VT,
+                    int     LDVT,
+                    dtype * WORK,
+                    int     LWORK,
+                    int *   INFO){
+    assert(0); // GESVD not available for this type or without LAPACK
+  }
+
+#ifdef USE_LAPACK
+  template <>
+  inline void gesvd<float>(char JOBU, char JOBVT, int M, int N, float * A, int LDA, float * S,
+                           float * U, int LDU, float * VT, int LDVT, float * WORK, int LWORK, int * INFO){
+    SGESVD(&JOBU,&JOBVT,&M,&N,A,&LDA,S,U,&LDU,VT,&LDVT,WORK,&LWORK,INFO);
+  }
+
+  template <>
+  inline void gesvd<double>(char JOBU, char JOBVT, int M, int N, double * A, int LDA, double * S,
+                            double * U, int LDU, double * VT, int LDVT, double * WORK, int LWORK, int * INFO){
+    DGESVD(&JOBU,&JOBVT,&M,&N,A,&LDA,S,U,&LDU,VT,&LDVT,WORK,&LWORK,INFO);
+  }
+
+  template <>
+  inline void gesvd< std::complex<float> >(char JOBU, char JOBVT, int M, int N, std::complex<float> * A, int LDA, std::complex<float> * cS,
+                                           std::complex<float> * U, int LDU, std::complex<float> * VT, int LDVT, std::complex<float> * WORK, int LWORK, int * INFO){
+    float * S = (float*)cS;
+    float * rwork = new float[5*std::min(M,N)+1];
+    CGESVD(&JOBU,&JOBVT,&M,&N,A,&LDA,S,U,&LDU,VT,&LDVT,WORK,&LWORK,rwork,INFO);
+    delete [] rwork;
+    if (LWORK != -1){
+      for (int i=std::min(M,N)-1; i>=0; i--){
+        cS[i] = std::complex<float>(S[i], 0.0);
+      }
+    }
+  }
+
+  template <>
+  inline void gesvd< std::complex<double> >(char JOBU, char JOBVT, int M, int N, std::complex<double> * A, int LDA, std::complex<double> * cS,
+                                            std::complex<double> * U, int LDU, std::complex<double> * VT, int LDVT, std::complex<double> * WORK, int LWORK, int * INFO){
+    double * S = (double*)cS;
+    double * rwork = new double[5*std::min(M,N)+1];
+    ZGESVD(&JOBU,&JOBVT,&M,&N,A,&LDA,S,U,&LDU,VT,&LDVT,WORK,&LWORK,rwork,INFO);
+    delete [] rwork;
+    if (LWORK != -1){
+      for (int i=std::min(M,N)-1; i>=0; i--){
+        cS[i] = std::complex<double>(S[i], 0.0);
+      }
+    }
+  }
+
+#define INST_LAPACK_QR(dtype,s,orgqr_s)                                                      \
+  template <>                                                                                \
+  inline void geqrf<dtype>(int M, int N, dtype * A, int LDA, dtype * TAU2,                   \
+                           dtype * WORK, int LWORK, int * INFO){                             \
+    s ## GEQRF(&M,&N,A,&LDA,TAU2,WORK,&LWORK,INFO);                                          \
+  }                                                                                          \
+  template <>                                                                                \
+  inline void orgqr<dtype>(int M, int N, int K, dtype * A, int LDA, dtype const * TAU2,      \
+                           dtype * WORK, int LWORK, int * INFO){                             \
+    orgqr_s(&M,&N,&K,A,&LDA,TAU2,WORK,&LWORK,INFO);                                          \
+  }                                                                                          \
+  template <>                                                                                \
+  inline void potrf<dtype>(char UPLO, int N, dtype * A, int LDA, int * INFO){                \
+    s ## POTRF(&UPLO,&N,A,&LDA,INFO);                                                        \
+  }
+  INST_LAPACK_QR(float,S,SORGQR)
+  INST_LAPACK_QR(double,D,DORGQR)
+  INST_LAPACK_QR(std::complex<float>,C,CUNGQR)
+  INST_LAPACK_QR(std::complex<double>,Z,ZUNGQR)
+#undef INST_LAPACK_QR
 #endif
 }
 #ifdef USE_SCALAPACK
@@ -75,9 +75,11 @@ void read_off_memory_status(statm_t& result)
   int instance_counter = 0;
   int64_t mem_used[MAX_THREADS];
   int64_t tot_mem_used;
+  int64_t peak_mem_used = 0;
   void inc_tot_mem_used(int64_t a){
     tot_mem_used += a;
     ASSERT(tot_mem_used >= 0);
+    if (tot_mem_used > peak_mem_used) peak_mem_used = tot_mem_used;
     //int rank;
   //  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 //    if (rank == 0)
@@ -595,6 +597,14 @@ void read_off_memory_status(statm_t& result)
     return tot_mem_used;
   }
 
+  int64_t proc_bytes_peak(){
+    return peak_mem_used;
+  }
+
+  void set_proc_bytes_peak(int64_t peak){
+    peak_mem_used = peak;
+  }
+
   /* FIXME: only correct for 1 process per node */
   /**
    * \brief gives total memory size per MPI process 
@@ -6,6 +6,14 @@
 namespace CTF_int {
   void inc_tot_mem_used(int64_t a);
   int64_t proc_bytes_used();
+  /**
+   * \brief gives the peak of proc_bytes_used() since the last call to set_proc_bytes_peak()
+   */
+  int64_t proc_bytes_peak();
+  /**
+   * \brief sets the peak memory usage, from which proc_bytes_peak() continues to track the maximum
+   */
+  void set_proc_bytes_peak(int64_t peak);
   int64_t proc_bytes_total();
   int64_t proc_bytes_available();
   void set_memcap(double cap);
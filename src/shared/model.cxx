@@ -32,19 +32,15 @@ namespace CTF_int {
   }
 
   void load_all_models(std::string file_name){
-#ifdef TUNE
     for (int i=0; i<(int)get_all_models().size(); i++){
       get_all_models()[i]->load_coeff(file_name);
     }
-#endif
   }
 
   void write_all_models(std::string file_name){
-#ifdef TUNE
     for (int i=0; i<(int)get_all_models().size(); i++){
       get_all_models()[i]->write_coeff(file_name);
     }
-#endif
   }
 
   void dump_all_models(std::string path){
@@ -55,6 +51,61 @@ namespace CTF_int {
 #endif
   }
 
+  // runtime learning state, observations are recorded only if learn_sample > 0
+  static int learn_sample = 0;
+  static int64_t learn_ncalls = 0;
+  static MPI_Request learn_req = MPI_REQUEST_NULL;
+  static double * learn_buf = NULL;
+
+// number of calls to learn_all_models between refits
+#define LEARN_INTERVAL 64
+// maximum number of observations kept by each model when learning at runtime
+#define LEARN_HIST_SIZE 1024
+
+  void start_model_learning(int sample){
+    learn_sample = std::max(sample, 1);
+  }
+
+  void learn_all_models(MPI_Comm cm){
+    if (learn_sample == 0) return;
+    learn_ncalls++;
+    if (learn_ncalls % LEARN_INTERVAL != 0) return;
+    std::vector<Model*> & mdls = get_all_models();
+    // the sums posted at the previous refit are applied now, so that all processes change models at the same call
+    if (learn_req != MPI_REQUEST_NULL){
+      MPI_Wait(&learn_req, MPI_STATUS_IGNORE);
+      int64_t off = 0;
+      for (int i=0; i<(int)mdls.size(); i++){
+        mdls[i]->refit(learn_buf+off);
+        off += mdls[i]->nstat();
+      }
+      cdealloc(learn_buf);
+      learn_buf = NULL;
+    }
+    int64_t tot = 0;
+    for (int i=0; i<(int)mdls.size(); i++){
+      tot += mdls[i]->nstat();
+    }
+    learn_buf = (double*)alloc(sizeof(double)*tot);
+    int64_t off = 0;
+    for (int i=0; i<(int)mdls.size(); i++){
+      mdls[i]->pack_stats(learn_buf+off);
+      off += mdls[i]->nstat();
+    }
+    MPI_Iallreduce(MPI_IN_PLACE, learn_buf, tot, MPI_DOUBLE, MPI_SUM, cm, &learn_req);
+  }
+
+  void finish_model_learning(std::string file_name){
+    if (learn_sample == 0) return;
+    if (learn_req != MPI_REQUEST_NULL){
+      MPI_Wait(&learn_req, MPI_STATUS_IGNORE);
+      cdealloc(learn_buf);
+      learn_buf = NULL;
+    }
+    if (file_name != "") write_all_models(file_name);
+    learn_sample = 0;
+  }
+
 #define SPLINE_CHUNK_SZ = 8
 
   double cddot(int n,       const double *dX,
@@ -124,17 +175,23 @@ namespace CTF_int {
     is_active = true;
     //copy initial static coefficients to initialzie model (defined in init_model.cxx)
     memcpy(coeff_guess, init_guess, nparam*sizeof(double));
-#ifdef TUNE
     /*for (int i=0; i<nparam; i++){
       regularization[i] = coeff_guess[i]*REG_LAMBDA;
     }*/
     name = (char*)alloc(strlen(name_)+1);
     name[0] = '\0';
     strcpy(name, name_);
-    hist_size = hist_size_;
     mat_lda = nparam+1;
+#ifdef TUNE
+    hist_size = hist_size_;
     time_param_mat = (double*)alloc(mat_lda*hist_size*sizeof(double));
+#else
+    // allocated on the first observation if models are learned at runtime
+    hist_size = std::min(hist_size_, LEARN_HIST_SIZE);
+    time_param_mat = NULL;
+#endif
     nobs = 0;
+    ncalls = 0;
     is_tuned = false;
     tot_time = 0.0;
     avg_tot_time = 0.0;
@@ -143,7 +200,6 @@ namespace CTF_int {
     over_time = 0.0;
     under_time = 0.0;
     get_all_models().push_back(this);
-#endif
   }
 
 
@@ -153,20 +209,24 @@ namespace CTF_int {
     is_active = true;
     name = NULL;
     time_param_mat = NULL;
+    nobs = 0;
+    ncalls = 0;
   }
 
   template <int nparam>
   LinModel<nparam>::~LinModel(){
-#ifdef TUNE
     if (name != NULL) cdealloc(name);
     if (time_param_mat != NULL) cdealloc(time_param_mat);
-#endif
   }
 
 
   template <int nparam>
   void LinModel<nparam>::observe(double const * tp){
-#ifdef TUNE
+#ifndef TUNE
+    if (learn_sample == 0 || name == NULL || (ncalls++) % learn_sample != 0) return;
+    if (time_param_mat == NULL)
+      time_param_mat = (double*)alloc(mat_lda*hist_size*sizeof(double));
+#endif
     /*for (int i=0; i<nobs; i++){
       bool is_same = true;
       for (int j=0; j<nparam; j++){
@@ -208,7 +268,6 @@ namespace CTF_int {
                      &comp_time_param<nparam>);
     }*/
     nobs++;
-#endif
   }
 
   template <int nparam>
@@ -525,6 +584,83 @@ namespace CTF_int {
 
   }
 
+  template <int nparam>
+  int LinModel<nparam>::nstat(){
+    return nparam*nparam+nparam+1;
+  }
+
+  template <int nparam>
+  void LinModel<nparam>::pack_stats(double * stats){
+    std::fill(stats, stats+nstat(), 0.0);
+    int64_t nrcol = std::min(nobs,(int64_t)hist_size);
+    for (int64_t o=0; o<nrcol; o++){
+      double const * tp = time_param_mat+o*mat_lda;
+      for (int i=0; i<nparam; i++){
+        for (int j=0; j<nparam; j++){
+          stats[i*nparam+j] += tp[1+i]*tp[1+j];
+        }
+        stats[nparam*nparam+i] += tp[1+i]*tp[0];
+      }
+    }
+    stats[nparam*nparam+nparam] = nrcol;
+  }
+
+  template <int nparam>
+  void LinModel<nparam>::refit(double const * stats){
+    if (!is_active || stats[nparam*nparam+nparam] < 16.*nparam) return;
+    // solve (D^{-1/2} G D^{-1/2} + mu I) y = D^{-1/2} r + mu D^{1/2} x_0 for x = D^{-1/2} y, where D is the diagonal of G,
+    // so that the solve is insensitive to the scale of the parameters and parameters never observed keep x_0
+    double const mu = 1.E-6;
+    double dg[nparam];
+    double M[nparam*nparam];
+    double y[nparam];
+    for (int i=0; i<nparam; i++){
+      dg[i] = stats[i*nparam+i] > 0.0 ? std::sqrt(stats[i*nparam+i]) : 0.0;
+    }
+    for (int i=0; i<nparam; i++){
+      for (int j=0; j<nparam; j++){
+        if (dg[i] == 0.0 || dg[j] == 0.0) M[i*nparam+j] = 0.0;
+        else M[i*nparam+j] = stats[i*nparam+j]/(dg[i]*dg[j]);
+      }
+      if (dg[i] == 0.0){
+        M[i*nparam+i] = 1.0;
+        y[i] = coeff_guess[i];
+      } else {
+        M[i*nparam+i] += mu;
+        y[i] = stats[nparam*nparam+i]/dg[i] + mu*dg[i]*coeff_guess[i];
+      }
+    }
+    // Cholesky factorization M = LL^T in place in the lower triangle
+    for (int j=0; j<nparam; j++){
+      for (int k=0; k<j; k++){
+        M[j*nparam+j] -= M[j*nparam+k]*M[j*nparam+k];
+      }
+      if (!(M[j*nparam+j] > 0.0)) return;
+      M[j*nparam+j] = std::sqrt(M[j*nparam+j]);
+      for (int i=j+1; i<nparam; i++){
+        for (int k=0; k<j; k++){
+          M[i*nparam+j] -= M[i*nparam+k]*M[j*nparam+k];
+        }
+        M[i*nparam+j] /= M[j*nparam+j];
+      }
+    }
+    for (int i=0; i<nparam; i++){
+      for (int k=0; k<i; k++) y[i] -= M[i*nparam+k]*y[k];
+      y[i] /= M[i*nparam+i];
+    }
+    for (int i=nparam-1; i>=0; i--){
+      for (int k=i+1; k<nparam; k++) y[i] -= M[k*nparam+i]*y[k];
+      y[i] /= M[i*nparam+i];
+    }
+    for (int i=0; i<nparam; i++){
+      if (std::isnan(y[i])) return;
+    }
+    for (int i=0; i<nparam; i++){
+      coeff_guess[i] = dg[i] == 0.0 ? y[i] : y[i]/dg[i];
+    }
+    is_tuned = true;
+  }
+
   template <int nparam>
   double LinModel<nparam>::est_time(double const * param){
     return std::max(0.0,cddot(nparam, param, 1, coeff_guess, 1));
@@ -17,6 +17,9 @@ namespace CTF_int {
       virtual void load_coeff(std::string file_name){};
       virtual void write_coeff(std::string file_name){};
       virtual void dump_data(std::string path){};
+      virtual int nstat(){ return 0; };
+      virtual void pack_stats(double * stats){};
+      virtual void refit(double const * stats){};
   };
 
   void update_all_models(MPI_Comm cm);
@@ -25,6 +28,26 @@ namespace CTF_int {
   void write_all_models(std::string file_name);
   void dump_all_models(std::string path);
 
+  /**
+   * \brief enables learning of the models from observations at runtime, outside of TUNE builds
+   * \param[in] sample only every sample-th observation of each model is recorded
+   */
+  void start_model_learning(int sample);
+
+  /**
+   * \brief refits all models every few calls from the observations of all processes in cm, must be called
+   *        collectively and in the same order by all processes of cm, the observation statistics are summed
+   *        with a non-blocking allreduce, whose result is applied to the models by the next refit
+   * \param[in] cm communicator
+   */
+  void learn_all_models(MPI_Comm cm);
+
+  /**
+   * \brief completes any pending refit and, if file_name is not empty, writes the learned coefficients to it
+   * \param[in] file_name file to write coefficients to
+   */
+  void finish_model_learning(std::string file_name);
+
   /**
    * \brief Linear performance models, which given measurements, provides new model guess
    */
@@ -52,6 +75,8 @@ namespace CTF_int {
       double avg_under_time;
       /** \brief is_active whether this model is active for training */
       bool is_active;
+      /** \brief number of calls to observe(), of which every learn_sample-th is recorded when learning at runtime */
+      int64_t ncalls;
 
     public:
       /** \brief the number of latest observations we want to  consider when updating the model */
@@ -135,6 +160,25 @@ namespace CTF_int {
        * \brief dump model data to a file
        */
       void dump_data(std::string path);
+
+      /**
+       * \brief size of the statistics of the observation history used by pack_stats and refit
+       */
+      int nstat();
+
+      /**
+       * \brief computes the normal equations of the least squares fit to the observation history
+       * \param[out] stats preallocated array of size nstat() storing the Gram matrix of the parameters,
+       *             their products with the times and the number of observations
+       */
+      void pack_stats(double * stats);
+
+      /**
+       * \brief refits the coefficients to statistics summed over processes, keeping them close to the
+       *        current coefficients in the directions that are poorly observed
+       * \param[in] stats array of size nstat() as computed by pack_stats() and summed
+       */
+      void refit(double const * stats);
   };
 
   /**
@@ -98,7 +98,15 @@ namespace CTF_int {
   #define FOLD_TSR 1
   #define USE_SYM_SUM
   #define HOME_CONTRACT
+  /* leave contraction/summation outputs in their last mapping until home is needed */
+  #define LAZY_HOME
   #define USE_BLOCK_RESHUFFLE
+  /* send keys of sparse pair buffers delta-encoded when the estimated bandwidth saved exceeds the cost of encoding */
+  #define COMPRESS_PAIRS
+  #if MPI_VERSION >= 3
+  /* exchange all-to-all-v data among ranks on the same node via MPI-3 shared memory windows */
+  #define USE_MPI_SHM
+  #endif
 
   #define MAX_ORD 12
   #define LOOP_MAX_ORD(F,...) \
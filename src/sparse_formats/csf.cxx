@@ -0,0 +1,294 @@
+#include "csf.h"
+#include "../contraction/ctr_comm.h"
+#include "../shared/util.h"
+
+#define ALIGN 256
+
+namespace CTF_int {
+  int64_t get_csf_size(int64_t nnz, int nlvl, int64_t const * nfib, int val_size){
+    int64_t offset = (5+3*nlvl)*sizeof(int64_t);
+    if (offset % ALIGN != 0) offset += ALIGN-(offset%ALIGN);
+    offset += nnz*val_size;
+    if (offset % ALIGN != 0) offset += ALIGN-(offset%ALIGN);
+    for (int l=0; l<nlvl; l++){
+      offset += nfib[l]*sizeof(int);
+      if (offset % ALIGN != 0) offset += ALIGN-(offset%ALIGN);
+      if (l<nlvl-1){
+        offset += (nfib[l]+1)*sizeof(int);
+        if (offset % ALIGN != 0) offset += ALIGN-(offset%ALIGN);
+      }
+    }
+    return offset;
+  }
+
+  bool prefer_csf(int order, int const * loc_lens, double nnz_blk, int val_size, int64_t nrow, bool csr){
+    if (nnz_blk <= 0.) return false;
+    // levels are ordered from the last mode to the first, as in the fiber tree
+    double csf_sz = nnz_blk*(val_size+sizeof(int));
+    double prefix = 1.;
+    int nlvl = 0;
+    for (int i=order-1; i>=0; i--){
+      if (loc_lens[i] == 1) continue;
+      nlvl++;
+      prefix *= loc_lens[i];
+      if (i > 0) csf_sz += prefix*(1.-exp(-nnz_blk/prefix))*2*sizeof(int);
+    }
+    if (nlvl < 3) return false;
+    double alt_sz;
+    if (csr)
+      alt_sz = nnz_blk*(val_size+sizeof(int)) + (nrow+1)*sizeof(int);
+    else
+      alt_sz = nnz_blk*(val_size+2*sizeof(int));
+    return csf_sz < alt_sz;
+  }
+
+  /**
+   * \brief decodes the local index of each level of the fiber tree from a key, levels with local length one are omitted
+   */
+  static void csf_decode(int64_t k, int order, int const * lens, int const * phase, int const * lvl_mode, int nlvl, int * idx){
+    int64_t kpart[order];
+    for (int j=0; j<order; j++){
+      kpart[j] = (k%lens[j])/phase[j];
+      k = k/lens[j];
+    }
+    for (int l=0; l<nlvl; l++){
+      idx[l] = kpart[lvl_mode[l]];
+    }
+  }
+
+  /**
+   * \brief determines the mode of each level of the fiber tree and the strides of its index in the matricization
+   * \return number of levels
+   */
+  static int csf_levels(int order, int const * lens, int const * rev_ordering, int nrow_idx, int const * phase, int * lvl_mode, int64_t * lvl_lda_row, int64_t * lvl_lda_col){
+    int ordering[order];
+    int rev_ord_lens[order];
+    int64_t lda[order];
+    for (int i=0; i<order; i++){
+      ordering[rev_ordering[i]]=i;
+    }
+    for (int i=0; i<order; i++){
+      rev_ord_lens[ordering[i]] = lens[i]/phase[i];
+      if (lens[i]%phase[i] > 0) rev_ord_lens[ordering[i]]++;
+    }
+    for (int i=0; i<order; i++){
+      if (i==0 || i==nrow_idx) lda[i] = 1;
+      else lda[i] = lda[i-1]*rev_ord_lens[i-1];
+    }
+    int nlvl = 0;
+    for (int j=order-1; j>=0; j--){
+      if (rev_ord_lens[ordering[j]] == 1 && !(j == 0 && nlvl == 0)) continue;
+      lvl_mode[nlvl] = j;
+      if (ordering[j] < nrow_idx){
+        lvl_lda_row[nlvl] = lda[ordering[j]];
+        lvl_lda_col[nlvl] = 0;
+      } else {
+        lvl_lda_row[nlvl] = 0;
+        lvl_lda_col[nlvl] = lda[ordering[j]];
+      }
+      nlvl++;
+    }
+    return nlvl;
+  }
+
+  /**
+   * \brief counts the nodes on each level of the fiber tree of a key-sorted pair buffer
+   */
+  static void csf_count(int64_t nz, int order, int const * lens, int const * phase, int const * lvl_mode, int nlvl, char const * tsr_data, algstrct const * sr, int64_t * nfib){
+    int idx[nlvl];
+    int prv[nlvl];
+    std::fill(nfib, nfib+nlvl, 0);
+    ConstPairIterator pi(sr, tsr_data);
+    for (int64_t i=0; i<nz; i++){
+      csf_decode(pi[i].k(), order, lens, phase, lvl_mode, nlvl, idx);
+      int l = 0;
+      if (i > 0){
+        ASSERT(pi[i].k() > pi[i-1].k());
+        while (l < nlvl-1 && idx[l] == prv[l]) l++;
+      }
+      for (; l<nlvl; l++) nfib[l]++;
+      memcpy(prv, idx, nlvl*sizeof(int));
+    }
+  }
+
+  int64_t CSF_Matrix::get_size(int64_t nz, int order, int const * lens, int const * ordering, int nrow_idx, char const * tsr_data, algstrct const * sr, int const * phase){
+    int lvl_mode[order];
+    int64_t lvl_lda_row[order];
+    int64_t lvl_lda_col[order];
+    int nlvl = csf_levels(order, lens, ordering, nrow_idx, phase, lvl_mode, lvl_lda_row, lvl_lda_col);
+    int64_t nfib[nlvl];
+    csf_count(nz, order, lens, phase, lvl_mode, nlvl, tsr_data, sr, nfib);
+    return get_csf_size(nz, nlvl, nfib, sr->el_size);
+  }
+
+  CSF_Matrix::CSF_Matrix(char * all_data_){
+    ASSERT(ALIGN >= 16);
+    all_data = all_data_;
+  }
+
+  CSF_Matrix::CSF_Matrix(int64_t nz, int order, int const * lens, int const * ordering, int nrow_idx, int nrow_, int ncol_, char const * tsr_data, algstrct const * sr, int const * phase, char * data){
+    ASSERT(ALIGN >= 16);
+    TAU_FSTART(convert_to_CSF);
+    int lvl_mode[order];
+    int64_t lvl_lda_row[order];
+    int64_t lvl_lda_col[order];
+    int nl = csf_levels(order, lens, ordering, nrow_idx, phase, lvl_mode, lvl_lda_row, lvl_lda_col);
+    int64_t cnt[nl];
+    csf_count(nz, order, lens, phase, lvl_mode, nl, tsr_data, sr, cnt);
+    if (data == NULL)
+      all_data = (char*)alloc(get_csf_size(nz, nl, cnt, sr->el_size));
+    else
+      all_data = data;
+    ((int64_t*)all_data)[0] = nz;
+    ((int64_t*)all_data)[1] = sr->el_size;
+    ((int64_t*)all_data)[2] = nrow_;
+    ((int64_t*)all_data)[3] = ncol_;
+    ((int64_t*)all_data)[4] = nl;
+    memcpy(this->nfib(), cnt, nl*sizeof(int64_t));
+    memcpy(this->lda_row(), lvl_lda_row, nl*sizeof(int64_t));
+    memcpy(this->lda_col(), lvl_lda_col, nl*sizeof(int64_t));
+
+    char * vs = vals();
+    int v_sz = sr->el_size;
+    int * lids[nl];
+    int * lptr[nl];
+    for (int l=0; l<nl; l++){
+      lids[l] = ids(l);
+      lptr[l] = l<nl-1 ? ptr(l) : NULL;
+    }
+    int64_t pos[nl];
+    std::fill(pos, pos+nl, 0);
+    int idx[nl];
+    int prv[nl];
+    ConstPairIterator pi(sr, tsr_data);
+    for (int64_t i=0; i<nz; i++){
+      csf_decode(pi[i].k(), order, lens, phase, lvl_mode, nl, idx);
+      int l = 0;
+      if (i > 0){
+        while (l < nl-1 && idx[l] == prv[l]) l++;
+      }
+      // a new node on level l and below, each new inner node starts where the next level currently ends
+      for (; l<nl; l++){
+        lids[l][pos[l]] = idx[l];
+        if (l<nl-1) lptr[l][pos[l]] = pos[l+1];
+        pos[l]++;
+      }
+      pi[i].read_val(vs+v_sz*i);
+      memcpy(prv, idx, nl*sizeof(int));
+    }
+    for (int l=0; l<nl-1; l++){
+      lptr[l][pos[l]] = pos[l+1];
+    }
+    TAU_FSTOP(convert_to_CSF);
+  }
+
+  int64_t CSF_Matrix::nnz() const {
+    return ((int64_t*)all_data)[0];
+  }
+
+  int CSF_Matrix::val_size() const {
+    return ((int64_t*)all_data)[1];
+  }
+
+  int64_t CSF_Matrix::size() const {
+    return get_csf_size(nnz(), nlvl(), nfib(), val_size());
+  }
+
+  int CSF_Matrix::nrow() const {
+    return ((int64_t*)all_data)[2];
+  }
+
+  int CSF_Matrix::ncol() const {
+    return ((int64_t*)all_data)[3];
+  }
+
+  int CSF_Matrix::nlvl() const {
+    return ((int64_t*)all_data)[4];
+  }
+
+  int64_t * CSF_Matrix::nfib() const {
+    return ((int64_t*)all_data)+5;
+  }
+
+  int64_t * CSF_Matrix::lda_row() const {
+    return ((int64_t*)all_data)+5+nlvl();
+  }
+
+  int64_t * CSF_Matrix::lda_col() const {
+    return ((int64_t*)all_data)+5+2*nlvl();
+  }
+
+  char * CSF_Matrix::vals() const {
+    int64_t offset = (5+3*nlvl())*sizeof(int64_t);
+    if (offset % ALIGN != 0) offset += ALIGN-(offset%ALIGN);
+    return all_data + offset;
+  }
+
+  int * CSF_Matrix::ids(int l) const {
+    int64_t const * nf = nfib();
+    int nl = nlvl();
+    int64_t offset = vals() - all_data;
+    offset += nnz()*val_size();
+    if (offset % ALIGN != 0) offset += ALIGN-(offset%ALIGN);
+    for (int i=0; i<l; i++){
+      offset += nf[i]*sizeof(int);
+      if (offset % ALIGN != 0) offset += ALIGN-(offset%ALIGN);
+      if (i<nl-1){
+        offset += (nf[i]+1)*sizeof(int);
+        if (offset % ALIGN != 0) offset += ALIGN-(offset%ALIGN);
+      }
+    }
+    return (int*)(all_data + offset);
+  }
+
+  int * CSF_Matrix::ptr(int l) const {
+    ASSERT(l < nlvl()-1);
+    int64_t offset = nfib()[l]*sizeof(int);
+    if (offset % ALIGN != 0) offset += ALIGN-(offset%ALIGN);
+    return (int*)(((char*)ids(l)) + offset);
+  }
+
+  void CSF_Matrix::get_coords(int * rs, int * cs) const {
+    int nl = nlvl();
+    int64_t const * lr = lda_row();
+    int64_t const * lc = lda_col();
+    int64_t const * nf = nfib();
+    if (nnz() == 0) return;
+    // offsets of the nodes on the current level, propagated from the root to the leaves
+    int64_t * row = (int64_t*)alloc(sizeof(int64_t)*nnz());
+    int64_t * col = (int64_t*)alloc(sizeof(int64_t)*nnz());
+    int64_t * nrow_ = (int64_t*)alloc(sizeof(int64_t)*nnz());
+    int64_t * ncol_ = (int64_t*)alloc(sizeof(int64_t)*nnz());
+    for (int64_t f=0; f<nf[0]; f++){
+      row[f] = ids(0)[f]*lr[0];
+      col[f] = ids(0)[f]*lc[0];
+    }
+    for (int l=0; l<nl-1; l++){
+      int const * p = ptr(l);
+      int const * ci = ids(l+1);
+      for (int64_t f=0; f<nf[l]; f++){
+        for (int64_t z=p[f]; z<p[f+1]; z++){
+          nrow_[z] = row[f] + ci[z]*lr[l+1];
+          ncol_[z] = col[f] + ci[z]*lc[l+1];
+        }
+      }
+      std::swap(row, nrow_);
+      std::swap(col, ncol_);
+    }
+    for (int64_t i=0; i<nnz(); i++){
+      rs[i] = row[i]+1;
+      cs[i] = col[i]+1;
+    }
+    cdealloc(ncol_);
+    cdealloc(nrow_);
+    cdealloc(col);
+    cdealloc(row);
+  }
+
+  void CSF_Matrix::csfmm(char const * A, algstrct const * sr_A, int m, int n, int k, char const * alpha, char const * B, algstrct const * sr_B, char const * beta, char * C, algstrct const * sr_C, bivar_function const * func){
+    ASSERT(func == NULL);
+    ASSERT(sr_B->el_size == sr_A->el_size);
+    ASSERT(sr_C->el_size == sr_A->el_size);
+    sr_C->csfmm(m,n,k,alpha,A,B,beta,C);
+  }
+}
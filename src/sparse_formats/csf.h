@@ -0,0 +1,237 @@
+#ifndef __CSF_H__
+#define __CSF_H__
+
+#include "../tensor/algstrct.h"
+
+namespace CTF_int {
+
+  class bivar_function;
+
+  /**
+   * \brief computes the size of a serialized CSF tensor
+   * \param[in] nnz number of nonzeros in tensor
+   * \param[in] nlvl number of levels of the fiber tree
+   * \param[in] nfib number of nodes on each level of the fiber tree, nfib[nlvl-1] = nnz
+   * \param[in] val_size size of each tensor entry
+   */
+  int64_t get_csf_size(int64_t nnz, int nlvl, int64_t const * nfib, int val_size);
+
+  /**
+   * \brief decides whether the local blocks of a sparse tensor are stored more compactly as CSF than as COO or CSR,
+   *        assuming nonzeros are uniformly distributed, so that a level whose subtensor has P entries holds
+   *        P*(1-exp(-nnz/P)) fibers
+   * \param[in] order number of tensor modes
+   * \param[in] loc_lens local (per-block) dimensions of tensor modes
+   * \param[in] nnz_blk expected number of nonzeros in each block
+   * \param[in] val_size size of each tensor entry
+   * \param[in] nrow number of rows of the matricization, used to size CSR
+   * \param[in] csr whether CSF is compared to CSR (1) or to COO (0)
+   */
+  bool prefer_csf(int order, int const * loc_lens, double nnz_blk, int val_size, int64_t nrow, bool csr);
+
+  /**
+   * \brief abstraction for a serialized sparse tensor stored in compressed sparse fiber (CSF) layout, which is a tree
+   *        whose levels are the modes of the tensor, with the mode of largest key stride at the root, so that the key-sorted
+   *        pair buffer of a block is already in tree order. Each node stores the index of its mode and, unless it is a leaf,
+   *        the range of its children, so index prefixes shared by nonzeros are stored and decoded once.
+   *        The tensor is viewed as a matricization, each level contributes its index to either the row or the column,
+   *        modes of local length one are omitted.
+   */
+  class CSF_Matrix{
+    public:
+      /** \brief serialized buffer containing all info, index, and values related to tensor */
+      char * all_data;
+
+      /** \brief constructor given serialized CSF tensor */
+      CSF_Matrix(char * all_data);
+
+      CSF_Matrix(){ all_data=NULL; }
+
+      /**
+       * \brief constructor that builds the fiber tree from a key-sorted pair buffer, with the same matricization as COO_Matrix::set_data
+       * \param[in] nz number of nonzeros
+       * \param[in] order number of tensor modes
+       * \param[in] lens ranges of tensor modes
+       * \param[in] ordering reordering of tensor modes
+       * \param[in] nrow_idx number of modes to fold into rows
+       * \param[in] nrow number of rows of the matricization
+       * \param[in] ncol number of columns of the matricization
+       * \param[in] tsr_data in key-value pair format, sorted by key
+       * \param[in] sr algebraic structure
+       * \param[in] phase dimensions of the blocking grid
+       * \param[in] data preallocated buffer of size get_size(), allocated if NULL
+       */
+      CSF_Matrix(int64_t nz, int order, int const * lens, int const * ordering, int nrow_idx, int nrow, int ncol, char const * tsr_data, algstrct const * sr, int const * phase, char * data=NULL);
+
+      /**
+       * \brief computes the size of the CSF tensor built by the above constructor, by counting fibers
+       */
+      static int64_t get_size(int64_t nz, int order, int const * lens, int const * ordering, int nrow_idx, char const * tsr_data, algstrct const * sr, int const * phase);
+
+      /** \brief retrieves number of nonzeros out of all_data */
+      int64_t nnz() const;
+
+      /** \brief retrieves buffer size out of all_data */
+      int64_t size() const;
+
+      /** \brief retrieves number of rows of the matricization out of all_data */
+      int nrow() const;
+
+      /** \brief retrieves number of columns of the matricization out of all_data */
+      int ncol() const;
+
+      /** \brief retrieves tensor entry size out of all_data */
+      int val_size() const;
+
+      /** \brief retrieves number of levels of the fiber tree out of all_data */
+      int nlvl() const;
+
+      /** \brief retrieves number of nodes on each level out of all_data */
+      int64_t * nfib() const;
+
+      /** \brief retrieves stride of the index of each level in the row of the matricization (0 for column levels) */
+      int64_t * lda_row() const;
+
+      /** \brief retrieves stride of the index of each level in the column of the matricization (0 for row levels) */
+      int64_t * lda_col() const;
+
+      /** \brief retrieves array of values (leaves) out of all_data */
+      char * vals() const;
+
+      /** \brief retrieves indices of the nodes on level l */
+      int * ids(int l) const;
+
+      /** \brief retrieves the children of node f on level l, ptr(l)[f] to ptr(l)[f+1]-1 on level l+1, for l<nlvl()-1 */
+      int * ptr(int l) const;
+
+      /**
+       * \brief writes the nonzeros in coordinate form, with 1-based row and column indices as in COO_Matrix
+       * \param[out] rs row index of each value
+       * \param[out] cs column index of each value
+       */
+      void get_coords(int * rs, int * cs) const;
+
+      /**
+       * \brief computes C = beta*C + alpha*A*B where A is a CSF_Matrix, while B and C are dense
+       */
+      static void csfmm(char const * A, algstrct const * sr_A, int m, int n, int k, char const * alpha, char const * B, algstrct const * sr_B, char const * beta, char * C, algstrct const * sr_C, bivar_function const * func);
+  };
+
+  /**
+   * \brief walks the subtrees of the nodes fb,...,fe-1 of level l of a CSF tensor A and accumulates C += alpha*A*B,
+   *        the row and column offsets of each node are formed incrementally from those of its parent and the children
+   *        of the last inner level are handled as a whole fiber, as a dot product when they index columns and as an axpy
+   *        when they index rows
+   * \param[in] mul multiplication of the algebraic structure
+   * \param[in] add addition of the algebraic structure
+   */
+  template <typename dtype, typename mul_t, typename add_t>
+  void csfmm_fibers(int             l,
+                    int64_t         fb,
+                    int64_t         fe,
+                    int64_t         row,
+                    int64_t         col,
+                    int             nlvl,
+                    int const *     const * ptr,
+                    int const *     const * ids,
+                    int64_t const * lda_row,
+                    int64_t const * lda_col,
+                    dtype const *   A,
+                    int             m,
+                    int             n,
+                    int             k,
+                    dtype           alpha,
+                    dtype const *   B,
+                    dtype *         C,
+                    mul_t           mul,
+                    add_t           add){
+    if (l == nlvl-1){
+      for (int64_t f=fb; f<fe; f++){
+        int64_t r = row + ids[l][f]*lda_row[l];
+        int64_t c = col + ids[l][f]*lda_col[l];
+        dtype a = mul(alpha, A[f]);
+        for (int j=0; j<n; j++){
+          C[r+j*m] = add(C[r+j*m], mul(a, B[c+j*k]));
+        }
+      }
+      return;
+    }
+    int const * lids = ids[l];
+    int const * lptr = ptr[l];
+    if (l < nlvl-2){
+      for (int64_t f=fb; f<fe; f++){
+        csfmm_fibers(l+1, lptr[f], lptr[f+1], row+lids[f]*lda_row[l], col+lids[f]*lda_col[l], nlvl, ptr, ids, lda_row, lda_col, A, m, n, k, alpha, B, C, mul, add);
+      }
+      return;
+    }
+    int const * leaf_ids = ids[l+1];
+    int64_t leaf_row = lda_row[l+1];
+    int64_t leaf_col = lda_col[l+1];
+    for (int64_t f=fb; f<fe; f++){
+      int64_t r = row + lids[f]*lda_row[l];
+      int64_t c = col + lids[f]*lda_col[l];
+      int64_t lb = lptr[f];
+      int64_t le = lptr[f+1];
+      if (leaf_row == 0){
+        for (int j=0; j<n; j++){
+          dtype const * Bj = B + c + j*k;
+          dtype tmp = mul(A[lb], Bj[leaf_ids[lb]*leaf_col]);
+          for (int64_t z=lb+1; z<le; z++){
+            tmp = add(tmp, mul(A[z], Bj[leaf_ids[z]*leaf_col]));
+          }
+          C[r+j*m] = add(C[r+j*m], mul(alpha, tmp));
+        }
+      } else {
+        for (int j=0; j<n; j++){
+          dtype b = mul(alpha, B[c+j*k]);
+          dtype * Cj = C + r + j*m;
+          for (int64_t z=lb; z<le; z++){
+            Cj[leaf_ids[z]*leaf_row] = add(Cj[leaf_ids[z]*leaf_row], mul(A[z], b));
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * \brief computes C += alpha*A*B where A is a serialized CSF tensor, while B and C are dense,
+   *        subtrees are distributed among threads when the root level indexes rows, so that they update disjoint rows of C
+   * \param[in] mul multiplication of the algebraic structure
+   * \param[in] add addition of the algebraic structure
+   */
+  template <typename dtype, typename mul_t, typename add_t>
+  void csfmm_tree(int           m,
+                  int           n,
+                  int           k,
+                  dtype         alpha,
+                  char const *  all_data,
+                  dtype const * B,
+                  dtype *       C,
+                  mul_t         mul,
+                  add_t         add){
+    CSF_Matrix cA((char*)all_data);
+    int nlvl = cA.nlvl();
+    int64_t nroot = cA.nfib()[0];
+    int const * ptr[nlvl];
+    int const * ids[nlvl];
+    for (int l=0; l<nlvl; l++){
+      ids[l] = cA.ids(l);
+      ptr[l] = l<nlvl-1 ? cA.ptr(l) : NULL;
+    }
+    int64_t const * lda_row = cA.lda_row();
+    int64_t const * lda_col = cA.lda_col();
+    dtype const * A = (dtype const*)cA.vals();
+    if (nlvl > 1 && lda_row[0] != 0){
+#ifdef USE_OMP
+      #pragma omp parallel for schedule(dynamic)
+#endif
+      for (int64_t f=0; f<nroot; f++){
+        csfmm_fibers(0, f, f+1, 0, 0, nlvl, ptr, ids, lda_row, lda_col, A, m, n, k, alpha, B, C, mul, add);
+      }
+    } else {
+      csfmm_fibers(0, 0, nroot, 0, 0, nlvl, ptr, ids, lda_row, lda_col, A, m, n, k, alpha, B, C, mul, add);
+    }
+  }
+}
+
+#endif
@@ -3,6 +3,9 @@
 
 #include "../tensor/algstrct.h"
 #include "coo.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace CTF_int {
 
@@ -103,6 +106,118 @@ namespace CTF_int {
       
       static char * csr_add(char * cA, char * cB, accumulatable const * adder);
   };
+
+  /** \brief number of columns of B and C whose partial sums are kept in registers by csrmm_merge_path */
+  #define CSRMM_COL_BLK 8
+
+  /**
+   * \brief finds the point at which diagonal d crosses the merge path of the row ends of a CSR matrix with the
+   *        indices of its nonzeros, i.e. the number of rows and nonzeros consumed by the first d steps of the merge
+   * \param[in] d diagonal, at most m+nnz
+   * \param[in] m number of rows
+   * \param[in] nnz number of nonzeros
+   * \param[in] IA 1-based row offsets
+   * \param[out] row number of rows consumed
+   * \param[out] nz number of nonzeros consumed
+   */
+  inline void csr_merge_path_search(int64_t d, int m, int64_t nnz, int const * IA, int & row, int64_t & nz){
+    int64_t lo = std::max((int64_t)0, d-nnz);
+    int64_t hi = std::min(d, (int64_t)m);
+    while (lo < hi){
+      int64_t piv = (lo+hi)/2;
+      // row piv ends at (0-based) offset IA[piv+1]-1, it is consumed before nonzero d-piv-1 if it ends at or before it
+      if (IA[piv+1]-1 <= d-piv-1) lo = piv+1;
+      else hi = piv;
+    }
+    row = (int)lo;
+    nz = d-lo;
+  }
+
+  /**
+   * \brief computes C += A*B where A is an m-by-k matrix in CSR format with 1-based indices, while B and C are dense
+   *        and column-major. The merge path of the row ends with the nonzeros is split evenly among threads, so
+   *        each thread gets the same number of nonzeros plus rows regardless of how the nonzeros are spread among rows.
+   *        A thread adds the sums of the rows that end in its part to C and carries out the partial sum of the row
+   *        that continues past it, the carries are added to C once all threads are done. Columns of B are processed
+   *        in blocks of CSRMM_COL_BLK, for which partial sums are kept in registers.
+   * \param[in] mul product of an entry of A with an entry of B
+   * \param[in] add sum of two products
+   * \param[in] acc acc(c, s) accumulates sum of products s into entry c of C, e.g. c = c + alpha*s
+   */
+  template <typename dtype_A, typename dtype_B, typename dtype_C, typename mul_t, typename add_t, typename acc_t>
+  void csrmm_merge_path(int             m,
+                        int             n,
+                        int             k,
+                        dtype_A const * A,
+                        int const *     JA,
+                        int const *     IA,
+                        dtype_B const * B,
+                        dtype_C *       C,
+                        mul_t           mul,
+                        add_t           add,
+                        acc_t           acc){
+    int64_t nnz = IA[m]-1;
+    if (m == 0 || n == 0 || nnz == 0) return;
+#ifdef _OPENMP
+    int ntd = std::max(1, std::min(omp_get_max_threads(), (int)std::min((int64_t)INT_MAX, (m+nnz)/64)));
+#else
+    int ntd = 1;
+#endif
+    int64_t len = (m+nnz+ntd-1)/ntd;
+    dtype_C * carry = new dtype_C[((int64_t)ntd)*n];
+    int * carry_row = (int*)CTF_int::alloc(sizeof(int)*ntd);
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static,1)
+#endif
+    for (int t=0; t<ntd; t++){
+      int row_st, row_end;
+      int64_t nz_st, nz_end;
+      csr_merge_path_search(std::min(t*len, m+nnz), m, nnz, IA, row_st, nz_st);
+      csr_merge_path_search(std::min((t+1)*len, m+nnz), m, nnz, IA, row_end, nz_end);
+      // the partial sum of row row_end is carried out if the part has nonzeros of it
+      carry_row[t] = nz_end > nz_st && (row_end == m || IA[row_end]-1 < nz_end) ? row_end : -1;
+      for (int jb=0; jb<n; jb+=CSRMM_COL_BLK){
+        int nb = std::min(CSRMM_COL_BLK, n-jb);
+        dtype_B const * Bb = B+((int64_t)jb)*k;
+        dtype_C * Cb = C+((int64_t)jb)*m;
+        dtype_C tmp[CSRMM_COL_BLK];
+        int64_t z = nz_st;
+        for (int r=row_st; r<=row_end && r<m; r++){
+          int64_t ze = r < row_end ? IA[r+1]-1 : nz_end;
+          if (z < ze){
+            int col_A = JA[z]-1;
+            for (int j=0; j<nb; j++){
+              tmp[j] = mul(A[z], Bb[((int64_t)j)*k+col_A]);
+            }
+            for (z=z+1; z<ze; z++){
+              col_A = JA[z]-1;
+              for (int j=0; j<nb; j++){
+                tmp[j] = add(tmp[j], mul(A[z], Bb[((int64_t)j)*k+col_A]));
+              }
+            }
+            if (r < row_end){
+              for (int j=0; j<nb; j++){
+                acc(Cb[((int64_t)j)*m+r], tmp[j]);
+              }
+            } else {
+              for (int j=0; j<nb; j++){
+                carry[((int64_t)t)*n+jb+j] = tmp[j];
+              }
+            }
+          }
+        }
+      }
+    }
+    for (int t=0; t<ntd; t++){
+      if (carry_row[t] >= 0 && carry_row[t] < m){
+        for (int j=0; j<n; j++){
+          acc(C[((int64_t)j)*m+carry_row[t]], carry[((int64_t)t)*n+j]);
+        }
+      }
+    }
+    CTF_int::cdealloc(carry_row);
+    delete [] carry;
+  }
 }
 
 #endif
@@ -123,7 +123,11 @@ namespace CTF_int {
   #endif
     print();
 #endif
-    //update_all_models(A->wrld->cdt.cm);
+    if (A->wrld->cdt.cm == MPI_COMM_WORLD){
+      learn_all_models(A->wrld->cdt.cm);
+    }
+    A->wait_redistribute();
+    B->wait_redistribute();
     int stat = home_sum_tsr(run_diag);
     if (stat != SUCCESS)
       printf("CTF ERROR: Failed to perform summation\n");
@@ -1043,6 +1047,19 @@ namespace CTF_int {
       B->data = tnsr_B->data;
     } else B->unfold();
 
+#ifdef LAZY_HOME
+    if (was_home_B && !tnsr_B->is_home && !B->is_sparse){
+      if (A->wrld->cdt.rank == 0)
+        DPRINTF(2,"Leaving tensor %s away from home\n", B->name);
+      TAU_FSTART(avoided_redistribute_to_home);
+      B->leave_home_lazily(tnsr_B);
+      TAU_FSTOP(avoided_redistribute_to_home);
+      tnsr_B->is_data_aliased = 1;
+      tnsr_B->is_home = 0;
+      tnsr_B->has_home = 0;
+      delete tnsr_B;
+    } else
+#endif
     if (was_home_B && !tnsr_B->is_home){
       if (A->wrld->cdt.rank == 0)
         DPRINTF(1,"Migrating tensor %s back to home\n", B->name);
@@ -288,6 +288,22 @@ namespace CTF_int {
     assert(0);
   }
 
+  void algstrct::mul_acc(int64_t      n,
+                         char const * alpha,
+                         char const * A,
+                         int64_t      incA,
+                         char const * B,
+                         int64_t      incB,
+                         char       * C,
+                         int64_t      incC)  const {
+    char tmp[el_size];
+    for (int64_t i=0; i<n; i++){
+      mul(A+i*incA*el_size, B+i*incB*el_size, tmp);
+      if (alpha != NULL) mul(tmp, alpha, tmp);
+      add(tmp, C+i*incC*el_size, C+i*incC*el_size);
+    }
+  }
+
   void algstrct::gemm_batch(char         tA,
                             char         tB,
                             int          l,
@@ -710,6 +726,11 @@ namespace CTF_int {
     ASSERT(0);
   }
 
+  void algstrct::csfmm(int m, int n, int k, char const * alpha, char const * A, char const * B, char const * beta, char * C) const {
+    printf("CTF ERROR: csfmm not present for this algebraic structure\n");
+    ASSERT(0);
+  }
+
   void algstrct::csrmultd
                 (int          m,
                  int          n,
@@ -989,7 +1010,8 @@ namespace CTF_int {
 
 
   int64_t PairIterator::lower_bound(int64_t n, ConstPairIterator op){
-    switch (sr->el_size){
+    // pairs of types with stricter alignment than int64_t (e.g. long double) are padded, so CompPair has the wrong stride
+    switch (sr->pair_size() == sr->el_size+(int)sizeof(int64_t) ? sr->el_size : -1){
       case 1:
         return std::lower_bound((CompPair<1>*)ptr,((CompPair<1>*)ptr)+n, ((CompPair<1>*)op.ptr)[0]) - (CompPair<1>*)ptr;
         break;
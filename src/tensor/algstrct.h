@@ -163,6 +163,17 @@ namespace CTF_int {
                         char       * Y,
                         int          incY)  const;
 
+      /** \brief C[i*incC]+=alpha*A[i*incA]*B[i*incB] for i<n, strides may be zero
+        * \param[in] alpha scaling factor, multiplicative identity if NULL */
+      virtual void mul_acc(int64_t      n,
+                           char const * alpha,
+                           char const * A,
+                           int64_t      incA,
+                           char const * B,
+                           int64_t      incB,
+                           char       * C,
+                           int64_t      incC)  const;
+
       /** \brief beta*C["ij"]=alpha*A^tA["ik"]*B^tB["kj"]; */
       virtual void gemm(char         tA,
                         char         tB,
@@ -229,6 +240,16 @@ namespace CTF_int {
                          char *                 C,
                          bivar_function const * func) const;
 
+      /** \brief sparse version of gemm using CSF format for A, given as a serialized CSF_Matrix */
+      virtual void csfmm(int          m,
+                         int          n,
+                         int          k,
+                         char const * alpha,
+                         char const * A,
+                         char const * B,
+                         char const * beta,
+                         char *       C) const;
+
       /** \brief sparse version of gemm using CSR format for A and B*/
       virtual void csrmultd
                 (int          m,
@@ -14,6 +14,8 @@
 #include "../redistribution/cyclic_reshuffle.h"
 #include "../redistribution/glb_cyclic_reshuffle.h"
 #include "../redistribution/dgtog_redist.h"
+#include "../redistribution/dense_slice.h"
+#include "../sparse_formats/csf.h"
 
 
 using namespace CTF;
@@ -35,11 +37,14 @@ namespace CTF_int {
 
   tensor::tensor(){
     order=-1;
+    pending_redist=NULL;
+    home_map=NULL;
   }
 
   void tensor::free_self(){
     if (order != -1){
       if (wrld->rank == 0) DPRINTF(3,"Deleted order %d tensor %s\n",order,name);
+      wait_redistribute();
       if (is_folded) unfold();
       cdealloc(sym);
       cdealloc(lens);
@@ -49,6 +54,7 @@ namespace CTF_int {
         cdealloc(scp_padding);
       cdealloc(sym_table);
       delete [] edge_map;
+      if (home_map != NULL) delete [] home_map;
       deregister_size();
       if (!is_data_aliased){
         if (is_home){
@@ -287,6 +293,15 @@ namespace CTF_int {
     this->topo      = other->topo;
     if (other->is_mapped)
       copy_mapping(other->order, other->edge_map, this->edge_map);
+    if (this->home_map != NULL){
+      delete [] this->home_map;
+      this->home_map = NULL;
+    }
+    if (other->home_map != NULL && this->has_home && !this->is_home){
+      this->home_map = new mapping[other->order];
+      copy_mapping(other->order, other->home_map, this->home_map);
+      this->home_topo = other->home_topo;
+    }
     this->size = other->size;
     this->nnz_loc = other->nnz_loc;
     this->nnz_tot = other->nnz_tot;
@@ -332,9 +347,13 @@ namespace CTF_int {
     this->nnz_loc           = 0;
     this->nnz_tot           = 0;
     this->nnz_blk           = NULL;
+    this->pending_redist    = NULL;
     this->is_csr            = false;
+    this->is_csf            = false;
     this->nrow_idx          = -1;
     this->left_home_transp  = 0;
+    this->home_map          = NULL;
+    this->home_topo         = NULL;
 //    this->nnz_loc_max       = 0;
     this->registered_alloc_size = 0;
     if (name_ != NULL){
@@ -497,6 +516,7 @@ namespace CTF_int {
 
 
   int tensor::set_zero() {
+    wait_redistribute();
     TAU_FSTART(set_zero_tsr);
     int * restricted;
     int i, map_success, btopo;
@@ -687,6 +707,33 @@ namespace CTF_int {
     }
   }
 
+  std::string tensor::get_map_str() const {
+    std::string str = std::string(name) + "[";
+    char buf[64];
+    for (int dim=0; dim<order; dim++){
+      if (dim>0) str += ",";
+      int tp = edge_map[dim].calc_phase();
+      int pp = edge_map[dim].calc_phys_phase();
+      int vp = tp/pp;
+      if (tp==1) str += "1";
+      else {
+        if (pp > 1){
+          sprintf(buf, "p%d(%d)", edge_map[dim].np, edge_map[dim].cdt);
+          str += buf;
+          if (edge_map[dim].has_child && edge_map[dim].child->type == PHYSICAL_MAP){
+            sprintf(buf, "p%d(%d)", edge_map[dim].child->np, edge_map[dim].child->cdt);
+            str += buf;
+          }
+        }
+        if (vp > 1){
+          sprintf(buf, "v%d", vp);
+          str += buf;
+        }
+      }
+    }
+    return str + "]";
+  }
+
   void tensor::set_name(char const * name_){
     cdealloc(name);
     this->name = (char*)alloc(strlen(name_)+1);
@@ -706,6 +753,8 @@ namespace CTF_int {
   }
 
   void tensor::get_raw_data(char ** data_, int64_t * size_) const {
+    //raw data is expected to be in the home distribution
+    ((tensor*)this)->go_home();
     *size_ = size;
     *data_ = data;
   }
@@ -895,6 +944,16 @@ namespace CTF_int {
     }
    // bool tsr_A_has_sym = false; 
 
+    // dense nonsymmetric blocks are moved directly between the cyclic layouts, key-value pairs are only needed otherwise
+    if (can_dense_slice(tsr_A, tsr_B)){
+      dense_slice(offsets_B, ends_B, beta, tsr_B, tsr_A, offsets_A, ends_A, alpha);
+      CTF_int::cdealloc(padding_A);
+      CTF_int::cdealloc(padding_B);
+      CTF_int::cdealloc(toffset_A);
+      CTF_int::cdealloc(toffset_B);
+      return;
+    }
+
     if (tsr_B->wrld->np <= tsr_A->wrld->np){
       //usually 'read' elements of B from A, since B may be smalelr than A
       if (tsr_B->order == 0 || tsr_B->has_zero_edge_len){
@@ -1077,6 +1136,7 @@ namespace CTF_int {
                     char const * beta,
                     char *       mapped_data,
                     char const   rw){
+    wait_redistribute();
     int i, num_virt;
     int * phase, * phys_phase, * virt_phase, * bucket_lda;
     int * virt_phys_rank;
@@ -1215,6 +1275,7 @@ namespace CTF_int {
                    char const * alpha,
                    char const * beta,
                    char *       mapped_data){
+    wait_redistribute();
     return write(num_pair, alpha, beta, mapped_data, 'r');
   }
 
@@ -1346,6 +1407,7 @@ namespace CTF_int {
   }
 
   int tensor::sparsify(std::function<bool(char const*)> f){
+    wait_redistribute();
     if (is_sparse){
       TAU_FSTART(sparsify);
       int64_t nnz_loc_new = 0;
@@ -1385,6 +1447,8 @@ namespace CTF_int {
       TAU_FSTOP(sparsify);
     } else {
       TAU_FSTART(sparsify_dense);
+      //the output of a previous operation may have been left in its last mapping
+      go_home();
       ASSERT(!has_home || is_home);
       int nvirt = calc_nvirt();
       this->nnz_blk = (int64_t*)alloc(sizeof(int64_t)*nvirt);
@@ -1526,6 +1590,7 @@ namespace CTF_int {
   int tensor::read_local_nnz(int64_t * num_pair,
                              char **   mapped_data,
                              bool      unpack_sym) const {
+    ((tensor*)this)->go_home();
     if (sr->isequal(sr->addid(), NULL) && !is_sparse)
       return read_local_nnz(num_pair,mapped_data, unpack_sym);
     tensor tsr_cpy(this);
@@ -1549,6 +1614,7 @@ namespace CTF_int {
     mapping * map;
 
 
+    ((tensor*)this)->go_home();
     tsr = this;
     if (tsr->has_zero_edge_len){
       *num_pair = 0;
@@ -1761,6 +1827,7 @@ namespace CTF_int {
   }
 
   int tensor::reduce_sum(char * result, algstrct const * sr_other) {
+    wait_redistribute();
     ASSERT(is_mapped && !is_folded);
     tensor sc = tensor(sr_other, 0, NULL, NULL, wrld, 1);
     int idx_A[order];
@@ -1779,6 +1846,7 @@ namespace CTF_int {
   }
 
   int tensor::reduce_sumabs(char * result, algstrct const * sr_other){
+    wait_redistribute();
     ASSERT(is_mapped && !is_folded);
     univar_function func = univar_function(sr_other->abs);
     tensor sc = tensor(sr_other, 0, NULL, NULL, wrld, 1);
@@ -1794,6 +1862,7 @@ namespace CTF_int {
   }
 
   int tensor::reduce_sumsq(char * result) {
+    wait_redistribute();
     ASSERT(is_mapped && !is_folded);
     tensor sc = tensor(sr, 0, NULL, NULL, wrld, 1);
     int idx_A[order];
@@ -2015,6 +2084,7 @@ namespace CTF_int {
   }
 
   void tensor::unfold(bool was_mod){
+    wait_redistribute();
     int i, j, allfold_dim;
     int * all_edge_len, * sub_edge_len;
     if (this->is_folded){
@@ -2038,7 +2108,7 @@ namespace CTF_int {
       } else {
         ASSERT(this->nrow_idx != -1);
         if (was_mod)
-          despmatricize(this->nrow_idx, this->is_csr);
+          despmatricize(this->nrow_idx, this->is_csr, this->is_csf);
         cdealloc(this->rec_tsr->data);
       }
       CTF_int::cdealloc(all_edge_len);
@@ -2198,6 +2268,7 @@ namespace CTF_int {
     char * shuffled_data_corr;
   #endif
 
+    wait_redistribute();
     distribution new_dist = distribution(this);
     if (is_sparse) can_block_shuffle = 0;
     else {
@@ -2301,6 +2372,24 @@ namespace CTF_int {
     }
 
     this->data = shuffled_data;
+  #ifdef LAZY_HOME
+    if (this->home_map != NULL && this->topo == this->home_topo && this->is_cyclic){
+      bool is_home_map = true;
+      for (int i=0; i<this->order; i++){
+        if (!comp_dim_map(&this->edge_map[i], &this->home_map[i]))
+          is_home_map = false;
+      }
+      //the mapping selected for this tensor is its home, so move data into the home buffer
+      if (is_home_map && this->size == this->home_size){
+        sr->copy(this->home_buffer, this->data, this->size);
+        sr->dealloc(this->data);
+        this->data = this->home_buffer;
+        this->is_home = 1;
+        delete [] this->home_map;
+        this->home_map = NULL;
+      }
+    }
+  #endif
 //    zero_out_padding();
   #if VERIFY_REMAP
     if (!is_sparse && sr->addid() != NULL){
@@ -2339,6 +2428,49 @@ namespace CTF_int {
   }
 
 
+  redist_request * tensor::redistribute_async(distribution const & old_dist){
+    wait_redistribute();
+    bool can_post = !is_sparse && order > 0;
+  #ifdef USE_BLOCK_RESHUFFLE
+    if (can_block_reshuffle(this->order, old_dist.phase, this->edge_map))
+      can_post = false;
+  #endif
+  #if VERIFY_REMAP
+    can_post = false;
+  #endif
+    if (!can_post){
+      redistribute(old_dist);
+      return NULL;
+    }
+    distribution new_dist = distribution(this);
+
+  #ifdef HOME_CONTRACT
+    if (this->is_home){
+      if (wrld->cdt.rank == 0)
+        DPRINTF(2,"Tensor %s leaving home %d\n", name, is_sparse);
+      this->data = sr->alloc(old_dist.size);
+      sr->copy(this->data, this->home_buffer, old_dist.size);
+      this->is_home = 0;
+    }
+  #endif
+  #if VERBOSE >=1
+    if (wrld->cdt.rank == 0)
+      VPRINTF(1,"Remapping tensor %s asynchronously via cyclic_reshuffle to mapping\n",this->name);
+    this->print_map(stdout);
+  #endif
+    pending_redist = dgtog_reshuffle_post(sym, lens, old_dist, new_dist, &this->data, sr, wrld->cdt);
+    return pending_redist;
+  }
+
+  void tensor::wait_redistribute(){
+    if (pending_redist != NULL){
+      redist_request * req = pending_redist;
+      pending_redist = NULL;
+      this->data = req->wait();
+      delete req;
+    }
+  }
+
   double tensor::est_redist_time(distribution const & old_dist, double nnz_frac){
     int nvirt = (int64_t)calc_nvirt();
     bool can_blres;
@@ -2556,6 +2688,7 @@ namespace CTF_int {
 
 
   int tensor::zero_out_padding(){
+    wait_redistribute();
     int i, num_virt, idx_lyr;
     int64_t np;
     int * virt_phase, * virt_phys_rank, * phys_phase, * phase;
@@ -2713,7 +2846,7 @@ namespace CTF_int {
     }
   }
 
-  void tensor::spmatricize(int m, int n, int nrow_idx, bool csr){
+  void tensor::spmatricize(int m, int n, int nrow_idx, bool csr, bool csf){
     ASSERT(is_sparse);
 
 #ifdef PROFILE
@@ -2725,23 +2858,29 @@ namespace CTF_int {
     this->rec_tsr->is_sparse = 1;
     int nvirt_A = calc_nvirt();
     this->rec_tsr->nnz_blk = (int64_t*)alloc(nvirt_A*sizeof(int64_t));
+    int phase[this->order];
+    for (int i=0; i<this->order; i++){
+      phase[i] = this->edge_map[i].calc_phase();
+    }
+    char const * data_ptr_in = this->data;
     for (int i=0; i<nvirt_A; i++){
-      if (csr)
+      if (csf)
+        this->rec_tsr->nnz_blk[i] = CSF_Matrix::get_size(this->nnz_blk[i], this->order, this->lens, this->inner_ordering, nrow_idx, data_ptr_in, this->sr, phase);
+      else if (csr)
         this->rec_tsr->nnz_blk[i] = get_csr_size(this->nnz_blk[i], m, this->sr->el_size);
       else
         this->rec_tsr->nnz_blk[i] = get_coo_size(this->nnz_blk[i], this->sr->el_size);
       new_sz_A += this->rec_tsr->nnz_blk[i];
+      data_ptr_in += this->nnz_blk[i]*this->sr->pair_size();
     }
     CTF_int::alloc_ptr(new_sz_A, (void**)&this->rec_tsr->data);
     this->rec_tsr->is_data_aliased = false;
-    int phase[this->order];
-    for (int i=0; i<this->order; i++){
-      phase[i] = this->edge_map[i].calc_phase();
-    }
     char * data_ptr_out = this->rec_tsr->data;
-    char const * data_ptr_in = this->data;
+    data_ptr_in = this->data;
     for (int i=0; i<nvirt_A; i++){
-      if (csr){
+      if (csf){
+        CSF_Matrix cf(this->nnz_blk[i], this->order, this->lens, this->inner_ordering, nrow_idx, m, n, data_ptr_in, this->sr, phase, data_ptr_out);
+      } else if (csr){
         COO_Matrix cm(this->nnz_blk[i], this->sr);
         cm.set_data(this->nnz_blk[i], this->order, this->lens, this->inner_ordering, nrow_idx, data_ptr_in, this->sr, phase);
         CSR_Matrix cs(cm, m, n, this->sr, data_ptr_out);
@@ -2754,6 +2893,7 @@ namespace CTF_int {
       data_ptr_out += this->rec_tsr->nnz_blk[i];
     }
     this->is_csr = csr;
+    this->is_csf = csf;
     this->nrow_idx = nrow_idx;
 #ifdef PROFILE
 //        double t_end = MPI_Wtime();
@@ -2775,7 +2915,7 @@ namespace CTF_int {
 #endif
   }
 
-  void tensor::despmatricize(int nrow_idx, bool csr){
+  void tensor::despmatricize(int nrow_idx, bool csr, bool csf){
     ASSERT(is_sparse);
 
 #ifdef PROFILE
@@ -2789,7 +2929,10 @@ namespace CTF_int {
     int nvirt = calc_nvirt();
     for (int i=0; i<nvirt; i++){
       if (this->rec_tsr->nnz_blk[i]>0){
-        if (csr){
+        if (csf){
+          CSF_Matrix cA(this->rec_tsr->data+offset);
+          new_sz += cA.nnz();
+        } else if (csr){
           CSR_Matrix cA(this->rec_tsr->data+offset);
           new_sz += cA.nnz();
         } else {
@@ -2812,7 +2955,16 @@ namespace CTF_int {
     char const * data_ptr_in = this->rec_tsr->data;
     for (int i=0; i<nvirt; i++){
       if (this->rec_tsr->nnz_blk[i]>0){
-        if (csr){
+        if (csf){
+          CSF_Matrix cf((char*)data_ptr_in);
+          COO_Matrix cm(cf.nnz(), this->sr);
+          this->sr->init_shell(cf.nnz(), cm.vals());
+          this->sr->copy(cf.nnz(), cf.vals(), 1, cm.vals(), 1);
+          cf.get_coords(cm.rows(), cm.cols());
+          cm.get_data(cf.nnz(), this->order, this->lens, this->inner_ordering, nrow_idx, data_ptr_out, this->sr, phase, phase_rank);
+          this->nnz_blk[i] = cm.nnz();
+          cdealloc(cm.all_data);
+        } else if (csr){
           CSR_Matrix cs((char*)data_ptr_in);
           COO_Matrix cm(cs, this->sr);
           cm.get_data(cs.nnz(), this->order, this->lens, this->inner_ordering, nrow_idx, data_ptr_out, this->sr, phase, phase_rank);
@@ -2840,6 +2992,7 @@ namespace CTF_int {
     }
     set_new_nnz_glb(this->nnz_blk);
     this->rec_tsr->is_csr = csr;
+    this->rec_tsr->is_csf = csf;
 
 #ifdef PROFILE
 //        double t_end = MPI_Wtime();
@@ -2865,6 +3018,51 @@ namespace CTF_int {
     }
     this->is_home = 0;
     this->has_home = 0;
+    if (this->home_map != NULL){
+      delete [] this->home_map;
+      this->home_map = NULL;
+    }
+#endif
+  }
+
+  void tensor::leave_home_lazily(tensor * other){
+    ASSERT(this->has_home && this->is_home && !this->is_sparse);
+    this->home_map = new mapping[this->order];
+    copy_mapping(this->order, this->edge_map, this->home_map);
+    this->home_topo = this->topo;
+    this->topo = other->topo;
+    copy_mapping(this->order, other->edge_map, this->edge_map);
+    this->is_cyclic = other->is_cyclic;
+    this->set_padding();
+    this->data = other->data;
+    this->is_home = 0;
+  }
+
+  void tensor::go_home(){
+#ifdef HOME_CONTRACT
+    wait_redistribute();
+    if (this->home_map == NULL) return;
+    ASSERT(this->has_home && !this->is_home);
+    if (wrld->rank == 0)
+      DPRINTF(2,"Migrating tensor %s back to home\n", name);
+    this->unfold();
+    distribution dst(this);
+    this->topo = this->home_topo;
+    copy_mapping(this->order, this->home_map, this->edge_map);
+    this->is_cyclic = 1;
+    this->set_padding();
+    TAU_FSTART(redistribute_to_home);
+    this->redistribute(dst);
+    TAU_FSTOP(redistribute_to_home);
+    if (this->home_map != NULL){
+      //redistribute did not already place the data in the home buffer
+      sr->copy(this->home_buffer, this->data, this->size);
+      sr->dealloc(this->data);
+      this->data = this->home_buffer;
+      this->is_home = 1;
+      delete [] this->home_map;
+      this->home_map = NULL;
+    }
 #endif
   }
 
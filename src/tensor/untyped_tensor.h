@@ -15,6 +15,7 @@ namespace CTF {
 }
 
 namespace CTF_int {
+  class redist_request;
 
   /** \brief internal distributed tensor class */
   class tensor {
@@ -125,12 +126,18 @@ namespace CTF_int {
       bool is_home;
       /** \brief whether the tensor left home to transpose */
       bool left_home_transp;
+      /** \brief mapping of the home distribution if the tensor lazily left home (NULL otherwise) */
+      mapping * home_map;
+      /** \brief topology of the home distribution if the tensor lazily left home */
+      topology * home_topo;
       /** \brief whether profiling should be done for contractions/sums involving this tensor */
       bool profile;
       /** \brief whether only the non-zero elements of the tensor are stored */
       bool is_sparse;
       /** \brief whether CSR or COO if folded */
       bool is_csr;
+      /** \brief whether CSF (overrides is_csr) if folded */
+      bool is_csf;
       /** \brief how many modes are folded into matricized row */
       int nrow_idx;
       /** \brief number of local nonzero elements */
@@ -139,6 +146,8 @@ namespace CTF_int {
       int64_t nnz_tot;
       /** \brief nonzero elements in each block owned locally */
       int64_t * nnz_blk;
+      /** \brief outstanding asynchronous redistribution of the tensor data (NULL if none) */
+      redist_request * pending_redist;
 
       /**
        * \brief associated an index map with the tensor for future operation
@@ -280,6 +289,12 @@ namespace CTF_int {
        */
       void print_map(FILE * stream=stdout, bool allcall=1) const;
 
+      /**
+       * \brief returns the mapping as a string, e.g. A[p2(0)v2,1], in which each index is mapped to np
+       *        processes along a processor grid dimension (pnp(dim)) and/or virtualized (vnv)
+       */
+      std::string get_map_str() const;
+
       /**
        * \brief set the tensor name
        * \param[in] name to set
@@ -702,6 +717,19 @@ namespace CTF_int {
                        int const *  new_offsets = NULL,
                        int * const * new_permutation = NULL);
 
+      /**
+       * \brief starts permuting the data of a tensor to its new layout without
+       *        waiting for communication to complete, the data is unavailable
+       *        until wait_redistribute() is called (done implicitly by operations on the tensor)
+       * \param[in] old_dist previous distribution to remap data from
+       * \return handle of outstanding redistribution (owned by tensor),
+       *         or NULL if the redistribution was done synchronously
+       */
+      redist_request * redistribute_async(distribution const & old_dist);
+
+      /** \brief completes outstanding asynchronous redistribution, if any */
+      void wait_redistribute();
+
       double est_redist_time(distribution const & old_dist, double nnz_frac);
 
       int64_t get_redist_mem(distribution const & old_dist, double nnz_frac);
@@ -746,21 +774,36 @@ namespace CTF_int {
        * \param[in] n number of columns in matrix
        * \param[in] nrow_idx number of indices to fold into column
        * \param[in] csr whether to do csr (1) or coo (0) layout
+       * \param[in] csf whether to do csf layout instead, which requires the key-value pairs of each block to be sorted
        */
-      void spmatricize(int m, int n, int nrow_idx, bool csr);
+      void spmatricize(int m, int n, int nrow_idx, bool csr, bool csf=false);
 
       /**
        * \brief transposes back local data from sparse matrix format to key-value pair format
        * \param[in] nrow_idx number of indices to fold into column
        * \param[in] csr whether to go from csr (1) or coo (0) layout
+       * \param[in] csf whether to go from csf layout instead
        */
-      void despmatricize(int nrow_idx, bool csr);
+      void despmatricize(int nrow_idx, bool csr, bool csf=false);
 
       /**
        * \brief degister home buffer
        */
       void leave_home_with_buffer();
 
+      /**
+       * \brief leaves home without moving data back, adopting the mapping and data
+       *        buffer of other, home mapping is recorded so go_home() can restore it
+       * \param[in] other tensor clone that left home, whose data is now owned by this tensor
+       */
+      void leave_home_lazily(tensor * other);
+
+      /**
+       * \brief redistributes tensor back to its home mapping and buffer
+       *        if it lazily left home, otherwise does nothing
+       */
+      void go_home();
+
       /**
         * \brief register buffer allocation for this tensor
         */
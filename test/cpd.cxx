@@ -0,0 +1,129 @@
+/** \addtogroup tests
+  * @{
+  * \defgroup cpd cpd
+  * @{
+  * \brief MTTKRP of dense and sparse tensors and CP decomposition by alternating least squares
+  */
+
+#include <ctf.hpp>
+using namespace CTF;
+
+int cpd(int     n,
+        World & dw){
+  int r = std::max(2, n/2);
+  int lens[] = {n+2, n, n+1};
+  srand48(dw.rank*13);
+
+  std::vector< Matrix<> > F;
+  for (int i=0; i<3; i++){
+    F.push_back(Matrix<>(lens[i], r, dw));
+    F[i].fill_random(-1.,1.);
+  }
+
+  // exact rank-r tensor and a sparse copy of a perturbation of it
+  Tensor<> T(3, lens, dw);
+  T["ijk"] = F[0]["ir"]*F[1]["jr"]*F[2]["kr"];
+  int sym[] = {NS, NS, NS};
+  Tensor<> Ts(3, true, lens, sym, dw);
+  Ts.fill_sp_random(-1., 1., .3);
+  Tensor<> Td(3, lens, dw);
+  Td["ijk"] = Ts["ijk"];
+
+  bool pass = true;
+  // MTTKRP against an explicit contraction, for each mode and for dense and sparse tensors
+  for (int mode=0; mode<3; mode++){
+    Matrix<> M(lens[mode], r, dw);
+    Matrix<> Ms(lens[mode], r, dw);
+    Matrix<> Mr(lens[mode], r, dw);
+    MTTKRP(Td, F, mode, M);
+    MTTKRP(Ts, F, mode, Ms);
+    char tidx[] = "ijk";
+    char midx[] = {tidx[mode], 'r', '\0'};
+    char f0[] = "ir", f1[] = "jr", f2[] = "kr";
+    char const * fidx[] = {f0, f1, f2};
+    int a = (mode+1)%3, b = (mode+2)%3;
+    Mr[midx] = Td[tidx]*F[a][fidx[a]]*F[b][fidx[b]];
+    double nrm = Mr.norm2();
+    M[midx] -= Mr[midx];
+    Ms[midx] -= Mr[midx];
+    pass = pass & (M.norm2() <= 1.E-10*nrm) & (Ms.norm2() <= 1.E-10*nrm);
+  }
+
+  // ALS recovers an exact low-rank tensor, restarting from another random guess if it stalls in a swamp
+  bool rec = false;
+  for (int t=0; t<4 && !rec; t++){
+    CPD<double> cp(T, r, 200, 1.E-12);
+    Tensor<> T2(3, lens, dw);
+    T2["ijk"] = cp["ijk"];
+    T2["ijk"] -= T["ijk"];
+    rec = T2.norm2() <= 1.E-3*T.norm2();
+  }
+  pass = pass & rec;
+
+  // ALS sweeps on sparse and dense copies of a tensor agree
+  CPD<double> cp_d(3, lens, r, dw);
+  CPD<double> cp_s(3, lens, r, dw);
+  for (int i=0; i<3; i++){
+    cp_s.factor_matrices[i]["ir"] = cp_d.factor_matrices[i]["ir"];
+  }
+  double fit_d = cp_d.als(Td, 5, 0.);
+  double fit_s = cp_s.als(Ts, 5, 0.);
+  pass = pass & (std::abs(fit_d - fit_s) <= 1.E-8);
+
+  int ipass = pass;
+  MPI_Allreduce(MPI_IN_PLACE, &ipass, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+  if (dw.rank == 0){
+    if (ipass)
+      printf("{ M = MTTKRP(T, U) and T ~= CPD(T) via ALS } passed\n");
+    else
+      printf("{ M = MTTKRP(T, U) and T ~= CPD(T) via ALS } failed\n");
+  }
+  return ipass;
+}
+
+
+#ifndef TEST_SUITE
+char* getCmdOption(char ** begin,
+                   char ** end,
+                   const   std::string & option){
+  char ** itr = std::find(begin, end, option);
+  if (itr != end && ++itr != end){
+    return *itr;
+  }
+  return 0;
+}
+
+
+int main(int argc, char ** argv){
+  int rank, np, n, pass;
+  int const in_num = argc;
+  char ** input_str = argv;
+
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &np);
+
+  if (getCmdOption(input_str, input_str+in_num, "-n")){
+    n = atoi(getCmdOption(input_str, input_str+in_num, "-n"));
+    if (n < 0) n = 6;
+  } else n = 6;
+
+  {
+    World dw(argc, argv);
+
+    if (rank == 0){
+      printf("Testing MTTKRP and CP-ALS with n = %d\n", n);
+    }
+    pass = cpd(n, dw);
+    assert(pass);
+  }
+
+  MPI_Finalize();
+  return 0;
+}
+/**
+ * @}
+ * @}
+ */
+
+#endif
@@ -0,0 +1,119 @@
+/** \addtogroup tests
+  * @{
+  * \defgroup csf csf
+  * @{
+  * \brief Contractions of higher-order sparse tensors with dense tensors, which store the sparse operand as compressed sparse fibers
+  */
+
+#include <ctf.hpp>
+using namespace CTF;
+
+int csf(int     n,
+        World & dw){
+  int lens_A[] = {n, n+1, n+2, 1};
+  int lens_B[] = {n+2, 1, 3};
+  int sym[] = {NS, NS, NS, NS};
+
+  srand48(dw.rank*17);
+  Tensor<> A(4, true, lens_A, sym, dw);
+  A.fill_sp_random(-1., 1., .05);
+  Tensor<> Ad(4, lens_A, sym, dw);
+  Ad["ijkl"] = A["ijkl"];
+  Tensor<> B(3, lens_B, sym, dw);
+  B.fill_random(-1., 1.);
+  Matrix<> D(n+1, 4, dw);
+  D.fill_random(-1., 1.);
+
+  bool pass = true;
+  // contracted modes at the leaves of the fiber tree
+  {
+    int lens_C[] = {n, n+1, 3};
+    Tensor<> C(3, lens_C, sym, dw);
+    Tensor<> Cd(3, lens_C, sym, dw);
+    C["ijm"] = A["ijkl"]*B["klm"];
+    Cd["ijm"] = Ad["ijkl"]*B["klm"];
+    Cd["ijm"] -= C["ijm"];
+    pass = pass & (Cd.norm2() <= 1.E-10*n*n);
+  }
+  // contracted mode in the middle of the fiber tree
+  {
+    int lens_C[] = {n, n+2, 4};
+    Tensor<> C(3, lens_C, sym, dw);
+    Tensor<> Cd(3, lens_C, sym, dw);
+    C.fill_random(-1., 1.);
+    Cd["ikm"] = C["ikm"];
+    C["ikm"] += 2.*A["ijkl"]*D["jm"];
+    Cd["ikm"] += 2.*Ad["ijkl"]*D["jm"];
+    Cd["ikm"] -= C["ikm"];
+    pass = pass & (Cd.norm2() <= 1.E-10*n*n);
+  }
+  // all modes of A are uncontracted rows
+  {
+    int lens_C[] = {n, n+1, n+2, 5};
+    Vector<> v(5, dw);
+    v.fill_random(-1., 1.);
+    Tensor<> C(4, lens_C, sym, dw);
+    Tensor<> Cd(4, lens_C, sym, dw);
+    C["ijkm"] = A["ijkl"]*v["m"];
+    Cd["ijkm"] = Ad["ijkl"]*v["m"];
+    Cd["ijkm"] -= C["ijkm"];
+    pass = pass & (Cd.norm2() <= 1.E-10*n*n);
+  }
+
+  int ipass = pass;
+  MPI_Allreduce(MPI_IN_PLACE, &ipass, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+  if (dw.rank == 0){
+    if (ipass)
+      printf("{ C[\"...\"] = A[\"...\"]*B[\"...\"] with higher-order sparse A } passed\n");
+    else
+      printf("{ C[\"...\"] = A[\"...\"]*B[\"...\"] with higher-order sparse A } failed\n");
+  }
+  return ipass;
+}
+
+
+#ifndef TEST_SUITE
+char* getCmdOption(char ** begin,
+                   char ** end,
+                   const   std::string & option){
+  char ** itr = std::find(begin, end, option);
+  if (itr != end && ++itr != end){
+    return *itr;
+  }
+  return 0;
+}
+
+
+int main(int argc, char ** argv){
+  int rank, np, n, pass;
+  int const in_num = argc;
+  char ** input_str = argv;
+
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &np);
+
+  if (getCmdOption(input_str, input_str+in_num, "-n")){
+    n = atoi(getCmdOption(input_str, input_str+in_num, "-n"));
+    if (n < 0) n = 9;
+  } else n = 9;
+
+  {
+    World dw(argc, argv);
+
+    if (rank == 0){
+      printf("Contracting higher-order sparse tensors in CSF layout with n = %d\n", n);
+    }
+    pass = csf(n, dw);
+    assert(pass);
+  }
+
+  MPI_Finalize();
+  return 0;
+}
+/**
+ * @}
+ * @}
+ */
+
+#endif
@@ -0,0 +1,120 @@
+/** \addtogroup tests
+  * @{
+  * \defgroup ctr_layers ctr_layers
+  * @{
+  * \brief Matrix multiplications of shapes for which 2D, 2.5D, and 3D mappings compete, checked against a local product
+  */
+
+#include <ctf.hpp>
+#include <cfloat>
+using namespace CTF;
+
+bool ctr_layers_gemm(int     m,
+                     int     k,
+                     int     n,
+                     World & dw){
+  Matrix<> A(m, k, NS, dw);
+  Matrix<> B(k, n, NS, dw);
+  Matrix<> C(m, n, NS, dw);
+  A.fill_random(-1.,1.);
+  B.fill_random(-1.,1.);
+  C.fill_random(-1.,1.);
+
+  // estimating the time selects a mapping but must not move or change the tensors
+  double est = C.estimate_time(A, "ik", B, "kj", "ij");
+  bool pass = est > 0. && est < DBL_MAX;
+
+  int64_t na, nb, nc;
+  double * a, * b, * c;
+  A.read_all(&na, &a);
+  B.read_all(&nb, &b);
+  C.read_all(&nc, &c);
+
+  C["ij"] *= 3.;
+  C["ij"] += 2.*A["ik"]*B["kj"];
+
+  double * c2;
+  C.read_all(&nc, &c2);
+  for (int j=0; j<n; j++){
+    for (int i=0; i<m; i++){
+      double s = 3.*c[i+j*m];
+      for (int l=0; l<k; l++){
+        s += 2.*a[i+l*m]*b[l+j*k];
+      }
+      if (fabs(s-c2[i+j*m]) > 1.E-10*(k+1)) pass = false;
+    }
+  }
+  free(a);
+  free(b);
+  free(c);
+  free(c2);
+  return pass;
+}
+
+int ctr_layers(int     n,
+               World & dw){
+  srand48(dw.rank*7);
+
+  int pass = 1;
+  // square, contraction-dominated (favors replicating C), and outer-product-like (favors replicating A and B)
+  pass &= ctr_layers_gemm(n*n, n*n, n*n, dw);
+  pass &= ctr_layers_gemm(n, n*n*n, n+1, dw);
+  pass &= ctr_layers_gemm(n*n*n, 2, n*n+1, dw);
+  pass &= ctr_layers_gemm(1, n*n, n, dw);
+
+  MPI_Allreduce(MPI_IN_PLACE, &pass, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+  if (dw.rank == 0){
+    if (pass)
+      printf("{ C[\"ij\"] = 2*A[\"ik\"]*B[\"kj\"] + 3*C[\"ij\"] with 2D, 2.5D, and 3D mappings } passed \n");
+    else
+      printf("{ C[\"ij\"] = 2*A[\"ik\"]*B[\"kj\"] + 3*C[\"ij\"] with 2D, 2.5D, and 3D mappings } failed \n");
+  }
+  return pass;
+}
+
+
+#ifndef TEST_SUITE
+char* getCmdOption(char ** begin,
+                   char ** end,
+                   const   std::string & option){
+  char ** itr = std::find(begin, end, option);
+  if (itr != end && ++itr != end){
+    return *itr;
+  }
+  return 0;
+}
+
+
+int main(int argc, char ** argv){
+  int rank, np, n, pass;
+  int const in_num = argc;
+  char ** input_str = argv;
+
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &np);
+
+  if (getCmdOption(input_str, input_str+in_num, "-n")){
+    n = atoi(getCmdOption(input_str, input_str+in_num, "-n"));
+    if (n < 0) n = 6;
+  } else n = 6;
+
+  {
+    World dw(argc, argv);
+
+    if (rank == 0){
+      printf("Testing matrix multiplication with layered mappings with n = %d\n", n);
+    }
+    pass = ctr_layers(n, dw);
+    assert(pass);
+  }
+
+  MPI_Finalize();
+  return 0;
+}
+/**
+ * @}
+ * @}
+ */
+
+#endif
@@ -0,0 +1,131 @@
+/** \addtogroup tests
+  * @{
+  * \defgroup ctr_report ctr_report
+  * @{
+  * \brief Reports of the mapping, predicted and measured times, and memory of contractions
+  */
+
+#include <ctf.hpp>
+using namespace CTF;
+
+/** \brief returns whether the braces and brackets of a JSON string outside of string literals are balanced */
+bool ctr_report_json_balanced(std::string const & s){
+  std::vector<char> st;
+  bool in_str = false;
+  for (int i=0; i<(int)s.size(); i++){
+    if (in_str){
+      if (s[i] == '\\') i++;
+      else if (s[i] == '"') in_str = false;
+    } else if (s[i] == '"') in_str = true;
+    else if (s[i] == '{' || s[i] == '[') st.push_back(s[i]);
+    else if (s[i] == '}' || s[i] == ']'){
+      if (st.size() == 0 || st.back() != (s[i] == '}' ? '{' : '[')) return false;
+      st.pop_back();
+    }
+  }
+  return !in_str && st.size() == 0;
+}
+
+int ctr_report(int     n,
+               World & dw){
+  int pass = 1;
+  Matrix<> A(n, n+1, dw, "A");
+  Matrix<> B(n+1, n+2, dw, "B");
+  Matrix<> C(n, n+2, dw, "C");
+  Matrix<> S(n+1, n+1, SP, dw, "S");
+  A.fill_random(-1., 1.);
+  B.fill_random(-1., 1.);
+  S.fill_sp_random(-1., 1., .2);
+
+  // not recorded
+  C["ij"] += A["ik"]*B["kj"];
+
+  start_contraction_reports();
+  C["ij"] += A["ik"]*B["kj"];
+  C["ij"] += B["kj"]*A["ik"];
+  C["ij"] += A["il"]*S["lk"]*B["kj"];
+  std::vector<Contraction_Report> reps = stop_contraction_reports();
+
+  C["ij"] += A["ik"]*B["kj"];
+  pass &= stop_contraction_reports().size() == 0;
+
+  pass &= reps.size() == 4;
+  for (int r=0; r<(int)reps.size(); r++){
+    Contraction_Report const & rep = reps[r];
+    pass &= rep.term.size() > 0 && rep.map_A.size() > 0 && rep.map_B.size() > 0 && rep.map_C.size() > 0;
+    pass &= rep.layers.size() > 0;
+    pass &= rep.tot_time >= rep.ctr_time && rep.ctr_time >= 0.0 && rep.map_time >= 0.0 && rep.redist_time >= 0.0;
+    pass &= rep.est_time > 0.0 && rep.mem_est >= 0;
+    pass &= rep.redist_bytes[0] >= 0 && rep.redist_bytes[1] >= 0 && rep.redist_bytes[2] >= 0;
+    for (int l=0; l<(int)rep.layers.size(); l++){
+      pass &= rep.layers[l].nrun >= 1 && rep.layers[l].exe_time >= 0.0 && rep.layers[l].est_time >= 0.0;
+      // layers include the ones below them
+      if (l > 0) pass &= rep.layers[l].exe_time <= rep.layers[l-1].exe_time + 1.E-3;
+    }
+    std::string json = rep.to_json();
+    pass &= json.size() > 2 && json[0] == '{' && json[json.size()-1] == '}';
+    pass &= json.find("\"layers\":[") != std::string::npos;
+    pass &= ctr_report_json_balanced(json);
+  }
+  if (reps.size() == 4){
+    pass &= reps[0].term == "C[ac]+=A[ab]*B[bc]";
+    pass &= reps[0].layers[reps[0].layers.size()-1].name == "seq_tsr_ctr";
+    pass &= reps[0].flops > 0;
+  }
+
+  MPI_Allreduce(MPI_IN_PLACE, &pass, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+  if (dw.rank == 0){
+    if (pass)
+      printf("{ reports of C[\"ij\"] += A[\"ik\"]*B[\"kj\"] } passed \n");
+    else
+      printf("{ reports of C[\"ij\"] += A[\"ik\"]*B[\"kj\"] } failed \n");
+  }
+  return pass;
+}
+
+
+#ifndef TEST_SUITE
+char* getCmdOption(char ** begin,
+                   char ** end,
+                   const   std::string & option){
+  char ** itr = std::find(begin, end, option);
+  if (itr != end && ++itr != end){
+    return *itr;
+  }
+  return 0;
+}
+
+
+int main(int argc, char ** argv){
+  int rank, np, n, pass;
+  int const in_num = argc;
+  char ** input_str = argv;
+
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &np);
+
+  if (getCmdOption(input_str, input_str+in_num, "-n")){
+    n = atoi(getCmdOption(input_str, input_str+in_num, "-n"));
+    if (n < 0) n = 19;
+  } else n = 19;
+
+  {
+    World dw(argc, argv);
+
+    if (rank == 0){
+      printf("Testing contraction reports with n = %d\n", n);
+    }
+    pass = ctr_report(n, dw);
+    assert(pass);
+  }
+
+  MPI_Finalize();
+  return 0;
+}
+/**
+ * @}
+ * @}
+ */
+
+#endif
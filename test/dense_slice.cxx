@@ -0,0 +1,117 @@
+/** \addtogroup tests
+  * @{
+  * \defgroup dense_slice dense_slice
+  * @{
+  * \brief Checks slices of dense tensors with different layouts against slices read from a sparse copy
+  */
+
+#include <ctf.hpp>
+using namespace CTF;
+
+int dense_slice(int     n,
+                World & dw){
+
+  int lens_A[] = {n+3, n, n+1};
+  int lens_B[] = {n, 2*n, 1, n+2};
+  int sym[] = {NS, NS, NS, NS};
+
+  Tensor<> A(3, lens_A, sym, dw);
+  Tensor<> B1(4, lens_B, sym, dw);
+  Tensor<> B2(4, lens_B, sym, dw);
+
+  srand48(dw.rank*29);
+  A.fill_random(0.0,1.0);
+  B1.fill_random(0.0,1.0);
+  B2["ijkl"] = B1["ijkl"];
+
+  // slices read from a sparse tensor are moved as key-value pairs
+  Tensor<> As(A);
+  As.sparsify();
+
+  int pass = 1;
+
+  // modes of extent one are present only in A or only in B
+  int offsets_A[] = {2, 0, 1};
+  int ends_A[]    = {3, n, n+1};
+  int offsets_B[] = {0, 1, 0, 1};
+  int ends_B[]    = {n, 2, 1, n+1};
+  B1.slice(offsets_B, ends_B, 0.5, A, offsets_A, ends_A, 2.0);
+  B2.slice(offsets_B, ends_B, 0.5, As, offsets_A, ends_A, 2.0);
+  B1["ijkl"] -= B2["ijkl"];
+  if (B1.norm2() > 1.E-10*n) pass = 0;
+
+  // block of A accumulated back into a replicated tensor
+  if (dw.np % 2 == 0){
+    int plens[] = {2, dw.np/2};
+    Partition part(2, plens);
+    int lens_C[] = {n+3, n};
+    Tensor<> C1(2, lens_C, sym, dw, "ij", part["i"]);
+    Tensor<> C2(2, lens_C, sym, dw, "ij", part["i"]);
+    C1.fill_random(0.0,1.0);
+    C2["ij"] = C1["ij"];
+    int offsets_A2[] = {1, 2, n/2};
+    int ends_A2[]    = {n+2, n, n/2+1};
+    int offsets_C[]  = {2, 0};
+    int ends_C[]     = {n+3, n-2};
+    C1.slice(offsets_C, ends_C, 1.0, A, offsets_A2, ends_A2, -1.0);
+    C2.slice(offsets_C, ends_C, 1.0, As, offsets_A2, ends_A2, -1.0);
+    C1["ij"] -= C2["ij"];
+    if (C1.norm2() > 1.E-10*n) pass = 0;
+  }
+
+  MPI_Allreduce(MPI_IN_PLACE, &pass, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+  if (dw.rank == 0){
+    if (pass)
+      printf("{ B[offsets_B:ends_B] = beta*B[offsets_B:ends_B] + alpha*A[offsets_A:ends_A] } passed \n");
+    else
+      printf("{ B[offsets_B:ends_B] = beta*B[offsets_B:ends_B] + alpha*A[offsets_A:ends_A] } failed \n");
+  }
+  return pass;
+}
+
+
+#ifndef TEST_SUITE
+char* getCmdOption(char ** begin,
+                   char ** end,
+                   const   std::string & option){
+  char ** itr = std::find(begin, end, option);
+  if (itr != end && ++itr != end){
+    return *itr;
+  }
+  return 0;
+}
+
+
+int main(int argc, char ** argv){
+  int rank, np, n, pass;
+  int const in_num = argc;
+  char ** input_str = argv;
+
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &np);
+
+  if (getCmdOption(input_str, input_str+in_num, "-n")){
+    n = atoi(getCmdOption(input_str, input_str+in_num, "-n"));
+    if (n < 0) n = 7;
+  } else n = 7;
+
+  {
+    World dw(argc, argv);
+
+    if (rank == 0){
+      printf("Slicing dense tensors with n = %d\n", n);
+    }
+    pass = dense_slice(n, dw);
+    assert(pass);
+  }
+
+  MPI_Finalize();
+  return 0;
+}
+/**
+ * @}
+ * @}
+ */
+
+#endif
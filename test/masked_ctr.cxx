@@ -0,0 +1,151 @@
+/** \addtogroup tests
+  * @{
+  * \defgroup masked_ctr masked_ctr
+  * @{
+  * \brief Contractions computed only at the nonzeros (or zeros) of a mask, checked against full products weighted by the mask pattern
+  */
+
+#include <ctf.hpp>
+using namespace CTF;
+
+/** \brief returns whether C agrees with beta*C0 + alpha*P, weighted by the pattern W of the mask or by its complement */
+bool masked_ctr_cmp(Tensor<> & C, Tensor<> & C0, Tensor<> & P, Tensor<> & W, double alpha, double beta, bool complement){
+  char idx[C.order+1];
+  for (int i=0; i<C.order; i++) idx[i] = 'a'+i;
+  idx[C.order] = '\0';
+  int ns[C.order];
+  std::fill(ns, ns+C.order, NS);
+  Tensor<> R(C.order, C.lens, ns, *C.wrld);
+  Tensor<> V(C.order, C.lens, ns, *C.wrld);
+  V[idx] = W[idx];
+  if (complement){
+    V[idx] = -1.*V[idx];
+    V[idx] += 1.;
+  }
+  R[idx] = beta*C0[idx];
+  R[idx] += alpha*P[idx]*V[idx];
+  double nrm = R.norm2();
+  R[idx] -= C[idx];
+  return R.norm2() <= 1.E-10*(nrm+1.);
+}
+
+int masked_ctr(int     n,
+               World & dw){
+  int pass = 1;
+  int m = n+3;
+  int r = 5;
+
+  for (int cmp=0; cmp<2; cmp++){
+    // sampled dense-dense product
+    {
+      Matrix<> A(m, r, NS, dw), B(r, n, NS, dw), C(m, n, NS, dw), M(m, n, SP, dw);
+      A.fill_random(-1.,1.);
+      B.fill_random(-1.,1.);
+      C.fill_random(-1.,1.);
+      M.fill_sp_random(1.,1.,.2);
+      Matrix<> C0(C), P(m, n, NS, dw);
+      P["ij"] = A["ik"]*B["kj"];
+      C.contract(2., A, "ik", B, "kj", .5, "ij", M, cmp);
+      pass &= masked_ctr_cmp(C, C0, P, M, 2., .5, cmp);
+    }
+
+    // sampled product with an index shared by both operands and the output, written to a sparse output
+    {
+      int lA[] = {m, r, 3}, lB[] = {r, n, 3}, lC[] = {m, n, 3};
+      int ns[] = {NS, NS, NS};
+      Tensor<> A(3, lA, ns, dw), B(3, lB, ns, dw), M(3, lC, ns, dw);
+      Tensor<> Cs(3, true, lC, ns, dw), Ms(3, true, lC, ns, dw);
+      A.fill_random(-1.,1.);
+      B.fill_random(-1.,1.);
+      // the mask is given as a dense tensor here
+      Ms.fill_sp_random(1.,1.,.3);
+      M["ijb"] = Ms["ijb"];
+      Tensor<> C0(Cs), P(3, lC, ns, dw);
+      P["ijb"] = A["ikb"]*B["kjb"];
+      Cs.contract(1., A, "ikb", B, "kjb", 0., "ijb", M, cmp);
+      pass &= masked_ctr_cmp(Cs, C0, P, M, 1., 0., cmp);
+    }
+
+    // masked sparse matrix times dense vector
+    {
+      Matrix<> A(n*n, n*n, SP, dw);
+      Vector<> x(n*n, dw), v(n*n, dw), w(n*n, SP, dw);
+      A.fill_sp_random(-1.,1.,.1);
+      x.fill_random(-1.,1.);
+      v.fill_random(-1.,1.);
+      w.fill_sp_random(1.,1.,.3);
+      Vector<> v0(v), P(n*n, dw);
+      P["i"] = A["ij"]*x["j"];
+      v.contract(1., A, "ij", x, "j", 1., "i", w, cmp);
+      pass &= masked_ctr_cmp(v, v0, P, w, 1., 1., cmp);
+    }
+
+    // masked sparse matrix times sparse matrix
+    {
+      Matrix<> A(n*n, n*n, SP, dw), B(n*n, n*n, SP, dw), C(n*n, n*n, SP, dw), M(n*n, n*n, SP, dw);
+      A.fill_sp_random(-1.,1.,.1);
+      B.fill_sp_random(-1.,1.,.1);
+      M.fill_sp_random(1.,1.,.1);
+      Matrix<> C0(C), P(n*n, n*n, NS, dw);
+      P["ij"] = A["ik"]*B["kj"];
+      C.contract(1., A, "ik", B, "kj", 0., "ij", M, cmp);
+      pass &= masked_ctr_cmp(C, C0, P, M, 1., 0., cmp);
+    }
+  }
+
+  MPI_Allreduce(MPI_IN_PLACE, &pass, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+  if (dw.rank == 0){
+    if (pass)
+      printf("{ C[\"ij\"] = mask(M[\"ij\"])*A[\"ik\"]*B[\"kj\"] with dense and sparse operands } passed \n");
+    else
+      printf("{ C[\"ij\"] = mask(M[\"ij\"])*A[\"ik\"]*B[\"kj\"] with dense and sparse operands } failed \n");
+  }
+  return pass;
+}
+
+
+#ifndef TEST_SUITE
+char* getCmdOption(char ** begin,
+                   char ** end,
+                   const   std::string & option){
+  char ** itr = std::find(begin, end, option);
+  if (itr != end && ++itr != end){
+    return *itr;
+  }
+  return 0;
+}
+
+
+int main(int argc, char ** argv){
+  int rank, np, n, pass;
+  int const in_num = argc;
+  char ** input_str = argv;
+
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &np);
+
+  if (getCmdOption(input_str, input_str+in_num, "-n")){
+    n = atoi(getCmdOption(input_str, input_str+in_num, "-n"));
+    if (n < 0) n = 7;
+  } else n = 7;
+
+  {
+    World dw(argc, argv);
+
+    if (rank == 0){
+      printf("Testing masked contractions with n = %d\n", n);
+    }
+    pass = masked_ctr(n, dw);
+    assert(pass);
+  }
+
+  MPI_Finalize();
+  return 0;
+}
+/**
+ * @}
+ * @}
+ */
+
+#endif
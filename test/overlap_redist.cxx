@@ -0,0 +1,102 @@
+/** \addtogroup tests
+  * @{
+  * \defgroup overlap_redist overlap_redist
+  * @{
+  * \brief Checks sums of contraction terms, for which operand redistributions are overlapped with preceding terms
+  */
+
+#include <ctf.hpp>
+using namespace CTF;
+
+int overlap_redist(int     n,
+                   World & dw){
+
+  int lens[] = {n, n, n, n};
+  int lens_rect[] = {n, n+1, n+2, n};
+  int shape[] = {NS, NS, NS, NS};
+
+  Tensor<> A(4, lens, shape, dw);
+  Tensor<> B(4, lens, shape, dw);
+  Tensor<> D(4, lens_rect, shape, dw);
+  Tensor<> E(4, lens_rect, shape, dw);
+  Tensor<> F(4, lens, shape, dw);
+  Tensor<> G(4, lens, shape, dw);
+  Tensor<> C1(4, lens, shape, dw);
+  Tensor<> C2(4, lens, shape, dw);
+
+  srand48(dw.rank*13);
+  A.fill_random(0.0,1.0);
+  B.fill_random(0.0,1.0);
+  D.fill_random(0.0,1.0);
+  E.fill_random(0.0,1.0);
+  F.fill_random(0.0,1.0);
+  G.fill_random(0.0,1.0);
+
+  // operands of each term are remapped while the preceding term executes
+  C1["ijkl"] = A["ijmn"]*B["mnkl"] + D["imnj"]*E["kmnl"] + F["imkn"]*G["njml"] + A["ijmn"]*B["mnkl"];
+
+  C2["ijkl"]  = A["ijmn"]*B["mnkl"];
+  C2["ijkl"] += D["imnj"]*E["kmnl"];
+  C2["ijkl"] += F["imkn"]*G["njml"];
+  C2["ijkl"] += A["ijmn"]*B["mnkl"];
+
+  C1["ijkl"] -= C2["ijkl"];
+  double nrm = C1.norm2();
+
+  int pass = (nrm < 1.E-9*n*n*n*n);
+  MPI_Allreduce(MPI_IN_PLACE, &pass, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+  if (dw.rank == 0){
+    if (pass)
+      printf("{ C[\"ijkl\"] = A[\"ijmn\"]*B[\"mnkl\"] + D[\"imnj\"]*E[\"kmnl\"] + ... } passed \n");
+    else
+      printf("{ C[\"ijkl\"] = A[\"ijmn\"]*B[\"mnkl\"] + D[\"imnj\"]*E[\"kmnl\"] + ... } failed \n");
+  }
+  return pass;
+}
+
+
+#ifndef TEST_SUITE
+char* getCmdOption(char ** begin,
+                   char ** end,
+                   const   std::string & option){
+  char ** itr = std::find(begin, end, option);
+  if (itr != end && ++itr != end){
+    return *itr;
+  }
+  return 0;
+}
+
+
+int main(int argc, char ** argv){
+  int rank, np, n, pass;
+  int const in_num = argc;
+  char ** input_str = argv;
+
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &np);
+
+  if (getCmdOption(input_str, input_str+in_num, "-n")){
+    n = atoi(getCmdOption(input_str, input_str+in_num, "-n"));
+    if (n < 0) n = 6;
+  } else n = 6;
+
+  {
+    World dw(argc, argv);
+
+    if (rank == 0){
+      printf("Computing sum of tensor contractions with overlapped operand redistribution, n = %d\n", n);
+    }
+    pass = overlap_redist(n, dw);
+    assert(pass);
+  }
+
+  MPI_Finalize();
+  return 0;
+}
+/**
+ * @}
+ * @}
+ */
+
+#endif
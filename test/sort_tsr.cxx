@@ -0,0 +1,148 @@
+/** \addtogroup tests
+  * @{
+  * \defgroup sort_tsr sort_tsr
+  * @{
+  * \brief Distributed sort, top-k and argmax of tensor values, checked against sorting all values on every process
+  */
+
+#include <ctf.hpp>
+using namespace CTF;
+
+/** \brief returns whether the distributed sort of T matches its values sorted by (value, index) */
+template<typename dtype>
+bool sort_tsr_check(Tensor<dtype> & T, bool nonzeros_only){
+  World & dw = *T.wrld;
+  int64_t n, nall;
+  int64_t * inds;
+  dtype * vals, * all;
+  T.sort(&n, &inds, &vals, nonzeros_only);
+  T.read_all(&nall, &all, true);
+  std::vector< std::pair<dtype,int64_t> > ref;
+  for (int64_t i=0; i<nall; i++){
+    if (!nonzeros_only || all[i] != (dtype)0) ref.push_back(std::make_pair(all[i], i));
+  }
+  std::sort(ref.begin(), ref.end());
+
+  // position of the local block in the global order
+  int64_t off = 0;
+  MPI_Exscan(&n, &off, 1, MPI_INT64_T, MPI_SUM, dw.comm);
+  if (dw.rank == 0) off = 0;
+  int pass = 1;
+  for (int64_t i=0; i<n; i++){
+    if (off+i >= (int64_t)ref.size() || ref[off+i].first != vals[i] || ref[off+i].second != inds[i]) pass = 0;
+  }
+  int64_t ntot = n;
+  MPI_Allreduce(MPI_IN_PLACE, &ntot, 1, MPI_INT64_T, MPI_SUM, dw.comm);
+  if (ntot != (int64_t)ref.size()) pass = 0;
+
+  // top-k and argmax
+  int64_t k = std::min((int64_t)7, (int64_t)ref.size()+2);
+  int64_t * tinds = (int64_t*)malloc(sizeof(int64_t)*k);
+  dtype * tvals = (dtype*)malloc(sizeof(dtype)*k);
+  int64_t nt = T.topk(k, tinds, tvals);
+  if (!nonzeros_only){
+    std::sort(ref.begin(), ref.end(), [](std::pair<dtype,int64_t> const & a, std::pair<dtype,int64_t> const & b){
+      return a.first > b.first || (a.first == b.first && a.second < b.second);
+    });
+    if (nt != std::min(k, (int64_t)ref.size())) pass = 0;
+    for (int64_t i=0; i<nt; i++){
+      if (ref[i].first != tvals[i] || ref[i].second != tinds[i]) pass = 0;
+    }
+    dtype mx;
+    if (T.argmax(&mx) != ref[0].second || mx != ref[0].first) pass = 0;
+  }
+  free(tvals);
+  free(tinds);
+  free(inds);
+  delete [] vals;
+  free(all);
+  MPI_Allreduce(MPI_IN_PLACE, &pass, 1, MPI_INT, MPI_MIN, dw.comm);
+  return pass;
+}
+
+int sort_tsr(int     n,
+             World & dw){
+  int pass = 1;
+  srand48(dw.rank*7+1);
+
+  Vector<> v(n*n, dw);
+  v.fill_random(-1., 1.);
+  pass &= sort_tsr_check(v, false);
+
+  // many ties, which are ordered by index
+  int lens[] = {n, n+1, 3};
+  Tensor<int> T(3, lens, dw);
+  T.fill_random(-2, 2);
+  pass &= sort_tsr_check(T, false);
+  pass &= sort_tsr_check(T, true);
+
+  Matrix<> S(n, n, SP, dw);
+  S.fill_sp_random(-1., 1., .2);
+  pass &= sort_tsr_check(S, true);
+
+  Vector<> e(n, dw);
+  e.fill_random(-1., 1.);
+  double mabs[3], * ev;
+  int64_t ne;
+  e.read_all(&ne, &ev);
+  std::sort(ev, ev+ne, [](double a, double b){ return std::abs(a) > std::abs(b); });
+  e.get_max_abs(3, mabs);
+  for (int i=0; i<std::min(3,n); i++) pass &= mabs[i] == ev[i];
+  free(ev);
+
+  MPI_Allreduce(MPI_IN_PLACE, &pass, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+  if (dw.rank == 0){
+    if (pass)
+      printf("{ sort(T), topk(T), argmax(T) } passed \n");
+    else
+      printf("{ sort(T), topk(T), argmax(T) } failed \n");
+  }
+  return pass;
+}
+
+
+#ifndef TEST_SUITE
+char* getCmdOption(char ** begin,
+                   char ** end,
+                   const   std::string & option){
+  char ** itr = std::find(begin, end, option);
+  if (itr != end && ++itr != end){
+    return *itr;
+  }
+  return 0;
+}
+
+
+int main(int argc, char ** argv){
+  int rank, np, n, pass;
+  int const in_num = argc;
+  char ** input_str = argv;
+
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &np);
+
+  if (getCmdOption(input_str, input_str+in_num, "-n")){
+    n = atoi(getCmdOption(input_str, input_str+in_num, "-n"));
+    if (n < 0) n = 17;
+  } else n = 17;
+
+  {
+    World dw(argc, argv);
+
+    if (rank == 0){
+      printf("Testing distributed sort of tensor values with n = %d\n", n);
+    }
+    pass = sort_tsr(n, dw);
+    assert(pass);
+  }
+
+  MPI_Finalize();
+  return 0;
+}
+/**
+ * @}
+ * @}
+ */
+
+#endif
@@ -0,0 +1,126 @@
+/** \addtogroup tests
+  * @{
+  * \defgroup sparse_redist sparse_redist
+  * @{
+  * \brief Redistributes and reads back sparse tensors whose keys span more than 32 bits
+  */
+
+#include <ctf.hpp>
+using namespace CTF;
+
+int sparse_redist(int     n,
+                  World & dw){
+
+  int sym[] = {NS, NS, NS, NS};
+  int lens_A[] = {1000*n, 999*n, 1001, 3};
+  int lens_B[] = {3, 1001, 999*n, 1000*n};
+  int64_t sz = ((int64_t)lens_A[0])*lens_A[1]*lens_A[2]*lens_A[3];
+
+  Tensor<> A(4, true, lens_A, sym, dw);
+  Tensor<> B(4, true, lens_B, sym, dw);
+
+  // each process writes a distinct set of nonzeros, clustered in runs of nearby keys and scattered across the range
+  int64_t nw = 50*n;
+  int64_t * keys = (int64_t*)malloc(sizeof(int64_t)*nw);
+  double * vals = (double*)malloc(sizeof(double)*nw);
+  int64_t nrun = 5;
+  for (int64_t i=0; i<nw; i++){
+    int64_t run = ((i/nrun)*dw.np + dw.rank)*7919;
+    keys[i] = ((run*1000003)%(sz/nrun))*nrun + i%nrun;
+    vals[i] = (double)(keys[i]%1009) + 1.;
+  }
+  A.write(nw, keys, vals);
+
+  // transposing the modes moves every pair to a different process and block
+  B["lkji"] = A["ijkl"];
+
+  // every process reads back the entries written by the next one
+  int64_t * rkeys = (int64_t*)malloc(sizeof(int64_t)*nw);
+  double * rvals = (double*)malloc(sizeof(double)*nw);
+  int nxt = (dw.rank+1)%dw.np;
+  for (int64_t i=0; i<nw; i++){
+    int64_t run = ((i/nrun)*dw.np + nxt)*7919;
+    int64_t k = ((run*1000003)%(sz/nrun))*nrun + i%nrun;
+    keys[i] = k;
+    vals[i] = (double)(k%1009) + 1.;
+    int64_t idx[4];
+    for (int j=0; j<4; j++){
+      idx[j] = k%lens_A[j];
+      k = k/lens_A[j];
+    }
+    rkeys[i] = idx[3] + lens_B[0]*(idx[2] + lens_B[1]*(idx[1] + lens_B[2]*idx[0]));
+  }
+
+  int pass = 1;
+  A.read(nw, keys, rvals);
+  for (int64_t i=0; i<nw; i++){
+    if (fabs(rvals[i]-vals[i]) > 1.E-10) pass = 0;
+  }
+  B.read(nw, rkeys, rvals);
+  for (int64_t i=0; i<nw; i++){
+    if (fabs(rvals[i]-vals[i]) > 1.E-10) pass = 0;
+  }
+  // a dot product would fold A into a single vector longer than int indices of the local sparse kernels allow
+  if (A.nnz_tot != B.nnz_tot || A.nnz_tot != nw*dw.np) pass = 0;
+
+  free(rvals);
+  free(rkeys);
+  free(vals);
+  free(keys);
+
+  MPI_Allreduce(MPI_IN_PLACE, &pass, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+  if (dw.rank == 0){
+    if (pass)
+      printf("{ B[\"lkji\"] = A[\"ijkl\"] with sparse A, B and keys beyond 32 bits } passed \n");
+    else
+      printf("{ B[\"lkji\"] = A[\"ijkl\"] with sparse A, B and keys beyond 32 bits } failed \n");
+  }
+  return pass;
+}
+
+
+#ifndef TEST_SUITE
+char* getCmdOption(char ** begin,
+                   char ** end,
+                   const   std::string & option){
+  char ** itr = std::find(begin, end, option);
+  if (itr != end && ++itr != end){
+    return *itr;
+  }
+  return 0;
+}
+
+
+int main(int argc, char ** argv){
+  int rank, np, n, pass;
+  int const in_num = argc;
+  char ** input_str = argv;
+
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &np);
+
+  if (getCmdOption(input_str, input_str+in_num, "-n")){
+    n = atoi(getCmdOption(input_str, input_str+in_num, "-n"));
+    if (n < 0) n = 7;
+  } else n = 7;
+
+  {
+    World dw(argc, argv);
+
+    if (rank == 0){
+      printf("Redistributing sparse tensors with n = %d\n", n);
+    }
+    pass = sparse_redist(n, dw);
+    assert(pass);
+  }
+
+  MPI_Finalize();
+  return 0;
+}
+/**
+ * @}
+ * @}
+ */
+
+#endif
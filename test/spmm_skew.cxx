@@ -0,0 +1,112 @@
+/** \addtogroup tests
+  * @{
+  * \defgroup spmm_skew spmm_skew
+  * @{
+  * \brief Products of a sparse matrix with power-law row lengths and dense matrices of various widths
+  */
+
+#include <ctf.hpp>
+using namespace CTF;
+
+int spmm_skew(int     n,
+              World & dw){
+  int m = n*n*n;
+  int k = n*n;
+
+  // row i has about k/(i+1) nonzeros, so a few leading rows hold most of them
+  Matrix<> A(m, k, SP, dw);
+  std::vector<int64_t> keys;
+  std::vector<double> vals;
+  if (dw.rank == 0){
+    for (int i=0; i<m; i++){
+      int nr = std::max(1, k/(i+1));
+      for (int j=0; j<nr; j++){
+        int col = (int)((((int64_t)j)*7919 + i) % k);
+        keys.push_back(i + ((int64_t)col)*m);
+        vals.push_back((double)((i+col)%13) - 6.);
+      }
+    }
+  }
+  A.write(keys.size(), keys.data(), vals.data());
+  Matrix<> Ad(m, k, NS, dw);
+  Ad["ij"] = A["ij"];
+
+  int pass = 1;
+  int widths[] = {1, 3, 8, 17};
+  for (int w=0; w<4; w++){
+    int nc = widths[w];
+    Matrix<> B(k, nc, NS, dw);
+    B.fill_random(-1.,1.);
+    Matrix<> C(m, nc, NS, dw);
+    Matrix<> Cd(m, nc, NS, dw);
+    Matrix<> Cf(m, nc, NS, dw);
+    C.fill_random(-1.,1.);
+    Cd["ij"] = C["ij"];
+    Cf["ij"] = C["ij"];
+
+    C["ij"] += 2.*A["ik"]*B["kj"];
+    Cd["ij"] += 2.*Ad["ik"]*B["kj"];
+    Cf["ij"] += Function<>([](double a, double b){ return 2.*a*b; })(A["ik"],B["kj"]);
+
+    double nrm = Cd.norm2();
+    C["ij"] -= Cd["ij"];
+    Cf["ij"] -= Cd["ij"];
+    if (C.norm2() > 1.E-10*nrm || Cf.norm2() > 1.E-10*nrm) pass = 0;
+  }
+
+  MPI_Allreduce(MPI_IN_PLACE, &pass, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+  if (dw.rank == 0){
+    if (pass)
+      printf("{ C[\"ij\"] += A[\"ik\"]*B[\"kj\"] with sparse A of power-law row lengths } passed \n");
+    else
+      printf("{ C[\"ij\"] += A[\"ik\"]*B[\"kj\"] with sparse A of power-law row lengths } failed \n");
+  }
+  return pass;
+}
+
+
+#ifndef TEST_SUITE
+char* getCmdOption(char ** begin,
+                   char ** end,
+                   const   std::string & option){
+  char ** itr = std::find(begin, end, option);
+  if (itr != end && ++itr != end){
+    return *itr;
+  }
+  return 0;
+}
+
+
+int main(int argc, char ** argv){
+  int rank, np, n, pass;
+  int const in_num = argc;
+  char ** input_str = argv;
+
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &np);
+
+  if (getCmdOption(input_str, input_str+in_num, "-n")){
+    n = atoi(getCmdOption(input_str, input_str+in_num, "-n"));
+    if (n < 0) n = 6;
+  } else n = 6;
+
+  {
+    World dw(argc, argv);
+
+    if (rank == 0){
+      printf("Multiplying sparse matrix with power-law row lengths by dense matrices with n = %d\n", n);
+    }
+    pass = spmm_skew(n, dw);
+    assert(pass);
+  }
+
+  MPI_Finalize();
+  return 0;
+}
+/**
+ * @}
+ * @}
+ */
+
+#endif
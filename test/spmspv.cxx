@@ -0,0 +1,143 @@
+/** \addtogroup tests
+  * @{
+  * \defgroup spmspv spmspv
+  * @{
+  * \brief Frontier multiplications of a sparse matrix by sparse vectors, pushed and pulled, checked against contractions
+  */
+
+#include <ctf.hpp>
+using namespace CTF;
+
+/** \brief returns whether all entries of two vectors agree to a relative tolerance */
+template<typename dtype>
+bool spmspv_cmp(Vector<dtype> & y, Vector<dtype> & z){
+  int64_t ny, nz;
+  dtype * vy, * vz;
+  y.read_all(&ny, &vy);
+  z.read_all(&nz, &vz);
+  bool pass = ny == nz;
+  for (int64_t i=0; pass && i<ny; i++){
+    pass = std::abs(vy[i]-vz[i]) <= 1.E-10*(std::abs(vz[i])+1.);
+  }
+  free(vy);
+  free(vz);
+  return pass;
+}
+
+int spmspv(int     n,
+           World & dw){
+  int pass = 1;
+  srand48(dw.rank*13+3);
+
+  Matrix<> A(n, n+2, SP, dw);
+  A.fill_sp_random(-1., 1., .2);
+  double costs[] = {0., 1.E300, 14.};
+
+  // frontier of a few vertices, with and without visited rows, forced to push, forced to pull and chosen
+  for (int c=0; c<3; c++){
+    SpMSpV<double> M(A, costs[c]);
+    for (int v=0; v<2; v++){
+      Vector<> x(n+2, SP, dw), vis(n, SP, dw), y(n, SP, dw);
+      x.fill_sp_random(-1., 1., .3);
+      vis.fill_sp_random(1., 2., .4);
+      y.fill_sp_random(-1., 1., .3);
+      Vector<> z(n, SP, dw);
+      z["i"] = y["i"];
+      if (v == 0){
+        M.multiply(x, y);
+        z["i"] += A["ij"]*x["j"];
+      } else {
+        M.multiply(x, y, &vis);
+        z.contract(1., A, "ij", x, "j", 1., "i", vis, true);
+      }
+      pass &= spmspv_cmp(y, z);
+      if (c < 2) pass &= M.pushed == (c == 0);
+    }
+  }
+
+  // dense frontier, which is pulled under the default cost
+  {
+    SpMSpV<double> M(A);
+    Vector<> x(n+2, dw), y(n, SP, dw), z(n, dw);
+    x.fill_random(-1., 1.);
+    M.multiply(x, y);
+    z["i"] += A["ij"]*x["j"];
+    pass &= spmspv_cmp(y, z);
+    pass &= !M.pushed;
+  }
+
+  // one step of shortest paths in the tropical semiring
+  {
+    Semiring<int> s(INT_MAX/2,
+                    [](int a, int b){ return std::min(a,b); },
+                    MPI_MIN,
+                    0,
+                    [](int a, int b){ return a+b; });
+    Matrix<int> W(n, n, SP, dw, s);
+    W.fill_sp_random(1, 10, .3);
+    for (int c=0; c<2; c++){
+      SpMSpV<int> M(W, costs[c]);
+      Vector<int> d(n, SP, dw, s), y(n, SP, dw, s), z(n, SP, dw, s);
+      d.fill_sp_random(0, 5, .3);
+      M.multiply(d, y);
+      z["i"] += W["ij"]*d["j"];
+      pass &= spmspv_cmp(y, z);
+    }
+  }
+
+  MPI_Allreduce(MPI_IN_PLACE, &pass, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+  if (dw.rank == 0){
+    if (pass)
+      printf("{ y[\"i\"] += A[\"ij\"]*x[\"j\"] pushed and pulled over unvisited rows } passed \n");
+    else
+      printf("{ y[\"i\"] += A[\"ij\"]*x[\"j\"] pushed and pulled over unvisited rows } failed \n");
+  }
+  return pass;
+}
+
+
+#ifndef TEST_SUITE
+char* getCmdOption(char ** begin,
+                   char ** end,
+                   const   std::string & option){
+  char ** itr = std::find(begin, end, option);
+  if (itr != end && ++itr != end){
+    return *itr;
+  }
+  return 0;
+}
+
+
+int main(int argc, char ** argv){
+  int rank, np, n, pass;
+  int const in_num = argc;
+  char ** input_str = argv;
+
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &np);
+
+  if (getCmdOption(input_str, input_str+in_num, "-n")){
+    n = atoi(getCmdOption(input_str, input_str+in_num, "-n"));
+    if (n < 0) n = 23;
+  } else n = 23;
+
+  {
+    World dw(argc, argv);
+
+    if (rank == 0){
+      printf("Testing sparse matrix times sparse vector with n = %d\n", n);
+    }
+    pass = spmspv(n, dw);
+    assert(pass);
+  }
+
+  MPI_Finalize();
+  return 0;
+}
+/**
+ * @}
+ * @}
+ */
+
+#endif
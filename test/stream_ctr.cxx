@@ -0,0 +1,114 @@
+/** \addtogroup tests
+  * @{
+  * \defgroup stream_ctr stream_ctr
+  * @{
+  * \brief Contractions that do not fit in the memory limit done in slabs (CTF::OUT_OF_CORE)
+  */
+
+#include <ctf.hpp>
+#include <cfloat>
+using namespace CTF;
+
+/**
+ * \brief sets the memory limit so that the tensor memory currently used plus extra bytes are available
+ * \param[in] extra number of bytes to leave available
+ */
+void stream_ctr_limit_mem(int64_t extra){
+  int64_t used = CTF_int::proc_bytes_used();
+  double cap = ((double)(CTF_int::proc_bytes_available()+used))/CTF_int::proc_bytes_total();
+  CTF_int::set_mem_size((int64_t)((used+extra)/cap));
+}
+
+int stream_ctr(int     n,
+               World & dw){
+  int pass = 1;
+  int lens_A[] = {n, n+1, n+2};
+  int lens_C[] = {n, n+1, n+3};
+  Tensor<> A(3, lens_A, dw, Ring<double>(), "A");
+  Matrix<> B(n+2, n+3, dw, "B");
+  Matrix<> M(n+1, n+2, dw, "M");
+  Tensor<> C(3, lens_C, dw, Ring<double>(), "C");
+  Tensor<> R(3, lens_C, dw, Ring<double>(), "R");
+  Matrix<> D(n+1, n+1, dw, "D");
+  Matrix<> E(n+1, n+1, dw, "E");
+  A.fill_random(-1., 1.);
+  B.fill_random(-1., 1.);
+  M.fill_random(-1., 1.);
+  C.fill_random(-1., 1.);
+  R["ijk"] = C["ijk"];
+  R.contract(1., A, "ijl", B, "lk", 2., "ijk");
+  E["ij"] = -A["kil"]*M["jl"];
+
+  int64_t tot = CTF_int::proc_bytes_total();
+  int64_t buf = (int64_t)n*(n+1)*(n+3)*sizeof(double)/(4*dw.np);
+  stream_ctr_limit_mem(buf);
+  CTF::OUT_OF_CORE = 1;
+  // no mapping fits, so the contractions are done in slabs
+  pass &= C.estimate_time(A, "ijl", B, "lk", "ijk") == DBL_MAX;
+  C.contract(1., A, "ijl", B, "lk", 2., "ijk");
+  // sum over the split index
+  D["ij"] = A["kil"]*M["jl"];
+  CTF::OUT_OF_CORE = 0;
+  CTF_int::set_mem_size(tot);
+
+  C["ijk"] -= R["ijk"];
+  pass &= C.norm2() <= 1.E-10*R.norm2();
+  D["ij"] += E["ij"];
+  pass &= D.norm2() <= 1.E-10*E.norm2();
+
+  MPI_Allreduce(MPI_IN_PLACE, &pass, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+  if (dw.rank == 0){
+    if (pass)
+      printf("{ C[\"ijk\"] = 2*C[\"ijk\"] + A[\"ijl\"]*B[\"lk\"] in slabs } passed \n");
+    else
+      printf("{ C[\"ijk\"] = 2*C[\"ijk\"] + A[\"ijl\"]*B[\"lk\"] in slabs } failed \n");
+  }
+  return pass;
+}
+
+
+#ifndef TEST_SUITE
+char* getCmdOption(char ** begin,
+                   char ** end,
+                   const   std::string & option){
+  char ** itr = std::find(begin, end, option);
+  if (itr != end && ++itr != end){
+    return *itr;
+  }
+  return 0;
+}
+
+
+int main(int argc, char ** argv){
+  int rank, np, n, pass;
+  int const in_num = argc;
+  char ** input_str = argv;
+
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &np);
+
+  if (getCmdOption(input_str, input_str+in_num, "-n")){
+    n = atoi(getCmdOption(input_str, input_str+in_num, "-n"));
+    if (n < 0) n = 12;
+  } else n = 12;
+
+  {
+    World dw(argc, argv);
+
+    if (rank == 0){
+      printf("Testing contractions streamed in slabs with n = %d\n", n);
+    }
+    pass = stream_ctr(n, dw);
+    assert(pass);
+  }
+
+  MPI_Finalize();
+  return 0;
+}
+/**
+ * @}
+ * @}
+ */
+
+#endif
@@ -0,0 +1,126 @@
+/** \addtogroup tests
+  * @{
+  * \defgroup svd_rand svd_rand
+  * @{
+  * \brief Randomized truncated SVD of dense and sparse matrices and randomized HoSVD of a tensor
+  */
+
+#include <ctf.hpp>
+using namespace CTF;
+
+template <typename dtype>
+bool svd_rand_check(Matrix<dtype> & A,
+                    int             rank,
+                    World &         dw){
+  Matrix<dtype> U, VT;
+  Vector<dtype> S;
+  A.svd_rand(U, S, VT, rank);
+
+  Matrix<dtype> E(rank, rank, dw);
+  E["ii"] = 1.;
+  E["ij"] -= VT["ik"]*VT["jk"];
+  double nrm_VT = E.norm2();
+
+  Matrix<dtype> D(A.nrow, A.ncol, dw);
+  D["ij"] = A["ij"];
+  D["ij"] -= U["ik"]*S["k"]*VT["kj"];
+  double nrm_A = A.norm2();
+  return D.norm2() <= 1.E-8*nrm_A && nrm_VT <= 1.E-8*rank;
+}
+
+int svd_rand(int     n,
+             World & dw){
+  int m = n*n+1;
+  int r = std::max(2, n/2);
+  srand48(dw.rank*11);
+
+  // dense matrix of rank r
+  Matrix<> X(m, r, dw);
+  Matrix<> Y(r, n, dw);
+  X.fill_random(-1.,1.);
+  Y.fill_random(-1.,1.);
+  Matrix<> A(m, n, dw);
+  A["ij"] = X["ik"]*Y["kj"];
+  bool pass = svd_rand_check<double>(A, r, dw);
+
+  // sparse matrix, all singular triplets
+  Matrix<> As(m, n, SP, dw);
+  As.fill_sp_random(-1., 1., .2);
+  pass = pass & svd_rand_check<double>(As, n, dw);
+
+  // HoSVD of a tensor with multilinear ranks {r, r-1, r}
+  int lens[] = {n+2, n, n+1};
+  int ranks[] = {r, r-1, r};
+  Tensor<> C(3, ranks, dw);
+  C.fill_random(-1.,1.);
+  Matrix<> F0(lens[0], ranks[0], dw);
+  Matrix<> F1(lens[1], ranks[1], dw);
+  Matrix<> F2(lens[2], ranks[2], dw);
+  F0.fill_random(-1.,1.);
+  F1.fill_random(-1.,1.);
+  F2.fill_random(-1.,1.);
+  Tensor<> T(3, lens, dw);
+  T["ijk"] = C["abc"]*F0["ia"]*F1["jb"]*F2["kc"];
+  HoSVD<double> hosvd(T, ranks);
+  Tensor<> T2(3, lens, dw);
+  T2["ijk"] = hosvd["ijk"];
+  T2["ijk"] -= T["ijk"];
+  pass = pass & (T2.norm2() <= 1.E-8*T.norm2());
+
+  int ipass = pass;
+  MPI_Allreduce(MPI_IN_PLACE, &ipass, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+  if (dw.rank == 0){
+    if (ipass)
+      printf("{ A ~= U*S*VT via randomized SVD and T ~= HoSVD(T) } passed\n");
+    else
+      printf("{ A ~= U*S*VT via randomized SVD and T ~= HoSVD(T) } failed\n");
+  }
+  return ipass;
+}
+
+
+#ifndef TEST_SUITE
+char* getCmdOption(char ** begin,
+                   char ** end,
+                   const   std::string & option){
+  char ** itr = std::find(begin, end, option);
+  if (itr != end && ++itr != end){
+    return *itr;
+  }
+  return 0;
+}
+
+
+int main(int argc, char ** argv){
+  int rank, np, n, pass;
+  int const in_num = argc;
+  char ** input_str = argv;
+
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &np);
+
+  if (getCmdOption(input_str, input_str+in_num, "-n")){
+    n = atoi(getCmdOption(input_str, input_str+in_num, "-n"));
+    if (n < 0) n = 8;
+  } else n = 8;
+
+  {
+    World dw(argc, argv);
+
+    if (rank == 0){
+      printf("Testing randomized SVD and HoSVD with n = %d\n", n);
+    }
+    pass = svd_rand(n, dw);
+    assert(pass);
+  }
+
+  MPI_Finalize();
+  return 0;
+}
+/**
+ * @}
+ * @}
+ */
+
+#endif
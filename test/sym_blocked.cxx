@@ -0,0 +1,113 @@
+/** \addtogroup tests
+  * @{
+  * \defgroup sym_blocked sym_blocked
+  * @{
+  * \brief Contractions that break the symmetry of a packed operand, checked against the same contractions of its unpacked copy
+  */
+
+#include <ctf.hpp>
+using namespace CTF;
+
+int sym_blocked(int     n,
+                World & dw){
+  int pass = 1;
+  int syms[] = {SY, AS, SH};
+  int lens[] = {n, n, n+1};
+
+  for (int s=0; s<3; s++){
+    int sym[] = {syms[s], NS, NS};
+    int ns[] = {NS, NS, NS};
+    Matrix<> S(n, n, syms[s], dw);
+    Matrix<> F(n, n, NS, dw);
+    Matrix<> B(n, n+2, NS, dw);
+    S.fill_random(-1.,1.);
+    B.fill_random(-1.,1.);
+    F["ij"] = S["ij"];
+
+    // symmetric left and right operand of a matrix product, with the existing output scaled
+    Matrix<> C(n, n+2, NS, dw), Cf(n, n+2, NS, dw);
+    C.fill_random(-1.,1.);
+    Cf["ij"] = C["ij"];
+    C.contract(2., S, "ik", B, "kj", 3., "ij");
+    Cf.contract(2., F, "ik", B, "kj", 3., "ij");
+    double nrm = Cf.norm2();
+    C["ij"] -= Cf["ij"];
+    if (C.norm2() > 1.E-10*nrm) pass = 0;
+
+    Matrix<> D(n+2, n, NS, dw), Df(n+2, n, NS, dw);
+    D["ij"] = B["ki"]*S["kj"];
+    Df["ij"] = B["ki"]*F["kj"];
+    nrm = Df.norm2();
+    D["ij"] -= Df["ij"];
+    if (D.norm2() > 1.E-10*nrm) pass = 0;
+
+    // order three operand whose symmetric pair is split between the output and a contraction
+    Tensor<> T(3, lens, sym, dw), Tf(3, lens, ns, dw);
+    T.fill_random(-1.,1.);
+    Tf["ijl"] = T["ijl"];
+    Vector<> v(n, dw);
+    v.fill_random(-1.,1.);
+    Matrix<> E(n, n+1, NS, dw), Ef(n, n+1, NS, dw);
+    E["il"] = T["ijl"]*v["j"];
+    Ef["il"] = Tf["ijl"]*v["j"];
+    nrm = Ef.norm2();
+    E["il"] -= Ef["il"];
+    if (E.norm2() > 1.E-10*nrm) pass = 0;
+  }
+
+  MPI_Allreduce(MPI_IN_PLACE, &pass, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+  if (dw.rank == 0){
+    if (pass)
+      printf("{ C[\"ij\"] = A[\"ik\"]*B[\"kj\"] with packed symmetric A or B } passed \n");
+    else
+      printf("{ C[\"ij\"] = A[\"ik\"]*B[\"kj\"] with packed symmetric A or B } failed \n");
+  }
+  return pass;
+}
+
+
+#ifndef TEST_SUITE
+char* getCmdOption(char ** begin,
+                   char ** end,
+                   const   std::string & option){
+  char ** itr = std::find(begin, end, option);
+  if (itr != end && ++itr != end){
+    return *itr;
+  }
+  return 0;
+}
+
+
+int main(int argc, char ** argv){
+  int rank, np, n, pass;
+  int const in_num = argc;
+  char ** input_str = argv;
+
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &np);
+
+  if (getCmdOption(input_str, input_str+in_num, "-n")){
+    n = atoi(getCmdOption(input_str, input_str+in_num, "-n"));
+    if (n < 0) n = 13;
+  } else n = 13;
+
+  {
+    World dw(argc, argv);
+
+    if (rank == 0){
+      printf("Contracting packed symmetric operands without unpacking them with n = %d\n", n);
+    }
+    pass = sym_blocked(n, dw);
+    assert(pass);
+  }
+
+  MPI_Finalize();
+  return 0;
+}
+/**
+ * @}
+ * @}
+ */
+
+#endif
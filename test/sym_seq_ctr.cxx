@@ -0,0 +1,162 @@
+/** \addtogroup tests
+  * @{
+  * \defgroup sym_seq_ctr sym_seq_ctr
+  * @{
+  * \brief Contractions of packed symmetric tensors that cannot be folded into matrix multiplication, checked against unpacked tensors
+  */
+
+#include <ctf.hpp>
+using namespace CTF;
+
+/** \brief returns whether the packed and unpacked results agree once both are unpacked */
+bool sym_seq_ctr_cmp(Tensor<> & S, Tensor<> & N){
+  Tensor<> D(S.order, N.lens, *S.wrld);
+  char idx[S.order+1];
+  for (int i=0; i<S.order; i++) idx[i] = 'a'+i;
+  idx[S.order] = '\0';
+  D[idx] = S[idx];
+  double nrm = N.norm2();
+  D[idx] -= N[idx];
+  return D.norm2() <= 1.E-10*(nrm+1.);
+}
+
+int sym_seq_ctr(int     n,
+                World & dw){
+  int pass = 1;
+
+  int ns[] = {NS, NS, NS, NS};
+  int sy[] = {SY, NS, NS, NS};
+  int sy2[] = {SY, NS, SY, NS};
+  int as[] = {AS, NS, NS, NS};
+  int lens[] = {n, n, n, n};
+
+  // C(ij) symmetric with k contracted
+  {
+    Tensor<> A(3, lens, sy, dw), B(3, lens, sy, dw), C(2, lens, sy, dw);
+    A.fill_random(-1.,1.);
+    B.fill_random(-1.,1.);
+    C.fill_random(-1.,1.);
+    Tensor<> An(3, lens, ns, dw), Bn(3, lens, ns, dw), Cn(2, lens, ns, dw);
+    An["ijk"] = A["ijk"];
+    Bn["ijk"] = B["ijk"];
+    Cn["ij"] = C["ij"];
+    C["ij"] += 2.*A["ijk"]*B["ijk"];
+    Cn["ij"] += 2.*An["ijk"]*Bn["ijk"];
+    pass &= sym_seq_ctr_cmp(C, Cn);
+  }
+
+  // the same with a custom function, which is never folded into matrix multiplication
+  {
+    Tensor<> A(3, lens, sy, dw), B(3, lens, sy, dw), C(2, lens, sy, dw);
+    A.fill_random(-1.,1.);
+    B.fill_random(-1.,1.);
+    C.fill_random(-1.,1.);
+    Tensor<> An(3, lens, ns, dw), Bn(3, lens, ns, dw), Cn(2, lens, ns, dw);
+    An["ijk"] = A["ijk"];
+    Bn["ijk"] = B["ijk"];
+    Cn["ij"] = C["ij"];
+    Function<> f([](double a, double b){ return 2.*a*b; });
+    C["ij"] += f(A["ijk"],B["ijk"]);
+    Cn["ij"] += 2.*An["ijk"]*Bn["ijk"];
+    pass &= sym_seq_ctr_cmp(C, Cn);
+  }
+
+  // C(ijk) symmetric in ij, scaled by a vector along k
+  {
+    Tensor<> A(3, lens, sy, dw), B(1, lens, ns, dw), C(3, lens, sy, dw);
+    A.fill_random(-1.,1.);
+    B.fill_random(-1.,1.);
+    C.fill_random(-1.,1.);
+    Tensor<> An(3, lens, ns, dw), Cn(3, lens, ns, dw);
+    An["ijk"] = A["ijk"];
+    Cn["ijk"] = C["ijk"];
+    C["ijk"] += A["ijk"]*B["k"];
+    Cn["ijk"] += An["ijk"]*B["k"];
+    pass &= sym_seq_ctr_cmp(C, Cn);
+  }
+
+  // weighting of order four tensors with two symmetric pairs
+  {
+    Tensor<> A(4, lens, sy2, dw), B(4, lens, sy2, dw), C(4, lens, sy2, dw);
+    A.fill_random(-1.,1.);
+    B.fill_random(-1.,1.);
+    C.fill_random(-1.,1.);
+    Tensor<> An(4, lens, ns, dw), Bn(4, lens, ns, dw), Cn(4, lens, ns, dw);
+    An["ijkl"] = A["ijkl"];
+    Bn["ijkl"] = B["ijkl"];
+    Cn["ijkl"] = C["ijkl"];
+    C["ijkl"] += .5*A["ijkl"]*B["ijkl"];
+    Cn["ijkl"] += .5*An["ijkl"]*Bn["ijkl"];
+    pass &= sym_seq_ctr_cmp(C, Cn);
+  }
+
+  // antisymmetric output from a symmetric-packed weigh
+  {
+    Tensor<> A(3, lens, as, dw), B(2, lens, ns, dw), C(3, lens, as, dw);
+    A.fill_random(-1.,1.);
+    B.fill_random(-1.,1.);
+    C.fill_random(-1.,1.);
+    Tensor<> An(3, lens, ns, dw), Cn(3, lens, ns, dw);
+    An["ijk"] = A["ijk"];
+    Cn["ijk"] = C["ijk"];
+    C["ijk"] += A["ijk"]*B["kk"];
+    Cn["ijk"] += An["ijk"]*B["kk"];
+    pass &= sym_seq_ctr_cmp(C, Cn);
+  }
+
+  MPI_Allreduce(MPI_IN_PLACE, &pass, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+  if (dw.rank == 0){
+    if (pass)
+      printf("{ C[\"(ij)...\"] += A[\"(ij)...\"]*B[\"...\"] with packed symmetric weigh indices } passed \n");
+    else
+      printf("{ C[\"(ij)...\"] += A[\"(ij)...\"]*B[\"...\"] with packed symmetric weigh indices } failed \n");
+  }
+  return pass;
+}
+
+
+#ifndef TEST_SUITE
+char* getCmdOption(char ** begin,
+                   char ** end,
+                   const   std::string & option){
+  char ** itr = std::find(begin, end, option);
+  if (itr != end && ++itr != end){
+    return *itr;
+  }
+  return 0;
+}
+
+
+int main(int argc, char ** argv){
+  int rank, np, n, pass;
+  int const in_num = argc;
+  char ** input_str = argv;
+
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &np);
+
+  if (getCmdOption(input_str, input_str+in_num, "-n")){
+    n = atoi(getCmdOption(input_str, input_str+in_num, "-n"));
+    if (n < 0) n = 7;
+  } else n = 7;
+
+  {
+    World dw(argc, argv);
+
+    if (rank == 0){
+      printf("Testing contractions of packed symmetric tensors with n = %d\n", n);
+    }
+    pass = sym_seq_ctr(n, dw);
+    assert(pass);
+  }
+
+  MPI_Finalize();
+  return 0;
+}
+/**
+ * @}
+ * @}
+ */
+
+#endif
@@ -19,12 +19,27 @@
 #include "sy_times_ns.cxx"
 #include "speye.cxx"
 #include "sptensor_sum.cxx"
+#include "csf.cxx"
+#include "sparse_redist.cxx"
 #include "endomorphism.cxx"
 #include "endomorphism_cust.cxx"
 #include "endomorphism_cust_sp.cxx"
 #include "univar_function.cxx"
 #include "bivar_function.cxx"
 #include "bivar_transform.cxx"
+#include "overlap_redist.cxx"
+#include "dense_slice.cxx"
+#include "ctr_layers.cxx"
+#include "spmm_skew.cxx"
+#include "sym_seq_ctr.cxx"
+#include "sym_blocked.cxx"
+#include "masked_ctr.cxx"
+#include "spmspv.cxx"
+#include "sort_tsr.cxx"
+#include "ctr_report.cxx"
+#include "tsqr.cxx"
+#include "svd_rand.cxx"
+#include "cpd.cxx"
 
 #include "../examples/trace.cxx"
 #include "../examples/dft_3D.cxx"
@@ -224,9 +239,71 @@ int main(int argc, char ** argv){
     pass.push_back(test_dft_3D(n, dw));
 //#endif
     
+    if (rank == 0)
+      printf("Testing sum of contractions with overlapped redistribution with n = %d:\n",n);
+    pass.push_back(overlap_redist(n,dw));
+    
+    if (rank == 0)
+      printf("Testing dense tensor slicing with n = %d:\n",n);
+    pass.push_back(dense_slice(n,dw));
+
+    if (rank == 0)
+      printf("Testing matrix multiplication with layered mappings with n = %d:\n",n);
+    pass.push_back(ctr_layers(n,dw));
+
+    if (rank == 0)
+      printf("Testing sparse-dense matrix multiplication with power-law row lengths with n = %d:\n",n);
+    pass.push_back(spmm_skew(n,dw));
+
+    if (rank == 0)
+      printf("Testing contractions of packed symmetric tensors with n = %d:\n",n);
+    pass.push_back(sym_seq_ctr(n,dw));
+
+    if (rank == 0)
+      printf("Testing contractions that break the symmetry of packed operands with n = %d:\n",n*n);
+    pass.push_back(sym_blocked(n*n,dw));
+
+    if (rank == 0)
+      printf("Testing masked contractions with n = %d:\n",n);
+    pass.push_back(masked_ctr(n,dw));
+
+    if (rank == 0)
+      printf("Testing sparse matrix times sparse vector with n = %d:\n",n*n);
+    pass.push_back(spmspv(n*n,dw));
+
+    if (rank == 0)
+      printf("Testing distributed sort of tensor values with n = %d:\n",n);
+    pass.push_back(sort_tsr(n,dw));
+
+    if (rank == 0)
+      printf("Testing contraction reports with n = %d:\n",n);
+    pass.push_back(ctr_report(n,dw));
+    
+#ifdef USE_LAPACK
+    if (rank == 0)
+      printf("Testing TSQR and Cholesky-QR2 with m = %d n = %d:\n",n*n+3,n);
+    pass.push_back(tsqr(n*n+3,n,dw));
+
+    if (rank == 0)
+      printf("Testing randomized SVD and HoSVD with n = %d:\n",n);
+    pass.push_back(svd_rand(n,dw));
+
+    if (rank == 0)
+      printf("Testing MTTKRP and CP-ALS with n = %d:\n",n);
+    pass.push_back(cpd(n,dw));
+#endif
+    
     if (rank == 0)
       printf("Testing sparse summation with n = %d:\n",n);
     pass.push_back(sptensor_sum(n,dw));
+
+    if (rank == 0)
+      printf("Testing contractions of higher-order sparse tensors in CSF layout with n = %d:\n",n);
+    pass.push_back(csf(n,dw));
+
+    if (rank == 0)
+      printf("Testing redistribution of sparse tensors with n = %d:\n",n);
+    pass.push_back(sparse_redist(n,dw));
     
     if (rank == 0)
       printf("Testing sparse identity with n = %d order = %d:\n",n,11);
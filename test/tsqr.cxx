@@ -0,0 +1,135 @@
+/** \addtogroup tests
+  * @{
+  * \defgroup tsqr tsqr
+  * @{
+  * \brief QR factorization of tall-skinny matrices via TSQR and Cholesky-QR2
+  */
+
+#include <ctf.hpp>
+using namespace CTF;
+
+template <typename dtype>
+dtype tsqr_conj(dtype a){ return a; }
+
+template <>
+std::complex<double> tsqr_conj< std::complex<double> >(std::complex<double> a){ return std::conj(a); }
+
+template <typename dtype>
+bool tsqr_check(Matrix<dtype> A,
+                QR_ALG        alg,
+                World &       dw){
+  int m = A.nrow;
+  int n = A.ncol;
+  Matrix<dtype> Q, R;
+  A.qr(Q, R, alg);
+
+  Matrix<dtype> cQ(Q);
+  cQ["ij"] = Function<dtype>([](dtype a){ return tsqr_conj<dtype>(a); })(Q["ij"]);
+
+  Matrix<dtype> E(n, n, dw);
+  E["ii"] = 1.;
+  E["ij"] -= cQ["ki"]*Q["kj"];
+  double nrm;
+  E.norm2(nrm);
+  bool pass = nrm < n*1.E-10;
+
+  // R must be upper-triangular
+  dtype * dR = (dtype*)malloc(sizeof(dtype)*n*n);
+  R.read_all(dR);
+  for (int j=0; j<n; j++){
+    for (int i=j+1; i<n; i++){
+      if (dR[i+j*n] != (dtype)0) pass = false;
+    }
+  }
+  free(dR);
+
+  A["ij"] -= Q["ik"]*R["kj"];
+  A.norm2(nrm);
+  pass = pass && nrm < m*n*1.E-10;
+  return pass;
+}
+
+int tsqr(int     m,
+         int     n,
+         World & dw){
+  Matrix<> A(m, n, dw);
+  srand48(dw.rank*7);
+  A.fill_random(0.,1.);
+  Matrix<> AA(m, n, dw);
+  AA.fill_random(0.,1.);
+  Matrix< std::complex<double> > cA(m, n, dw);
+  cA["ij"] = Function<double,double,std::complex<double>>([](double a, double b){ return std::complex<double>(a,b); })(A["ij"],AA["ij"]);
+
+  bool pass = true;
+  pass = pass & tsqr_check<double>(A, QR_TSQR, dw);
+  pass = pass & tsqr_check<double>(A, QR_CHOLQR2, dw);
+  pass = pass & tsqr_check< std::complex<double> >(cA, QR_TSQR, dw);
+  pass = pass & tsqr_check< std::complex<double> >(cA, QR_CHOLQR2, dw);
+
+  // columns differ only by a small perturbation, so the first Cholesky-QR pass breaks down and falls back to TSQR
+  Matrix<> B(m, n, dw);
+  B["ij"] = A["i0"] + 1.E-9*A["ij"];
+  pass = pass & tsqr_check<double>(B, QR_CHOLQR2, dw);
+
+  int ipass = pass;
+  MPI_Allreduce(MPI_IN_PLACE, &ipass, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+  if (dw.rank == 0){
+    if (ipass)
+      printf("{ A = QR and Q^HQ = I via TSQR and Cholesky-QR2 } passed\n");
+    else
+      printf("{ A = QR and Q^HQ = I via TSQR and Cholesky-QR2 } failed\n");
+  }
+  return ipass;
+}
+
+
+#ifndef TEST_SUITE
+char* getCmdOption(char ** begin,
+                   char ** end,
+                   const   std::string & option){
+  char ** itr = std::find(begin, end, option);
+  if (itr != end && ++itr != end){
+    return *itr;
+  }
+  return 0;
+}
+
+
+int main(int argc, char ** argv){
+  int rank, np, m, n, pass;
+  int const in_num = argc;
+  char ** input_str = argv;
+
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &np);
+
+  if (getCmdOption(input_str, input_str+in_num, "-m")){
+    m = atoi(getCmdOption(input_str, input_str+in_num, "-m"));
+    if (m < 0) m = 103;
+  } else m = 103;
+
+  if (getCmdOption(input_str, input_str+in_num, "-n")){
+    n = atoi(getCmdOption(input_str, input_str+in_num, "-n"));
+    if (n < 0) n = 7;
+  } else n = 7;
+
+  {
+    World dw(argc, argv);
+
+    if (rank == 0){
+      printf("Testing %d-by-%d QR factorization via TSQR and Cholesky-QR2\n", m, n);
+    }
+    pass = tsqr(m, n, dw);
+    assert(pass);
+  }
+
+  MPI_Finalize();
+  return 0;
+}
+/**
+ * @}
+ * @}
+ */
+
+#endif